@@ -163,6 +163,9 @@
 # :command:`configure_file()` on them yourself, but they can be used as starting
 # point to create more sophisticted custom ``ConfigVersion.cmake`` files.
 #
+# :command:`find_package` recognizes unmodified version files created by
+# this version of CMake and evaluates them without running their code.
+#
 # Example Generating Package Files
 # ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
 #
@@ -485,6 +485,7 @@ if(NOT CPACK_GENERATOR)
       option(CPACK_BINARY_TBZ2 "Enable to build TBZ2 packages"    OFF)
       option(CPACK_BINARY_TGZ  "Enable to build TGZ packages"     ON)
       option(CPACK_BINARY_TXZ  "Enable to build TXZ packages"     OFF)
+      option(CPACK_BINARY_TZST "Enable to build TZST packages"    OFF)
     endif()
   else()
     option(CPACK_BINARY_7Z   "Enable to build 7-Zip packages" OFF)
@@ -511,6 +512,7 @@ if(NOT CPACK_GENERATOR)
   cpack_optional_append(CPACK_GENERATOR  CPACK_BINARY_TGZ          TGZ)
   cpack_optional_append(CPACK_GENERATOR  CPACK_BINARY_TXZ          TXZ)
   cpack_optional_append(CPACK_GENERATOR  CPACK_BINARY_TZ           TZ)
+  cpack_optional_append(CPACK_GENERATOR  CPACK_BINARY_TZST         TZST)
   cpack_optional_append(CPACK_GENERATOR  CPACK_BINARY_WIX          WIX)
   cpack_optional_append(CPACK_GENERATOR  CPACK_BINARY_ZIP          ZIP)
 
@@ -527,6 +529,7 @@ if(NOT CPACK_SOURCE_GENERATOR)
       option(CPACK_SOURCE_TGZ  "Enable to build TGZ source packages"  ON)
       option(CPACK_SOURCE_TXZ  "Enable to build TXZ source packages"  ON)
       option(CPACK_SOURCE_TZ   "Enable to build TZ source packages"   ON)
+      option(CPACK_SOURCE_TZST "Enable to build TZST source packages" OFF)
       option(CPACK_SOURCE_ZIP  "Enable to build ZIP source packages"  OFF)
     endif()
   else()
@@ -541,6 +544,7 @@ if(NOT CPACK_SOURCE_GENERATOR)
   cpack_optional_append(CPACK_SOURCE_GENERATOR  CPACK_SOURCE_TGZ     TGZ)
   cpack_optional_append(CPACK_SOURCE_GENERATOR  CPACK_SOURCE_TXZ     TXZ)
   cpack_optional_append(CPACK_SOURCE_GENERATOR  CPACK_SOURCE_TZ      TZ)
+  cpack_optional_append(CPACK_SOURCE_GENERATOR  CPACK_SOURCE_TZST    TZST)
   cpack_optional_append(CPACK_SOURCE_GENERATOR  CPACK_SOURCE_ZIP     ZIP)
 endif()
 
@@ -563,6 +567,7 @@ mark_as_advanced(
   CPACK_BINARY_TGZ
   CPACK_BINARY_TXZ
   CPACK_BINARY_TZ
+  CPACK_BINARY_TZST
   CPACK_BINARY_WIX
   CPACK_BINARY_ZIP
   CPACK_SOURCE_7Z
@@ -572,6 +577,7 @@ mark_as_advanced(
   CPACK_SOURCE_TGZ
   CPACK_SOURCE_TXZ
   CPACK_SOURCE_TZ
+  CPACK_SOURCE_TZST
   CPACK_SOURCE_ZIP
   )
 
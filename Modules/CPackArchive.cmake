@@ -13,6 +13,7 @@
 #   - TGZ (.tar.gz)
 #   - TXZ (.tar.xz)
 #   - TZ (.tar.Z)
+#   - TZST (.tar.zst)
 #   - ZIP (.zip)
 #
 # Variables specific to CPack Archive generator
@@ -37,3 +38,22 @@
 #
 #  If enabled (ON) multiple packages are generated. By default a single package
 #  containing files of all components is generated.
+#
+# .. variable:: CPACK_ARCHIVE_THREADS
+#
+#  Number of threads to compress TGZ, TXZ and TZST packages with, or 0 to
+#  use one thread per processor.  When it is set, TGZ and TXZ packages
+#  are compressed in independent blocks and become slightly larger, but
+#  are the same for any number of threads.
+#
+#  * Mandatory : NO
+#  * Default   : unset, which compresses on one thread as a single block
+#
+# .. variable:: CPACK_ARCHIVE_COMPRESSION_LEVEL
+#
+#  Zstandard compression level of TZST packages.  Levels range from 1
+#  (fastest) to 22 (smallest) and negative levels are faster still.
+#  Levels above 19 need much more memory to compress and decompress.
+#
+#  * Mandatory : NO
+#  * Default   : 0, which selects the default level 3
@@ -0,0 +1,133 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+#[=======================================================================[.rst:
+CheckBatch
+----------
+
+Build the checks of several ``Check*`` modules together.
+
+.. command:: check_batch_begin
+
+  ::
+
+    check_batch_begin()
+
+  Start deferring checks with :command:`try_compile_batch`.
+
+.. command:: check_batch_end
+
+  ::
+
+    check_batch_end()
+
+  Build all checks deferred since ``check_batch_begin()`` at once, then
+  set and report their results as the individual checks would have.
+
+Checks of the following modules are deferred, as are checks of modules
+built on them such as :module:`CheckCCompilerFlag`:
+
+* :module:`CheckIncludeFile`
+* :module:`CheckIncludeFileCXX`
+* :module:`CheckSymbolExists`
+* :module:`CheckCXXSymbolExists`
+* :module:`CheckCSourceCompiles`
+* :module:`CheckCXXSourceCompiles`
+
+Every deferred check still prints its ``Looking for ...`` or
+``Performing Test ...`` message when it is called, but its result variable
+is set only by ``check_batch_end()``.  A check that depends on the result
+of another check must therefore not be part of the same batch.  Checks
+that already have a cached result are not run again, as usual.
+
+Both commands must be called from the same directory and variable scope.
+
+Example:
+
+.. code-block:: cmake
+
+  include(CheckBatch)
+  include(CheckIncludeFile)
+  include(CheckCCompilerFlag)
+
+  check_batch_begin()
+  check_include_file(unistd.h HAVE_UNISTD_H)
+  check_include_file(sys/mman.h HAVE_SYS_MMAN_H)
+  check_c_compiler_flag(-Wall HAVE_WALL)
+  check_batch_end()
+#]=======================================================================]
+
+include_guard(GLOBAL)
+
+macro(CHECK_BATCH_BEGIN)
+  try_compile_batch(BEGIN)
+endmacro()
+
+macro(CHECK_BATCH_END)
+  try_compile_batch(END)
+  get_property(_CHECK_BATCH_VARS GLOBAL PROPERTY _CHECK_BATCH_VARS)
+  set_property(GLOBAL PROPERTY _CHECK_BATCH_VARS "")
+  foreach(_CHECK_BATCH_VAR IN LISTS _CHECK_BATCH_VARS)
+    _check_batch_report(${_CHECK_BATCH_VAR})
+  endforeach()
+  unset(_CHECK_BATCH_VAR)
+  unset(_CHECK_BATCH_VARS)
+endmacro()
+
+# Record how to report the result of a check deferred by try_compile_batch.
+# The check must pass "OUTPUT_VARIABLE _CHECK_BATCH_OUTPUT_<var>" to its
+# try_compile call.  The options match what the check modules report:
+#
+#   MESSAGE    status message without the result (CMAKE_REQUIRED_QUIET
+#              is honored)
+#   PASS/FAIL  words appended to MESSAGE for either result
+#   DOC        documentation of the result cache entry
+#   LOG_PASS   text preceding the output in CMakeOutput.log
+#   LOG_FAIL   text preceding the output in CMakeError.log
+#   LOG_SUFFIX text following the output in either log
+#   FAIL_REGEX regular expressions that make the check fail on a match
+function(_CHECK_BATCH_DEFER _var)
+  set(_fields MESSAGE PASS FAIL DOC LOG_PASS LOG_FAIL LOG_SUFFIX)
+  cmake_parse_arguments(PARSE_ARGV 1 _CBD "" "${_fields}" "FAIL_REGEX")
+  if(CMAKE_REQUIRED_QUIET)
+    set(_CBD_MESSAGE "")
+  endif()
+  foreach(_field ${_fields} FAIL_REGEX)
+    set_property(GLOBAL PROPERTY _CHECK_BATCH_${_field}_${_var}
+      "${_CBD_${_field}}")
+  endforeach()
+  set_property(GLOBAL APPEND PROPERTY _CHECK_BATCH_VARS ${_var})
+endfunction()
+
+function(_CHECK_BATCH_REPORT _var)
+  foreach(_field MESSAGE PASS FAIL DOC LOG_PASS LOG_FAIL LOG_SUFFIX
+                 FAIL_REGEX)
+    get_property(_${_field} GLOBAL PROPERTY _CHECK_BATCH_${_field}_${_var})
+    set_property(GLOBAL PROPERTY _CHECK_BATCH_${_field}_${_var})
+  endforeach()
+  set(_output "${_CHECK_BATCH_OUTPUT_${_var}}")
+  unset(_CHECK_BATCH_OUTPUT_${_var} PARENT_SCOPE)
+
+  set(_result "${${_var}}")
+  foreach(_regex ${_FAIL_REGEX})
+    if("${_output}" MATCHES "${_regex}")
+      set(_result 0)
+    endif()
+  endforeach()
+
+  if(_result)
+    if(NOT _MESSAGE STREQUAL "")
+      message(STATUS "${_MESSAGE} - ${_PASS}")
+    endif()
+    set(${_var} 1 CACHE INTERNAL "${_DOC}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "${_LOG_PASS}${_output}${_LOG_SUFFIX}")
+  else()
+    if(NOT _MESSAGE STREQUAL "")
+      message(STATUS "${_MESSAGE} - ${_FAIL}")
+    endif()
+    set(${_var} "" CACHE INTERNAL "${_DOC}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "${_LOG_FAIL}${_output}${_LOG_SUFFIX}")
+  endif()
+endfunction()
@@ -96,6 +96,11 @@ macro(CHECK_CXX_SOURCE_COMPILES SOURCE VAR)
     if(NOT CMAKE_REQUIRED_QUIET)
       message(STATUS "Performing Test ${VAR}")
     endif()
+    if(CMAKE_TRY_COMPILE_BATCH)
+      set(_CSC_OUTPUT _CHECK_BATCH_OUTPUT_${VAR})
+    else()
+      set(_CSC_OUTPUT OUTPUT)
+    endif()
     try_compile(${VAR}
       ${CMAKE_BINARY_DIR}
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/src.cxx
@@ -103,32 +108,44 @@ macro(CHECK_CXX_SOURCE_COMPILES SOURCE VAR)
       ${CHECK_CXX_SOURCE_COMPILES_ADD_LIBRARIES}
       CMAKE_FLAGS -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_FUNCTION_DEFINITIONS}
       "${CHECK_CXX_SOURCE_COMPILES_ADD_INCLUDES}"
-      OUTPUT_VARIABLE OUTPUT)
-
-    foreach(_regex ${_FAIL_REGEX})
-      if("${OUTPUT}" MATCHES "${_regex}")
-        set(${VAR} 0)
-      endif()
-    endforeach()
-
-    if(${VAR})
-      set(${VAR} 1 CACHE INTERNAL "Test ${VAR}")
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(STATUS "Performing Test ${VAR} - Success")
-      endif()
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Performing C++ SOURCE FILE Test ${VAR} succeeded with the following output:\n"
-        "${OUTPUT}\n"
-        "Source file was:\n${SOURCE}\n")
+      OUTPUT_VARIABLE ${_CSC_OUTPUT})
+
+    if(CMAKE_TRY_COMPILE_BATCH AND NOT DEFINED ${VAR})
+      # Deferred by check_batch_begin(), reported by check_batch_end().
+      include(CheckBatch)
+      _check_batch_defer(${VAR}
+        MESSAGE "Performing Test ${VAR}" PASS "Success" FAIL "Failed"
+        DOC "Test ${VAR}"
+        LOG_PASS "Performing C++ SOURCE FILE Test ${VAR} succeeded with the following output:\n"
+        LOG_FAIL "Performing C++ SOURCE FILE Test ${VAR} failed with the following output:\n"
+        LOG_SUFFIX "\nSource file was:\n${SOURCE}\n"
+        FAIL_REGEX ${_FAIL_REGEX})
     else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(STATUS "Performing Test ${VAR} - Failed")
+      foreach(_regex ${_FAIL_REGEX})
+        if("${${_CSC_OUTPUT}}" MATCHES "${_regex}")
+          set(${VAR} 0)
+        endif()
+      endforeach()
+
+      if(${VAR})
+        set(${VAR} 1 CACHE INTERNAL "Test ${VAR}")
+        if(NOT CMAKE_REQUIRED_QUIET)
+          message(STATUS "Performing Test ${VAR} - Success")
+        endif()
+        file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+          "Performing C++ SOURCE FILE Test ${VAR} succeeded with the following output:\n"
+          "${${_CSC_OUTPUT}}\n"
+          "Source file was:\n${SOURCE}\n")
+      else()
+        if(NOT CMAKE_REQUIRED_QUIET)
+          message(STATUS "Performing Test ${VAR} - Failed")
+        endif()
+        set(${VAR} "" CACHE INTERNAL "Test ${VAR}")
+        file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+          "Performing C++ SOURCE FILE Test ${VAR} failed with the following output:\n"
+          "${${_CSC_OUTPUT}}\n"
+          "Source file was:\n${SOURCE}\n")
       endif()
-      set(${VAR} "" CACHE INTERNAL "Test ${VAR}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Performing C++ SOURCE FILE Test ${VAR} failed with the following output:\n"
-        "${OUTPUT}\n"
-        "Source file was:\n${SOURCE}\n")
     endif()
   endif()
 endmacro()
@@ -55,6 +55,11 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       string(APPEND CMAKE_C_FLAGS " ${ARGV2}")
     endif()
 
+    if(CMAKE_TRY_COMPILE_BATCH)
+      set(_CIF_OUTPUT _CHECK_BATCH_OUTPUT_${VARIABLE})
+    else()
+      set(_CIF_OUTPUT OUTPUT)
+    endif()
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/CheckIncludeFile.c
@@ -62,13 +67,22 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       CMAKE_FLAGS
       -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_INCLUDE_FILE_FLAGS}
       "${CHECK_INCLUDE_FILE_C_INCLUDE_DIRS}"
-      OUTPUT_VARIABLE OUTPUT)
+      OUTPUT_VARIABLE ${_CIF_OUTPUT})
 
     if(${ARGC} EQUAL 3)
       set(CMAKE_C_FLAGS ${CMAKE_C_FLAGS_SAVE})
     endif()
 
-    if(${VARIABLE})
+    if(CMAKE_TRY_COMPILE_BATCH AND NOT DEFINED ${VARIABLE})
+      # Deferred by check_batch_begin(), reported by check_batch_end().
+      include(CheckBatch)
+      _check_batch_defer(${VARIABLE}
+        MESSAGE "Looking for ${INCLUDE}" PASS "found" FAIL "not found"
+        DOC "Have include ${INCLUDE}"
+        LOG_PASS "Determining if the include file ${INCLUDE} exists passed with the following output:\n"
+        LOG_FAIL "Determining if the include file ${INCLUDE} exists failed with the following output:\n"
+        LOG_SUFFIX "\n\n")
+    elseif(${VARIABLE})
       if(NOT CMAKE_REQUIRED_QUIET)
         message(STATUS "Looking for ${INCLUDE} - found")
       endif()
@@ -76,7 +90,7 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
         "Determining if the include file ${INCLUDE} "
         "exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
+        "${${_CIF_OUTPUT}}\n\n")
     else()
       if(NOT CMAKE_REQUIRED_QUIET)
         message(STATUS "Looking for ${INCLUDE} - not found")
@@ -85,7 +99,7 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
         "Determining if the include file ${INCLUDE} "
         "exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
+        "${${_CIF_OUTPUT}}\n\n")
     endif()
   endif()
 endmacro()
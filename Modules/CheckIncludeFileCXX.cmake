@@ -54,6 +54,11 @@ macro(CHECK_INCLUDE_FILE_CXX INCLUDE VARIABLE)
       string(APPEND CMAKE_CXX_FLAGS " ${ARGV2}")
     endif()
 
+    if(CMAKE_TRY_COMPILE_BATCH)
+      set(_CIF_OUTPUT _CHECK_BATCH_OUTPUT_${VARIABLE})
+    else()
+      set(_CIF_OUTPUT OUTPUT)
+    endif()
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/CheckIncludeFile.cxx
@@ -61,13 +66,22 @@ macro(CHECK_INCLUDE_FILE_CXX INCLUDE VARIABLE)
       CMAKE_FLAGS
       -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_INCLUDE_FILE_FLAGS}
       "${CHECK_INCLUDE_FILE_CXX_INCLUDE_DIRS}"
-      OUTPUT_VARIABLE OUTPUT)
+      OUTPUT_VARIABLE ${_CIF_OUTPUT})
 
     if(${ARGC} EQUAL 3)
       set(CMAKE_CXX_FLAGS ${CMAKE_CXX_FLAGS_SAVE})
     endif()
 
-    if(${VARIABLE})
+    if(CMAKE_TRY_COMPILE_BATCH AND NOT DEFINED ${VARIABLE})
+      # Deferred by check_batch_begin(), reported by check_batch_end().
+      include(CheckBatch)
+      _check_batch_defer(${VARIABLE}
+        MESSAGE "Looking for C++ include ${INCLUDE}" PASS "found" FAIL "not found"
+        DOC "Have include ${INCLUDE}"
+        LOG_PASS "Determining if the include file ${INCLUDE} exists passed with the following output:\n"
+        LOG_FAIL "Determining if the include file ${INCLUDE} exists failed with the following output:\n"
+        LOG_SUFFIX "\n\n")
+    elseif(${VARIABLE})
       if(NOT CMAKE_REQUIRED_QUIET)
         message(STATUS "Looking for C++ include ${INCLUDE} - found")
       endif()
@@ -75,7 +89,7 @@ macro(CHECK_INCLUDE_FILE_CXX INCLUDE VARIABLE)
       file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
         "Determining if the include file ${INCLUDE} "
         "exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
+        "${${_CIF_OUTPUT}}\n\n")
     else()
       if(NOT CMAKE_REQUIRED_QUIET)
         message(STATUS "Looking for C++ include ${INCLUDE} - not found")
@@ -84,7 +98,7 @@ macro(CHECK_INCLUDE_FILE_CXX INCLUDE VARIABLE)
       file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
         "Determining if the include file ${INCLUDE} "
         "exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
+        "${${_CIF_OUTPUT}}\n\n")
     endif()
   endif()
 endmacro()
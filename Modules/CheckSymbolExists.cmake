@@ -84,6 +84,11 @@ macro(__CHECK_SYMBOL_EXISTS_IMPL SOURCEFILE SYMBOL FILES VARIABLE)
     if(NOT CMAKE_REQUIRED_QUIET)
       message(STATUS "Looking for ${SYMBOL}")
     endif()
+    if(CMAKE_TRY_COMPILE_BATCH)
+      set(_CSE_OUTPUT _CHECK_BATCH_OUTPUT_${VARIABLE})
+    else()
+      set(_CSE_OUTPUT OUTPUT)
+    endif()
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       "${SOURCEFILE}"
@@ -92,8 +97,17 @@ macro(__CHECK_SYMBOL_EXISTS_IMPL SOURCEFILE SYMBOL FILES VARIABLE)
       CMAKE_FLAGS
       -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_SYMBOL_EXISTS_FLAGS}
       "${CMAKE_SYMBOL_EXISTS_INCLUDES}"
-      OUTPUT_VARIABLE OUTPUT)
-    if(${VARIABLE})
+      OUTPUT_VARIABLE ${_CSE_OUTPUT})
+    if(CMAKE_TRY_COMPILE_BATCH AND NOT DEFINED ${VARIABLE})
+      # Deferred by check_batch_begin(), reported by check_batch_end().
+      include(CheckBatch)
+      _check_batch_defer(${VARIABLE}
+        MESSAGE "Looking for ${SYMBOL}" PASS "found" FAIL "not found"
+        DOC "Have symbol ${SYMBOL}"
+        LOG_PASS "Determining if the ${SYMBOL} exist passed with the following output:\n"
+        LOG_FAIL "Determining if the ${SYMBOL} exist failed with the following output:\n"
+        LOG_SUFFIX "\nFile ${SOURCEFILE}:\n${CMAKE_CONFIGURABLE_FILE_CONTENT}\n")
+    elseif(${VARIABLE})
       if(NOT CMAKE_REQUIRED_QUIET)
         message(STATUS "Looking for ${SYMBOL} - found")
       endif()
@@ -101,7 +115,7 @@ macro(__CHECK_SYMBOL_EXISTS_IMPL SOURCEFILE SYMBOL FILES VARIABLE)
       file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
         "Determining if the ${SYMBOL} "
         "exist passed with the following output:\n"
-        "${OUTPUT}\nFile ${SOURCEFILE}:\n"
+        "${${_CSE_OUTPUT}}\nFile ${SOURCEFILE}:\n"
         "${CMAKE_CONFIGURABLE_FILE_CONTENT}\n")
     else()
       if(NOT CMAKE_REQUIRED_QUIET)
@@ -111,7 +125,7 @@ macro(__CHECK_SYMBOL_EXISTS_IMPL SOURCEFILE SYMBOL FILES VARIABLE)
       file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
         "Determining if the ${SYMBOL} "
         "exist failed with the following output:\n"
-        "${OUTPUT}\nFile ${SOURCEFILE}:\n"
+        "${${_CSE_OUTPUT}}\nFile ${SOURCEFILE}:\n"
         "${CMAKE_CONFIGURABLE_FILE_CONTENT}\n")
     endif()
   endif()
@@ -86,6 +86,24 @@ int cmCPackArchiveGenerator::addOneComponentToArchive(
   return 1;
 }
 
+int cmCPackArchiveGenerator::GetCompressionOption(const std::string& name,
+                                                  int defaultValue,
+                                                  int minValue) const
+{
+  const char* value = this->GetOption(name);
+  if (!value || !*value) {
+    return defaultValue;
+  }
+  long n;
+  if (!cmSystemTools::StringToLong(value, &n) || n < minValue ||
+      n > 1024) {
+    cmCPackLogger(cmCPackLog::LOG_WARNING, "Ignoring invalid value of "
+                    << name << ": " << value << std::endl);
+    return defaultValue;
+  }
+  return static_cast<int>(n);
+}
+
 /*
  * The macro will open/create a file 'filename'
  * an declare and open the associated
@@ -100,7 +118,10 @@ int cmCPackArchiveGenerator::addOneComponentToArchive(
                     << (filename) << ">." << std::endl);                      \
     return 0;                                                                 \
   }                                                                           \
-  cmArchiveWrite archive(gf, this->Compress, this->ArchiveFormat);            \
+  cmArchiveWrite archive(                                                     \
+    gf, this->Compress, this->ArchiveFormat,                                  \
+    this->GetCompressionOption("CPACK_ARCHIVE_THREADS", -1, 0),               \
+    this->GetCompressionOption("CPACK_ARCHIVE_COMPRESSION_LEVEL", 0, -1024)); \
   if (!(archive)) {                                                           \
     cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem to create archive < "       \
                     << (filename) << ">. ERROR =" << (archive).GetError()     \
@@ -39,6 +39,10 @@ private:
   std::string GetArchiveComponentFileName(const std::string& component,
                                           bool isGroupName);
 
+  // get an integer option for compressing the archive
+  int GetCompressionOption(const std::string& name, int defaultValue,
+                           int minValue) const;
+
 protected:
   int InitializeInternal() override;
   /**
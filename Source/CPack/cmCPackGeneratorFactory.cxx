@@ -18,6 +18,7 @@
 #include "cmCPackSTGZGenerator.h"
 #include "cmCPackTGZGenerator.h"
 #include "cmCPackTXZGenerator.h"
+#include "cmCPackTZSTGenerator.h"
 #include "cmCPackTarBZip2Generator.h"
 #include "cmCPackTarCompressGenerator.h"
 #include "cmCPackZIPGenerator.h"
@@ -54,6 +55,10 @@ cmCPackGeneratorFactory::cmCPackGeneratorFactory()
     this->RegisterGenerator("TXZ", "Tar XZ compression",
                             cmCPackTXZGenerator::CreateGenerator);
   }
+  if (cmCPackTZSTGenerator::CanGenerate()) {
+    this->RegisterGenerator("TZST", "Tar Zstandard compression",
+                            cmCPackTZSTGenerator::CreateGenerator);
+  }
   if (cmCPackSTGZGenerator::CanGenerate()) {
     this->RegisterGenerator("STGZ", "Self extracting Tar GZip compression",
                             cmCPackSTGZGenerator::CreateGenerator);
@@ -0,0 +1,15 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmCPackTZSTGenerator.h"
+
+#include "cmArchiveWrite.h"
+#include "cmCPackArchiveGenerator.h"
+
+cmCPackTZSTGenerator::cmCPackTZSTGenerator()
+  : cmCPackArchiveGenerator(cmArchiveWrite::CompressZstd, "paxr")
+{
+}
+
+cmCPackTZSTGenerator::~cmCPackTZSTGenerator()
+{
+}
@@ -13,6 +13,7 @@
 #include "cmParseJacocoCoverage.h"
 #include "cmParsePHPCoverage.h"
 #include "cmSystemTools.h"
+#include "cmUVProcessPool.h"
 #include "cmWorkingDirectory.h"
 #include "cmXMLWriter.h"
 #include "cmake.h"
@@ -999,33 +1000,52 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   basecovargs.insert(basecovargs.begin(), gcovCommand);
   basecovargs.push_back("-o");
 
+  // Run gcov on as many data files at once as the parallel level allows.
+  // Each run writes its *.gcov files to a directory of its own so that
+  // concurrent runs do not overwrite each other's output for sources they
+  // share, such as headers.  The directory is removed once its output has
+  // been merged.  Runs are processed in the order of the data files so the
+  // results do not depend on process scheduling.
+  size_t const jobs =
+    static_cast<size_t>(std::max(this->CTest->GetParallelLevel(), 1));
+  size_t const window = jobs > 1 ? 2 * jobs : 1;
+
+  auto setupGCov = [&](size_t i, cmUVProcessPool::Process& process) {
+    // Call gcov to get coverage data for this *.gcda file:
+    //
+    std::string const& f = files[i];
+    process.Arguments = basecovargs;
+    process.Arguments.push_back(cmSystemTools::GetFilenamePath(f));
+    process.Arguments.push_back(f);
+    if (window == 1) {
+      process.WorkingDirectory = tempDir;
+    } else {
+      process.WorkingDirectory = tempDir + "/gcov-" + std::to_string(i);
+      cmSystemTools::MakeDirectory(process.WorkingDirectory);
+    }
+  };
+
   // files is a list of *.da and *.gcda files with coverage data in them.
   // These are binary files that you give as input to gcov so that it will
   // give us text output we can analyze to summarize coverage.
   //
-  for (std::string const& f : files) {
+  auto mergeGCov = [&](size_t i, cmUVProcessPool::Process const& process) {
+    std::string const& f = files[i];
     cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
                        this->Quiet);
 
-    // Call gcov to get coverage data for this *.gcda file:
-    //
     std::string fileDir = cmSystemTools::GetFilenamePath(f);
-    std::vector<std::string> covargs = basecovargs;
-    covargs.push_back(fileDir);
-    covargs.push_back(f);
-    const std::string command = joinCommandLine(covargs);
+    const std::string command = joinCommandLine(process.Arguments);
 
     cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                        command << std::endl, this->Quiet);
 
-    std::string output;
-    std::string errors;
-    int retVal = 0;
+    std::string const& output = process.Output;
+    std::string const& errors = process.Errors;
+    int retVal = process.ExitValue;
     *cont->OFS << "* Run coverage for: " << fileDir << std::endl;
     *cont->OFS << "  Command: " << command << std::endl;
-    int res = this->CTest->RunCommand(covargs, &output, &errors, &retVal,
-                                      tempDir.c_str(),
-                                      cmDuration::zero() /*this->TimeOut*/);
+    bool res = process.Started && process.Signal == 0;
 
     *cont->OFS << "  Output: " << output << std::endl;
     *cont->OFS << "  Errors: " << errors << std::endl;
@@ -1035,7 +1055,7 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
       cmCTestLog(this->CTest, ERROR_MESSAGE,
                  "Command produced error: " << errors << std::endl);
       cont->Error++;
-      continue;
+      return;
     }
     if (retVal != 0) {
       cmCTestLog(this->CTest, ERROR_MESSAGE, "Coverage command returned: "
@@ -1193,7 +1213,9 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
                            "   in gcovFile: " << gcovFile << std::endl,
                            this->Quiet);
 
-        cmsys::ifstream ifile(gcovFile.c_str());
+        cmsys::ifstream ifile(
+          cmSystemTools::CollapseFullPath(gcovFile, process.WorkingDirectory)
+            .c_str());
         if (!ifile) {
           cmCTestLog(this->CTest, ERROR_MESSAGE,
                      "Cannot open file: " << gcovFile << std::endl);
@@ -1303,7 +1325,17 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
                          this->Quiet);
       cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
     }
-  }
+  };
+
+  auto processGCov = [&](size_t i, cmUVProcessPool::Process const& process) {
+    mergeGCov(i, process);
+    if (window > 1) {
+      cmSystemTools::RemoveADirectory(process.WorkingDirectory);
+    }
+  };
+
+  cmUVProcessPool pool(jobs, window);
+  pool.Run(files.size(), setupGCov, processGCov);
 
   return file_count;
 }
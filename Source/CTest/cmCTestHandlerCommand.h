@@ -36,6 +36,8 @@ public:
   bool InitialPass(std::vector<std::string> const& args,
                    cmExecutionStatus& status) override;
 
+  bool WritesFiles() const override { return true; }
+
   enum
   {
     ct_NONE,
@@ -11,6 +11,7 @@
 #include "cmsys/FStream.hxx"
 #include "cmsys/Glob.hxx"
 #include "cmsys/RegularExpression.hxx"
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <sstream>
@@ -108,6 +109,31 @@ public:
   std::string Log;
 };
 
+// Extract the line of text starting at pos, like cmSystemTools::Split
+// does, and advance pos past it.  This lets the output parsers walk a
+// large test log without first copying it into a vector of lines.
+static bool cmCTestMemCheckGetLine(std::string const& str,
+                                   std::string::size_type& pos,
+                                   std::string& line)
+{
+  if (pos >= str.size()) {
+    return false;
+  }
+  std::string::size_type end = str.find('\n', pos);
+  std::string::size_type next;
+  if (end == std::string::npos) {
+    end = next = str.size();
+  } else {
+    next = end + 1;
+    if (end > pos && str[end - 1] == '\r') {
+      --end;
+    }
+  }
+  line.assign(str, pos, end - pos);
+  pos = next;
+  return true;
+}
+
 #define BOUNDS_CHECKER_MARKER                                                 \
   "******######*****Begin BOUNDS CHECKER XML******######******"
 
@@ -117,6 +143,12 @@ cmCTestMemCheckHandler::cmCTestMemCheckHandler()
   this->CustomMaximumPassedTestOutputSize = 0;
   this->CustomMaximumFailedTestOutputSize = 0;
   this->LogWithPID = false;
+  this->OutputQueueClosed = false;
+}
+
+cmCTestMemCheckHandler::~cmCTestMemCheckHandler()
+{
+  this->FinishTestOutput();
 }
 
 void cmCTestMemCheckHandler::Initialize()
@@ -131,6 +163,8 @@ void cmCTestMemCheckHandler::Initialize()
   this->MemoryTesterStyle = UNKNOWN;
   this->MemoryTesterOutputFile.clear();
   this->DefectCount = 0;
+  this->FinishTestOutput();
+  this->ProcessedOutputs.clear();
 }
 
 int cmCTestMemCheckHandler::PreProcessHandler()
@@ -288,6 +322,7 @@ int cmCTestMemCheckHandler::GetDefectCount()
 
 void cmCTestMemCheckHandler::GenerateDartOutput(cmXMLWriter& xml)
 {
+  this->FinishTestOutput();
   if (!this->CTest->GetProduceXML()) {
     return;
   }
@@ -338,9 +373,36 @@ void cmCTestMemCheckHandler::GenerateDartOutput(cmXMLWriter& xml)
   for (cc = 0; cc < this->TestResults.size(); cc++) {
     cmCTestTestResult const& result = this->TestResults[cc];
     std::string memcheckstr;
-    std::vector<int> memcheckresults(this->ResultStrings.size(), 0);
-    bool res =
-      this->ProcessMemCheckOutput(result.Output, memcheckstr, memcheckresults);
+    std::vector<int> memcheckresults;
+    std::vector<std::string> memcheckwarnings;
+    bool res;
+    auto processed = this->ProcessedOutputs.find(result.TestCount);
+    if (processed != this->ProcessedOutputs.end()) {
+      res = processed->second.Passed;
+      memcheckstr = std::move(processed->second.Log);
+      memcheckresults = std::move(processed->second.Results);
+      memcheckwarnings = std::move(processed->second.Warnings);
+      this->ProcessedOutputs.erase(processed);
+    } else {
+      memcheckresults.resize(this->ResultStrings.size(), 0);
+      res = this->ProcessMemCheckOutput(result.Output, memcheckstr,
+                                        memcheckresults, memcheckwarnings);
+    }
+    // Sanitizer warning types are added here, in test order, so they are
+    // numbered the same way however the outputs were parsed.
+    if (!memcheckwarnings.empty()) {
+      std::vector<int> counts;
+      counts.swap(memcheckresults);
+      for (std::vector<int>::size_type kk = 0; kk < counts.size(); ++kk) {
+        std::vector<int>::size_type idx =
+          this->FindOrAddWarning(memcheckwarnings[kk]);
+        memcheckresults.resize(this->ResultStrings.size(), 0);
+        memcheckresults[idx] += counts[kk];
+      }
+    }
+    for (int count : memcheckresults) {
+      this->DefectCount += count;
+    }
     if (res && result.Status == cmCTestMemCheckHandler::COMPLETED) {
       continue;
     }
@@ -658,9 +720,9 @@ bool cmCTestMemCheckHandler::InitializeMemoryChecking()
   return true;
 }
 
-bool cmCTestMemCheckHandler::ProcessMemCheckOutput(const std::string& str,
-                                                   std::string& log,
-                                                   std::vector<int>& results)
+bool cmCTestMemCheckHandler::ProcessMemCheckOutput(
+  const std::string& str, std::string& log, std::vector<int>& results,
+  std::vector<std::string>& warnings)
 {
   switch (this->MemoryTesterStyle) {
     case cmCTestMemCheckHandler::VALGRIND:
@@ -672,7 +734,8 @@ bool cmCTestMemCheckHandler::ProcessMemCheckOutput(const std::string& str,
     case cmCTestMemCheckHandler::THREAD_SANITIZER:
     case cmCTestMemCheckHandler::MEMORY_SANITIZER:
     case cmCTestMemCheckHandler::UB_SANITIZER:
-      return this->ProcessMemCheckSanitizerOutput(str, log, results);
+      return this->ProcessMemCheckSanitizerOutput(str, log, results,
+                                                  warnings);
     case cmCTestMemCheckHandler::BOUNDS_CHECKER:
       return this->ProcessMemCheckBoundsCheckerOutput(str, log, results);
     default:
@@ -698,7 +761,8 @@ std::vector<int>::size_type cmCTestMemCheckHandler::FindOrAddWarning(
   return this->ResultStrings.size() - 1;
 }
 bool cmCTestMemCheckHandler::ProcessMemCheckSanitizerOutput(
-  const std::string& str, std::string& log, std::vector<int>& result)
+  const std::string& str, std::string& log, std::vector<int>& results,
+  std::vector<std::string>& warnings)
 {
   std::string regex;
   switch (this->MemoryTesterStyle) {
@@ -723,11 +787,11 @@ bool cmCTestMemCheckHandler::ProcessMemCheckSanitizerOutput(
   cmsys::RegularExpression sanitizerWarning(regex);
   cmsys::RegularExpression leakWarning("(Direct|Indirect) leak of .*");
   int defects = 0;
-  std::vector<std::string> lines;
-  cmSystemTools::Split(str.c_str(), lines);
   std::ostringstream ostr;
   log.clear();
-  for (std::string const& l : lines) {
+  std::string::size_type pos = 0;
+  std::string l;
+  while (cmCTestMemCheckGetLine(str, pos, l)) {
     std::string resultFound;
     if (leakWarning.find(l)) {
       resultFound = leakWarning.match(1) + " leak";
@@ -735,26 +799,24 @@ bool cmCTestMemCheckHandler::ProcessMemCheckSanitizerOutput(
       resultFound = sanitizerWarning.match(1);
     }
     if (!resultFound.empty()) {
-      std::vector<int>::size_type idx = this->FindOrAddWarning(resultFound);
-      if (result.empty() || idx > result.size() - 1) {
-        result.push_back(1);
+      auto found = std::find(warnings.begin(), warnings.end(), resultFound);
+      if (found == warnings.end()) {
+        warnings.push_back(resultFound);
+        results.push_back(1);
       } else {
-        result[idx]++;
+        results[found - warnings.begin()]++;
       }
       defects++;
-      ostr << "<b>" << this->ResultStrings[idx] << "</b> ";
+      ostr << "<b>" << resultFound << "</b> ";
     }
     ostr << l << std::endl;
   }
   log = ostr.str();
-  this->DefectCount += defects;
   return defects == 0;
 }
 bool cmCTestMemCheckHandler::ProcessMemCheckPurifyOutput(
   const std::string& str, std::string& log, std::vector<int>& results)
 {
-  std::vector<std::string> lines;
-  cmSystemTools::Split(str.c_str(), lines);
   std::ostringstream ostr;
   log.clear();
 
@@ -762,7 +824,9 @@ bool cmCTestMemCheckHandler::ProcessMemCheckPurifyOutput(
 
   int defects = 0;
 
-  for (std::string const& l : lines) {
+  std::string::size_type pos = 0;
+  std::string l;
+  while (cmCTestMemCheckGetLine(str, pos, l)) {
     std::vector<int>::size_type failure = this->ResultStrings.size();
     if (pfW.find(l)) {
       std::vector<int>::size_type cc;
@@ -788,23 +852,18 @@ bool cmCTestMemCheckHandler::ProcessMemCheckPurifyOutput(
   }
 
   log = ostr.str();
-  this->DefectCount += defects;
   return defects == 0;
 }
 
 bool cmCTestMemCheckHandler::ProcessMemCheckValgrindOutput(
   const std::string& str, std::string& log, std::vector<int>& results)
 {
-  std::vector<std::string> lines;
-  cmSystemTools::Split(str.c_str(), lines);
   bool unlimitedOutput = false;
   if (str.find("CTEST_FULL_OUTPUT") != std::string::npos ||
       this->CustomMaximumFailedTestOutputSize == 0) {
     unlimitedOutput = true;
   }
 
-  std::string::size_type cc;
-
   std::ostringstream ostr;
   log.clear();
 
@@ -844,49 +903,53 @@ bool cmCTestMemCheckHandler::ProcessMemCheckValgrindOutput(
   cmsys::RegularExpression vgIPW("== .*Invalid write of size [0-9,]+");
   cmsys::RegularExpression vgABR("== .*pthread_mutex_unlock: mutex is "
                                  "locked by a different thread");
-  std::vector<std::string::size_type> nonValGrindOutput;
+  // Offset and length of each line that is not valgrind output.
+  std::vector<std::pair<std::string::size_type, std::string::size_type>>
+    nonValGrindOutput;
   auto sttime = std::chrono::steady_clock::now();
   cmCTestOptionalLog(this->CTest, DEBUG,
-                     "Start test: " << lines.size() << std::endl, this->Quiet);
+                     "Start test: " << str.size() << std::endl, this->Quiet);
   std::string::size_type totalOutputSize = 0;
-  for (cc = 0; cc < lines.size(); cc++) {
-    cmCTestOptionalLog(this->CTest, DEBUG,
-                       "test line " << lines[cc] << std::endl, this->Quiet);
+  std::string::size_type pos = 0;
+  std::string line;
+  for (std::string::size_type start = pos;
+       cmCTestMemCheckGetLine(str, pos, line); start = pos) {
+    cmCTestOptionalLog(this->CTest, DEBUG, "test line " << line << std::endl,
+                       this->Quiet);
 
-    if (valgrindLine.find(lines[cc])) {
+    if (valgrindLine.find(line)) {
       cmCTestOptionalLog(this->CTest, DEBUG,
-                         "valgrind  line " << lines[cc] << std::endl,
-                         this->Quiet);
+                         "valgrind  line " << line << std::endl, this->Quiet);
       int failure = cmCTestMemCheckHandler::NO_MEMORY_FAULT;
-      if (vgFIM.find(lines[cc])) {
+      if (vgFIM.find(line)) {
         failure = cmCTestMemCheckHandler::FIM;
-      } else if (vgFMM.find(lines[cc])) {
+      } else if (vgFMM.find(line)) {
         failure = cmCTestMemCheckHandler::FMM;
-      } else if (vgMLK1.find(lines[cc])) {
+      } else if (vgMLK1.find(line)) {
         failure = cmCTestMemCheckHandler::MLK;
-      } else if (vgMLK2.find(lines[cc])) {
+      } else if (vgMLK2.find(line)) {
         failure = cmCTestMemCheckHandler::MLK;
-      } else if (vgPAR.find(lines[cc])) {
+      } else if (vgPAR.find(line)) {
         failure = cmCTestMemCheckHandler::PAR;
-      } else if (vgMPK1.find(lines[cc])) {
+      } else if (vgMPK1.find(line)) {
         failure = cmCTestMemCheckHandler::MPK;
-      } else if (vgMPK2.find(lines[cc])) {
+      } else if (vgMPK2.find(line)) {
         failure = cmCTestMemCheckHandler::MPK;
-      } else if (vgUMC.find(lines[cc])) {
+      } else if (vgUMC.find(line)) {
         failure = cmCTestMemCheckHandler::UMC;
-      } else if (vgUMR1.find(lines[cc])) {
+      } else if (vgUMR1.find(line)) {
         failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgUMR2.find(lines[cc])) {
+      } else if (vgUMR2.find(line)) {
         failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgUMR3.find(lines[cc])) {
+      } else if (vgUMR3.find(line)) {
         failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgUMR4.find(lines[cc])) {
+      } else if (vgUMR4.find(line)) {
         failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgUMR5.find(lines[cc])) {
+      } else if (vgUMR5.find(line)) {
         failure = cmCTestMemCheckHandler::UMR;
-      } else if (vgIPW.find(lines[cc])) {
+      } else if (vgIPW.find(line)) {
         failure = cmCTestMemCheckHandler::IPW;
-      } else if (vgABR.find(lines[cc])) {
+      } else if (vgABR.find(line)) {
         failure = cmCTestMemCheckHandler::ABR;
       }
 
@@ -895,18 +958,19 @@ bool cmCTestMemCheckHandler::ProcessMemCheckValgrindOutput(
         results[failure]++;
         defects++;
       }
-      totalOutputSize += lines[cc].size();
-      ostr << lines[cc] << std::endl;
+      totalOutputSize += line.size();
+      ostr << line << std::endl;
     } else {
-      nonValGrindOutput.push_back(cc);
+      nonValGrindOutput.emplace_back(start, line.size());
     }
   }
   // Now put all all the non valgrind output into the test output
   // This should be last in case it gets truncated by the output
   // limiting code
-  for (std::string::size_type i : nonValGrindOutput) {
-    totalOutputSize += lines[i].size();
-    ostr << lines[i] << std::endl;
+  for (auto const& l : nonValGrindOutput) {
+    totalOutputSize += l.second;
+    ostr.write(str.data() + l.first, static_cast<std::streamsize>(l.second));
+    ostr << std::endl;
     if (!unlimitedOutput &&
         totalOutputSize >
           static_cast<size_t>(this->CustomMaximumFailedTestOutputSize)) {
@@ -924,7 +988,6 @@ bool cmCTestMemCheckHandler::ProcessMemCheckValgrindOutput(
       << "s)" << std::endl,
     this->Quiet);
   log = ostr.str();
-  this->DefectCount += defects;
   return defects == 0;
 }
 
@@ -973,7 +1036,6 @@ bool cmCTestMemCheckHandler::ProcessMemCheckBoundsCheckerOutput(
     // errors or leaks detected
     log = parser.Log;
   }
-  this->DefectCount += defects;
   return defects == 0;
 }
 
@@ -995,6 +1057,63 @@ void cmCTestMemCheckHandler::PostProcessTest(cmCTestTestResult& res, int test)
   }
 }
 
+void cmCTestMemCheckHandler::QueueTestOutput(cmCTestTestResult const& res)
+{
+  // The output is only parsed for the Dart output.
+  if (!this->CTest->GetProduceXML()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(this->OutputMutex);
+  if (!this->OutputThread.joinable()) {
+    this->OutputQueueClosed = false;
+    this->OutputThread =
+      std::thread(&cmCTestMemCheckHandler::ProcessTestOutputQueue, this);
+  }
+  this->OutputQueue.emplace_back(res.TestCount, res.Output);
+  lock.unlock();
+  this->OutputCondition.notify_one();
+}
+
+void cmCTestMemCheckHandler::FinishTestOutput()
+{
+  if (!this->OutputThread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->OutputMutex);
+    this->OutputQueueClosed = true;
+  }
+  this->OutputCondition.notify_one();
+  this->OutputThread.join();
+}
+
+void cmCTestMemCheckHandler::ProcessTestOutputQueue()
+{
+  // Only the output of the test is parsed here.  The results are merged
+  // into the shared totals by GenerateDartOutput on the main thread.
+  std::unique_lock<std::mutex> lock(this->OutputMutex);
+  for (;;) {
+    this->OutputCondition.wait(lock, [this]() {
+      return !this->OutputQueue.empty() || this->OutputQueueClosed;
+    });
+    if (this->OutputQueue.empty()) {
+      return;
+    }
+    std::pair<int, std::string> output = std::move(this->OutputQueue.front());
+    this->OutputQueue.pop_front();
+    lock.unlock();
+
+    ProcessedOutput processed;
+    processed.Results.resize(this->ResultStrings.size(), 0);
+    processed.Passed =
+      this->ProcessMemCheckOutput(output.second, processed.Log,
+                                  processed.Results, processed.Warnings);
+
+    lock.lock();
+    this->ProcessedOutputs[output.first] = std::move(processed);
+  }
+}
+
 // This method puts the bounds checker output file into the output
 // for the test
 void cmCTestMemCheckHandler::PostProcessBoundsCheckerTest(
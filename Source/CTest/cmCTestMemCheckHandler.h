@@ -7,7 +7,13 @@
 
 #include "cmCTestTestHandler.h"
 
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 class cmMakefile;
@@ -27,6 +33,7 @@ public:
   void PopulateCustomVectors(cmMakefile* mf) override;
 
   cmCTestMemCheckHandler();
+  ~cmCTestMemCheckHandler() override;
 
   void Initialize() override;
 
@@ -127,20 +134,44 @@ private:
 
   //! Parse Valgrind/Purify/Bounds Checker result out of the output
   // string. After running, log holds the output and results hold the
-  // different memmory errors.
+  // different memmory errors.  The sanitizers report their own error
+  // types, so for them results counts the matching entry of warnings.
+  // None of these change the handler, so they may run on a worker.
   bool ProcessMemCheckOutput(const std::string& str, std::string& log,
-                             std::vector<int>& results);
+                             std::vector<int>& results,
+                             std::vector<std::string>& warnings);
   bool ProcessMemCheckValgrindOutput(const std::string& str, std::string& log,
                                      std::vector<int>& results);
   bool ProcessMemCheckPurifyOutput(const std::string& str, std::string& log,
                                    std::vector<int>& results);
   bool ProcessMemCheckSanitizerOutput(const std::string& str, std::string& log,
-                                      std::vector<int>& results);
+                                      std::vector<int>& results,
+                                      std::vector<std::string>& warnings);
   bool ProcessMemCheckBoundsCheckerOutput(const std::string& str,
                                           std::string& log,
                                           std::vector<int>& results);
 
   void PostProcessTest(cmCTestTestResult& res, int test);
+
+  //! Parse the output of a finished test on a worker thread so that
+  // the results are ready by the time the Dart output is generated.
+  void QueueTestOutput(cmCTestTestResult const& res);
+  void FinishTestOutput();
+  void ProcessTestOutputQueue();
+
+  struct ProcessedOutput
+  {
+    bool Passed;
+    std::string Log;
+    std::vector<int> Results;
+    std::vector<std::string> Warnings;
+  };
+  std::thread OutputThread;
+  std::mutex OutputMutex;
+  std::condition_variable OutputCondition;
+  std::deque<std::pair<int, std::string>> OutputQueue;
+  bool OutputQueueClosed;
+  std::map<int, ProcessedOutput> ProcessedOutputs;
   void PostProcessBoundsCheckerTest(cmCTestTestResult& res, int test);
 
   ///! append MemoryTesterOutputFile to the test log
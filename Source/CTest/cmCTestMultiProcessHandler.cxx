@@ -54,6 +54,7 @@ cmCTestMultiProcessHandler::cmCTestMultiProcessHandler()
   this->Completed = 0;
   this->RunningCount = 0;
   this->StopTimePassed = false;
+  this->StoppedOnFailure = false;
   this->HasCycles = false;
   this->SerialTestRunning = false;
 }
@@ -138,6 +139,9 @@ bool cmCTestMultiProcessHandler::StartTestProcess(int test)
   if (this->CTest->GetRepeatUntilFail()) {
     testRun->SetRunUntilFailOn();
     testRun->SetNumberOfRuns(this->CTest->GetTestRepeat());
+  } else if (this->CTest->GetRepeatUntilPass()) {
+    testRun->SetRunUntilPassOn();
+    testRun->SetNumberOfRuns(this->CTest->GetTestRepeat());
   }
   testRun->SetIndex(test);
   testRun->SetTestProperties(this->Properties[test]);
@@ -157,6 +161,7 @@ bool cmCTestMultiProcessHandler::StartTestProcess(int test)
   this->LockResources(test);
 
   if (testRun->StartTest(this->Total)) {
+    this->RunningTests.insert(testRun);
     return true;
   }
 
@@ -291,6 +296,10 @@ void cmCTestMultiProcessHandler::StartNextTests()
     if (this->SerialTestRunning) {
       break;
     }
+    // Start nothing more once a failure has stopped testing.
+    if (this->StoppedOnFailure) {
+      break;
+    }
     // We can only start a RUN_SERIAL test if no other tests are also running.
     if (this->Properties[test]->RunSerial && this->RunningCount > 0) {
       continue;
@@ -381,11 +390,15 @@ void cmCTestMultiProcessHandler::FinishTestProcess(cmCTestRunTest* runner,
       return;
     }
   }
+  this->RunningTests.erase(runner);
 
   if (testResult) {
     this->Passed->push_back(properties->Name);
   } else if (!properties->Disabled) {
     this->Failed->push_back(properties->Name);
+    if (this->CTest->GetStopOnFailure() && !this->StoppedOnFailure) {
+      this->StopOnFailure(properties->Name);
+    }
   }
 
   for (auto& t : this->Tests) {
@@ -399,11 +412,31 @@ void cmCTestMultiProcessHandler::FinishTestProcess(cmCTestRunTest* runner,
   this->RunningCount -= GetProcessorsUsed(test);
 
   delete runner;
-  if (started) {
+  if (started && !this->StoppedOnFailure) {
     this->StartNextTests();
   }
 }
 
+void cmCTestMultiProcessHandler::StopOnFailure(std::string const& name)
+{
+  this->StoppedOnFailure = true;
+  cmCTestLog(this->CTest, HANDLER_OUTPUT, "Test " << name
+               << " failed. Stopping all tests." << std::endl);
+
+  // Report the tests that have not started yet as not run so that the
+  // summary still accounts for every test.
+  TestList cancelled = this->SortedTests;
+  for (int test : cancelled) {
+    this->StartTestProcess(test);
+  }
+
+  // Kill the tests that are still running.  Their processes finish
+  // asynchronously and are reported as not run.
+  for (cmCTestRunTest* runner : this->RunningTests) {
+    runner->Stop();
+  }
+}
+
 void cmCTestMultiProcessHandler::UpdateCostData()
 {
   std::string fname = this->CTest->GetCostDataFile();
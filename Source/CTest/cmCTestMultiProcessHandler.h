@@ -99,6 +99,8 @@ protected:
   void MarkFinished();
   void EraseTest(int index);
   void FinishTestProcess(cmCTestRunTest* runner, bool started);
+  // Cancel the remaining tests after a test has failed
+  void StopOnFailure(std::string const& name);
 
   void RemoveTest(int index);
   // Check if we need to resume an interrupted test set
@@ -120,11 +122,13 @@ protected:
   size_t Completed;
   size_t RunningCount;
   bool StopTimePassed;
+  bool StoppedOnFailure;
   // list of test properties (indices concurrent to the test map)
   PropertiesMap Properties;
   std::map<int, bool> TestRunningMap;
   std::map<int, bool> TestFinishMap;
   std::map<int, std::string> TestOutput;
+  std::set<cmCTestRunTest*> RunningTests;
   std::vector<std::string>* Passed;
   std::vector<std::string>* Failed;
   std::vector<std::string> LastTestsFailed;
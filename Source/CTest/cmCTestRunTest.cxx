@@ -35,6 +35,7 @@ cmCTestRunTest::cmCTestRunTest(cmCTestMultiProcessHandler& multiHandler)
   this->CompressionRatio = 2;
   this->NumberOfRunsLeft = 1; // default to 1 run of the test
   this->RunUntilFail = false; // default to run the test once
+  this->RunUntilPass = false;
   this->RunAgain = false;     // default to not having to run again
 }
 
@@ -228,6 +229,10 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
                    this->TestResult.ExceptionStatus);
         this->TestResult.Status = cmCTestTestHandler::OTHER_FAULT;
     }
+  } else if (res == cmProcess::State::Killed ||
+             "Stopped" == this->TestResult.CompletionStatus) {
+    cmCTestLog(this->CTest, HANDLER_OUTPUT, "***Not Run (Stopped) ");
+    this->TestResult.Status = cmCTestTestHandler::NOT_RUN;
   } else if ("Disabled" == this->TestResult.CompletionStatus) {
     cmCTestLog(this->CTest, HANDLER_OUTPUT, "***Not Run (Disabled) ");
   } else // cmProcess::State::Error
@@ -325,6 +330,10 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   // TestHandler vector
   if (!this->NeedsToRerun()) {
     this->TestHandler->TestResults.push_back(this->TestResult);
+    if (this->TestHandler->MemCheck) {
+      static_cast<cmCTestMemCheckHandler*>(this->TestHandler)
+        ->QueueTestOutput(this->TestResult);
+    }
   }
   this->TestProcess.reset();
   return passed || skipped;
@@ -348,6 +357,10 @@ bool cmCTestRunTest::NeedsToRerun()
   if (this->NumberOfRunsLeft == 0) {
     return false;
   }
+  // Do not start the test again once testing has been stopped.
+  if (this->MultiTestHandler.StoppedOnFailure) {
+    return false;
+  }
   // if number of runs left is not 0, and we are running until
   // we find a failed test, then return true so the test can be
   // restarted
@@ -356,6 +369,15 @@ bool cmCTestRunTest::NeedsToRerun()
     this->RunAgain = true;
     return true;
   }
+  // likewise if we are running until the test passes and it ran
+  // but did not pass
+  if (this->RunUntilPass &&
+      this->TestResult.Status != cmCTestTestHandler::COMPLETED &&
+      this->TestResult.Status != cmCTestTestHandler::NOT_RUN &&
+      this->TestResult.Status != cmCTestTestHandler::BAD_COMMAND) {
+    this->RunAgain = true;
+    return true;
+  }
   return false;
 }
 void cmCTestRunTest::ComputeWeightedCost()
@@ -390,6 +412,24 @@ void cmCTestRunTest::MemCheckPostProcess()
 bool cmCTestRunTest::StartTest(size_t total)
 {
   this->TotalNumberOfTests = total; // save for rerun case
+
+  // Report tests cancelled by --stop-on-failure without starting them.
+  if (this->MultiTestHandler.StoppedOnFailure) {
+    this->TestResult.Properties = this->TestProperties;
+    this->TestResult.ExecutionTime = cmDuration::zero();
+    this->TestResult.CompressOutput = false;
+    this->TestResult.ReturnValue = -1;
+    this->TestResult.CompletionStatus = "Stopped";
+    this->TestResult.Status = cmCTestTestHandler::NOT_RUN;
+    this->TestResult.TestCount = this->TestProperties->Index;
+    this->TestResult.Name = this->TestProperties->Name;
+    this->TestResult.Path = this->TestProperties->Directory;
+    this->TestProcess = cm::make_unique<cmProcess>(*this);
+    this->TestResult.Output = "Stopped after a failed test";
+    this->TestResult.FullCommandLine.clear();
+    return false;
+  }
+
   cmCTestLog(this->CTest, HANDLER_OUTPUT, std::setw(2 * getNumWidth(total) + 8)
                << "Start "
                << std::setw(getNumWidth(this->TestHandler->GetMaxIndex()))
@@ -647,8 +687,9 @@ void cmCTestRunTest::WriteLogOutputTop(size_t completed, size_t total)
   // Only issue is if a test fails and we are running until fail
   // then it will never print out the completed / total, same would
   // got for run until pass.  Trick is when this is called we don't
-  // yet know if we are passing or failing.
-  if (this->NumberOfRunsLeft == 1) {
+  // yet know if we are passing or failing.  When running until pass
+  // most tests pass on their first run, so always print it then.
+  if (this->NumberOfRunsLeft == 1 || this->RunUntilPass) {
     cmCTestLog(this->CTest, HANDLER_OUTPUT, std::setw(getNumWidth(total))
                  << completed << "/");
     cmCTestLog(this->CTest, HANDLER_OUTPUT, std::setw(getNumWidth(total))
@@ -716,3 +757,10 @@ void cmCTestRunTest::FinalizeTest()
 {
   this->MultiTestHandler.FinishTestProcess(this, true);
 }
+
+void cmCTestRunTest::Stop()
+{
+  if (this->TestProcess) {
+    this->TestProcess->Kill();
+  }
+}
@@ -31,6 +31,7 @@ public:
 
   void SetNumberOfRuns(int n) { this->NumberOfRunsLeft = n; }
   void SetRunUntilFailOn() { this->RunUntilFail = true; }
+  void SetRunUntilPassOn() { this->RunUntilPass = true; }
   void SetTestProperties(cmCTestTestHandler::cmCTestTestProperties* prop)
   {
     this->TestProperties = prop;
@@ -78,6 +79,9 @@ public:
 
   void FinalizeTest();
 
+  // Kill the running test process; the test finishes as not run
+  void Stop();
+
 private:
   bool NeedsToRerun();
   void DartProcessing();
@@ -105,6 +109,7 @@ private:
   std::string ActualCommand;
   std::vector<std::string> Arguments;
   bool RunUntilFail;
+  bool RunUntilPass;
   int NumberOfRunsLeft;
   bool RunAgain;
   size_t TotalNumberOfTests;
@@ -44,6 +44,8 @@ public:
   bool InitialPass(std::vector<std::string> const& args,
                    cmExecutionStatus& status) override;
 
+  bool WritesFiles() const override { return true; }
+
   /**
    * Will this invocation of ctest_start create a new TAG file?
    */
@@ -34,6 +34,11 @@
 #include "cmake.h"
 #include "cmsys/FStream.hxx"
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#include "cm_jsoncpp_reader.h"
+#include "cm_jsoncpp_value.h"
+#endif
+
 class cmExecutionStatus;
 
 class cmCTestSubdirCommand : public cmCommand
@@ -82,27 +87,11 @@ bool cmCTestSubdirCommand::InitialPass(std::vector<std::string> const& args,
       // No subdirectory? So what...
       continue;
     }
-    bool readit = false;
-    {
-      cmWorkingDirectory workdir(fname);
-      const char* testFilename;
-      if (cmSystemTools::FileExists("CTestTestfile.cmake")) {
-        // does the CTestTestfile.cmake exist ?
-        testFilename = "CTestTestfile.cmake";
-      } else if (cmSystemTools::FileExists("DartTestfile.txt")) {
-        // does the DartTestfile.txt exist ?
-        testFilename = "DartTestfile.txt";
-      } else {
-        // No CTestTestfile? Who cares...
-        continue;
-      }
-      fname += "/";
-      fname += testFilename;
-      readit = this->Makefile->ReadDependentFile(fname.c_str());
-    }
-    if (!readit) {
+    std::string testFile;
+    if (!this->TestHandler->ReadTestDirectory(this->Makefile, fname,
+                                              testFile)) {
       std::string m = "Could not find include file: ";
-      m += fname;
+      m += testFile;
       this->SetError(m);
       return false;
     }
@@ -374,6 +363,8 @@ void cmCTestTestHandler::Initialize()
   this->ExcludeFixtureRegExp.clear();
   this->ExcludeFixtureSetupRegExp.clear();
   this->ExcludeFixtureCleanupRegExp.clear();
+  this->ChangedSince.clear();
+  this->ChangedFiles.clear();
 
   TestsToRunString.clear();
   this->UseUnion = false;
@@ -463,6 +454,10 @@ int cmCTestTestHandler::ProcessHandler()
   if (val) {
     this->ExcludeFixtureCleanupRegExp = val;
   }
+  val = this->GetOption("ChangedSince");
+  if (val) {
+    this->ChangedSince = val;
+  }
   this->SetRerunFailed(cmSystemTools::IsOn(this->GetOption("RerunFailed")));
 
   this->TestResults.clear();
@@ -753,6 +748,74 @@ void cmCTestTestHandler::CheckLabelFilter(cmCTestTestProperties& it)
   this->CheckLabelFilterExclude(it);
 }
 
+bool cmCTestTestHandler::LoadChangedFiles()
+{
+  this->ChangedFiles.clear();
+  cmsys::ifstream fin(this->ChangedSince.c_str());
+  if (!fin) {
+    cmCTestLog(this->CTest, WARNING, "Unable to read changed files list: "
+                 << this->ChangedSince << std::endl
+                 << "Running all tests." << std::endl);
+    return false;
+  }
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    line = cmSystemTools::TrimWhitespace(line);
+    if (line.empty()) {
+      continue;
+    }
+    cmSystemTools::ConvertToUnixSlashes(line);
+    this->ChangedFiles.push_back(line);
+  }
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     "Selecting tests affected by "
+                       << this->ChangedFiles.size() << " changed file(s)"
+                       << std::endl,
+                     this->Quiet);
+  return true;
+}
+
+bool cmCTestTestHandler::IsChangedFile(std::string const& file) const
+{
+  std::string path = file;
+  cmSystemTools::ConvertToUnixSlashes(path);
+  for (std::string const& changed : this->ChangedFiles) {
+    // A relative entry, such as produced by "git diff --name-only",
+    // matches any dependency whose path ends in the same components.
+    if (path == changed ||
+        (cmHasSuffix(path, changed) &&
+         path[path.size() - changed.size() - 1] == '/')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void cmCTestTestHandler::CheckChangedFilter(cmCTestTestProperties& it)
+{
+  if (!it.IsInBasedOnREOptions) {
+    return;
+  }
+  // Tests for which no dependency information is known are always run.
+  if (it.ChangeDepends.empty() && it.RequiredFiles.empty()) {
+    return;
+  }
+  for (std::string const& f : it.ChangeDepends) {
+    if (this->IsChangedFile(f)) {
+      return;
+    }
+  }
+  for (std::string const& f : it.RequiredFiles) {
+    if (this->IsChangedFile(f)) {
+      return;
+    }
+  }
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     "Not affected by changed files: " << it.Name << std::endl,
+                     this->Quiet);
+  it.IsInBasedOnREOptions = false;
+}
+
 void cmCTestTestHandler::ComputeTestList()
 {
   this->TestList.clear(); // clear list of test
@@ -763,11 +826,19 @@ void cmCTestTestHandler::ComputeTestList()
     return;
   }
 
+  bool useChangedFilter = false;
+  if (!this->ChangedSince.empty()) {
+    useChangedFilter = this->LoadChangedFiles();
+  }
+
   cmCTestTestHandler::ListOfTests::size_type tmsize = this->TestList.size();
   // how many tests are in based on RegExp?
   int inREcnt = 0;
   for (cmCTestTestProperties& tp : this->TestList) {
     this->CheckLabelFilter(tp);
+    if (useChangedFilter) {
+      this->CheckChangedFilter(tp);
+    }
     if (tp.IsInBasedOnREOptions) {
       inREcnt++;
     }
@@ -1671,6 +1742,14 @@ void cmCTestTestHandler::GetListOfTests()
   newCom5->TestHandler = this;
   cm.GetState()->AddBuiltinCommand("set_directory_properties", newCom5);
 
+  if (this->ReadTestManifest(&mf,
+                             cmSystemTools::GetCurrentWorkingDirectory())) {
+    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                       "Done constructing a list of tests" << std::endl,
+                       this->Quiet);
+    return;
+  }
+
   const char* testFilename;
   if (cmSystemTools::FileExists("CTestTestfile.cmake")) {
     // does the CTestTestfile.cmake exist ?
@@ -1693,6 +1772,138 @@ void cmCTestTestHandler::GetListOfTests()
                      this->Quiet);
 }
 
+bool cmCTestTestHandler::ReadTestDirectory(cmMakefile* mf,
+                                           std::string const& dir,
+                                           std::string& testFile)
+{
+  if (this->ReadTestManifest(mf, dir)) {
+    return true;
+  }
+  cmWorkingDirectory workdir(dir);
+  if (cmSystemTools::FileExists("CTestTestfile.cmake")) {
+    // does the CTestTestfile.cmake exist ?
+    testFile = dir + "/CTestTestfile.cmake";
+  } else if (cmSystemTools::FileExists("DartTestfile.txt")) {
+    // does the DartTestfile.txt exist ?
+    testFile = dir + "/DartTestfile.txt";
+  } else {
+    // No CTestTestfile? Who cares...
+    return true;
+  }
+  return mf->ReadDependentFile(testFile.c_str());
+}
+
+bool cmCTestTestHandler::ReadTestManifest(cmMakefile* mf,
+                                          std::string const& dir)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Use the manifest only if it describes the current test script.
+  std::string const manifestFile = dir + "/CTestTestfile.json";
+  std::string const scriptFile = dir + "/CTestTestfile.cmake";
+  int result;
+  if (!cmSystemTools::FileExists(manifestFile) ||
+      !cmSystemTools::FileTimeCompare(manifestFile, scriptFile, &result) ||
+      result < 0) {
+    return false;
+  }
+
+  Json::Value manifest;
+  Json::Reader reader;
+  cmsys::ifstream fin(manifestFile.c_str(), std::ios::in | std::ios::binary);
+  if (!reader.parse(fin, manifest, false) || !manifest.isObject() ||
+      manifest["version"] != 1 || !manifest["tests"].isArray() ||
+      !manifest["subdirs"].isArray()) {
+    return false;
+  }
+
+  // Validate the whole manifest before adding any of its tests.
+  for (Json::Value const& test : manifest["tests"]) {
+    if (!test.isObject() || !test["name"].isString() ||
+        !test["command"].isArray() || test["command"].empty() ||
+        !test["properties"].isArray()) {
+      return false;
+    }
+    for (Json::Value const& arg : test["command"]) {
+      if (!arg.isString()) {
+        return false;
+      }
+    }
+    for (Json::Value const& prop : test["properties"]) {
+      if (!prop.isArray() || prop.size() != 2 || !prop[0].isString() ||
+          !prop[1].isString()) {
+        return false;
+      }
+    }
+  }
+  for (Json::Value const& subdir : manifest["subdirs"]) {
+    if (!subdir.isString()) {
+      return false;
+    }
+  }
+  Json::Value const& labels = manifest["labels"];
+  if (!labels.isNull() && !labels.isString()) {
+    return false;
+  }
+
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+                     "Reading test manifest " << manifestFile << std::endl,
+                     this->Quiet);
+
+  cmWorkingDirectory workdir(dir);
+  std::vector<std::string> args;
+  for (Json::Value const& test : manifest["tests"]) {
+    args.clear();
+    args.push_back(test["name"].asString());
+    for (Json::Value const& arg : test["command"]) {
+      args.push_back(arg.asString());
+    }
+    this->AddTest(args);
+    if (test["properties"].empty()) {
+      continue;
+    }
+    // Like set_tests_properties in the script, this applies the
+    // properties to every test of that name added so far.
+    args.clear();
+    args.push_back(test["name"].asString());
+    args.push_back("PROPERTIES");
+    for (Json::Value const& prop : test["properties"]) {
+      args.push_back(prop[0].asString());
+      args.push_back(prop[1].asString());
+    }
+    this->SetTestsProperties(args);
+  }
+
+  // Subdirectories without a manifest fall back to their script.
+  for (Json::Value const& subdir : manifest["subdirs"]) {
+    std::string subdirPath = subdir.asString();
+    if (!cmSystemTools::FileIsFullPath(subdirPath)) {
+      subdirPath = dir + "/" + subdirPath;
+    }
+    if (!cmSystemTools::FileIsDirectory(subdirPath)) {
+      continue;
+    }
+    std::string testFile;
+    if (!this->ReadTestDirectory(mf, subdirPath, testFile)) {
+      cmSystemTools::Error("Could not find include file: ", testFile.c_str());
+    }
+  }
+
+  // The script sets the directory labels after its subdirs() calls.
+  if (labels.isString()) {
+    args.clear();
+    args.push_back("PROPERTIES");
+    args.push_back("LABELS");
+    args.push_back(labels.asString());
+    this->SetDirectoryProperties(args);
+  }
+  return true;
+#else
+  static_cast<void>(mf);
+  static_cast<void>(dir);
+  return false;
+#endif
+}
+
 void cmCTestTestHandler::UseIncludeRegExp()
 {
   this->UseIncludeRegExpFlag = true;
@@ -2103,132 +2314,142 @@ bool cmCTestTestHandler::SetTestsProperties(
     for (std::string const& t : tests) {
       for (cmCTestTestProperties& rt : this->TestList) {
         if (t == rt.Name) {
-          if (key == "WILL_FAIL") {
-            rt.WillFail = cmSystemTools::IsOn(val.c_str());
-          }
-          if (key == "DISABLED") {
-            rt.Disabled = cmSystemTools::IsOn(val.c_str());
-          }
-          if (key == "ATTACHED_FILES") {
-            cmSystemTools::ExpandListArgument(val, rt.AttachedFiles);
-          }
-          if (key == "ATTACHED_FILES_ON_FAIL") {
-            cmSystemTools::ExpandListArgument(val, rt.AttachOnFail);
-          }
-          if (key == "RESOURCE_LOCK") {
-            std::vector<std::string> lval;
-            cmSystemTools::ExpandListArgument(val, lval);
+          this->SetTestProperty(rt, key, val);
+        }
+      }
+    }
+  }
+  return true;
+}
 
-            rt.LockedResources.insert(lval.begin(), lval.end());
-          }
-          if (key == "FIXTURES_SETUP") {
-            std::vector<std::string> lval;
-            cmSystemTools::ExpandListArgument(val, lval);
+void cmCTestTestHandler::SetTestProperty(cmCTestTestProperties& rt,
+                                         std::string const& key,
+                                         std::string const& val)
+{
+  if (key == "WILL_FAIL") {
+    rt.WillFail = cmSystemTools::IsOn(val.c_str());
+  }
+  if (key == "DISABLED") {
+    rt.Disabled = cmSystemTools::IsOn(val.c_str());
+  }
+  if (key == "ATTACHED_FILES") {
+    cmSystemTools::ExpandListArgument(val, rt.AttachedFiles);
+  }
+  if (key == "ATTACHED_FILES_ON_FAIL") {
+    cmSystemTools::ExpandListArgument(val, rt.AttachOnFail);
+  }
+  if (key == "RESOURCE_LOCK") {
+    std::vector<std::string> lval;
+    cmSystemTools::ExpandListArgument(val, lval);
 
-            rt.FixturesSetup.insert(lval.begin(), lval.end());
-          }
-          if (key == "FIXTURES_CLEANUP") {
-            std::vector<std::string> lval;
-            cmSystemTools::ExpandListArgument(val, lval);
+    rt.LockedResources.insert(lval.begin(), lval.end());
+  }
+  if (key == "FIXTURES_SETUP") {
+    std::vector<std::string> lval;
+    cmSystemTools::ExpandListArgument(val, lval);
 
-            rt.FixturesCleanup.insert(lval.begin(), lval.end());
-          }
-          if (key == "FIXTURES_REQUIRED") {
-            std::vector<std::string> lval;
-            cmSystemTools::ExpandListArgument(val, lval);
+    rt.FixturesSetup.insert(lval.begin(), lval.end());
+  }
+  if (key == "FIXTURES_CLEANUP") {
+    std::vector<std::string> lval;
+    cmSystemTools::ExpandListArgument(val, lval);
 
-            rt.FixturesRequired.insert(lval.begin(), lval.end());
-          }
-          if (key == "TIMEOUT") {
-            rt.Timeout = cmDuration(atof(val.c_str()));
-            rt.ExplicitTimeout = true;
-          }
-          if (key == "COST") {
-            rt.Cost = static_cast<float>(atof(val.c_str()));
-          }
-          if (key == "REQUIRED_FILES") {
-            cmSystemTools::ExpandListArgument(val, rt.RequiredFiles);
-          }
-          if (key == "RUN_SERIAL") {
-            rt.RunSerial = cmSystemTools::IsOn(val.c_str());
-          }
-          if (key == "FAIL_REGULAR_EXPRESSION") {
-            std::vector<std::string> lval;
-            cmSystemTools::ExpandListArgument(val, lval);
-            for (std::string const& cr : lval) {
-              rt.ErrorRegularExpressions.emplace_back(cr, cr);
-            }
-          }
-          if (key == "PROCESSORS") {
-            rt.Processors = atoi(val.c_str());
-            if (rt.Processors < 1) {
-              rt.Processors = 1;
-            }
-          }
-          if (key == "SKIP_RETURN_CODE") {
-            rt.SkipReturnCode = atoi(val.c_str());
-            if (rt.SkipReturnCode < 0 || rt.SkipReturnCode > 255) {
-              rt.SkipReturnCode = -1;
-            }
-          }
-          if (key == "DEPENDS") {
-            cmSystemTools::ExpandListArgument(val, rt.Depends);
-          }
-          if (key == "ENVIRONMENT") {
-            cmSystemTools::ExpandListArgument(val, rt.Environment);
-          }
-          if (key == "LABELS") {
-            std::vector<std::string> Labels;
-            cmSystemTools::ExpandListArgument(val, Labels);
-            rt.Labels.insert(rt.Labels.end(), Labels.begin(), Labels.end());
-            // sort the array
-            std::sort(rt.Labels.begin(), rt.Labels.end());
-            // remove duplicates
-            std::vector<std::string>::iterator new_end =
-              std::unique(rt.Labels.begin(), rt.Labels.end());
-            rt.Labels.erase(new_end, rt.Labels.end());
-          }
-          if (key == "MEASUREMENT") {
-            size_t pos = val.find_first_of('=');
-            if (pos != std::string::npos) {
-              std::string mKey = val.substr(0, pos);
-              const char* mVal = val.c_str() + pos + 1;
-              rt.Measurements[mKey] = mVal;
-            } else {
-              rt.Measurements[val] = "1";
-            }
-          }
-          if (key == "PASS_REGULAR_EXPRESSION") {
-            std::vector<std::string> lval;
-            cmSystemTools::ExpandListArgument(val, lval);
-            for (std::string const& cr : lval) {
-              rt.RequiredRegularExpressions.emplace_back(cr, cr);
-            }
-          }
-          if (key == "WORKING_DIRECTORY") {
-            rt.Directory = val;
-          }
-          if (key == "TIMEOUT_AFTER_MATCH") {
-            std::vector<std::string> propArgs;
-            cmSystemTools::ExpandListArgument(val, propArgs);
-            if (propArgs.size() != 2) {
-              cmCTestLog(this->CTest, WARNING,
-                         "TIMEOUT_AFTER_MATCH expects two arguments, found "
-                           << propArgs.size() << std::endl);
-            } else {
-              rt.AlternateTimeout = cmDuration(atof(propArgs[0].c_str()));
-              std::vector<std::string> lval;
-              cmSystemTools::ExpandListArgument(propArgs[1], lval);
-              for (std::string const& cr : lval) {
-                rt.TimeoutRegularExpressions.emplace_back(cr, cr);
-              }
-            }
-          }
-        }
+    rt.FixturesCleanup.insert(lval.begin(), lval.end());
+  }
+  if (key == "FIXTURES_REQUIRED") {
+    std::vector<std::string> lval;
+    cmSystemTools::ExpandListArgument(val, lval);
+
+    rt.FixturesRequired.insert(lval.begin(), lval.end());
+  }
+  if (key == "TIMEOUT") {
+    rt.Timeout = cmDuration(atof(val.c_str()));
+    rt.ExplicitTimeout = true;
+  }
+  if (key == "COST") {
+    rt.Cost = static_cast<float>(atof(val.c_str()));
+  }
+  if (key == "REQUIRED_FILES") {
+    cmSystemTools::ExpandListArgument(val, rt.RequiredFiles);
+  }
+  if (key == "CHANGE_DEPENDS") {
+    cmSystemTools::ExpandListArgument(val, rt.ChangeDepends);
+  }
+  if (key == "RUN_SERIAL") {
+    rt.RunSerial = cmSystemTools::IsOn(val.c_str());
+  }
+  if (key == "FAIL_REGULAR_EXPRESSION") {
+    std::vector<std::string> lval;
+    cmSystemTools::ExpandListArgument(val, lval);
+    for (std::string const& cr : lval) {
+      rt.ErrorRegularExpressions.emplace_back(cr, cr);
+    }
+  }
+  if (key == "PROCESSORS") {
+    rt.Processors = atoi(val.c_str());
+    if (rt.Processors < 1) {
+      rt.Processors = 1;
+    }
+  }
+  if (key == "SKIP_RETURN_CODE") {
+    rt.SkipReturnCode = atoi(val.c_str());
+    if (rt.SkipReturnCode < 0 || rt.SkipReturnCode > 255) {
+      rt.SkipReturnCode = -1;
+    }
+  }
+  if (key == "DEPENDS") {
+    cmSystemTools::ExpandListArgument(val, rt.Depends);
+  }
+  if (key == "ENVIRONMENT") {
+    cmSystemTools::ExpandListArgument(val, rt.Environment);
+  }
+  if (key == "LABELS") {
+    std::vector<std::string> Labels;
+    cmSystemTools::ExpandListArgument(val, Labels);
+    rt.Labels.insert(rt.Labels.end(), Labels.begin(), Labels.end());
+    // sort the array
+    std::sort(rt.Labels.begin(), rt.Labels.end());
+    // remove duplicates
+    std::vector<std::string>::iterator new_end =
+      std::unique(rt.Labels.begin(), rt.Labels.end());
+    rt.Labels.erase(new_end, rt.Labels.end());
+  }
+  if (key == "MEASUREMENT") {
+    size_t pos = val.find_first_of('=');
+    if (pos != std::string::npos) {
+      std::string mKey = val.substr(0, pos);
+      const char* mVal = val.c_str() + pos + 1;
+      rt.Measurements[mKey] = mVal;
+    } else {
+      rt.Measurements[val] = "1";
+    }
+  }
+  if (key == "PASS_REGULAR_EXPRESSION") {
+    std::vector<std::string> lval;
+    cmSystemTools::ExpandListArgument(val, lval);
+    for (std::string const& cr : lval) {
+      rt.RequiredRegularExpressions.emplace_back(cr, cr);
+    }
+  }
+  if (key == "WORKING_DIRECTORY") {
+    rt.Directory = val;
+  }
+  if (key == "TIMEOUT_AFTER_MATCH") {
+    std::vector<std::string> propArgs;
+    cmSystemTools::ExpandListArgument(val, propArgs);
+    if (propArgs.size() != 2) {
+      cmCTestLog(this->CTest, WARNING,
+                 "TIMEOUT_AFTER_MATCH expects two arguments, found "
+                   << propArgs.size() << std::endl);
+    } else {
+      rt.AlternateTimeout = cmDuration(atof(propArgs[0].c_str()));
+      std::vector<std::string> lval;
+      cmSystemTools::ExpandListArgument(propArgs[1], lval);
+      for (std::string const& cr : lval) {
+        rt.TimeoutRegularExpressions.emplace_back(cr, cr);
       }
     }
   }
-  return true;
 }
 
 bool cmCTestTestHandler::SetDirectoryProperties(
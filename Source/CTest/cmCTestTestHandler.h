@@ -96,6 +96,14 @@ public:
    */
   bool SetDirectoryProperties(const std::vector<std::string>& args);
 
+  /**
+   * Read the tests of a directory, from its test manifest if it has
+   * one and by executing its test script otherwise.  On failure to
+   * read the script its path is stored in testFile.
+   */
+  bool ReadTestDirectory(cmMakefile* mf, std::string const& dir,
+                         std::string& testFile);
+
   void Initialize() override;
 
   // NOTE: This struct is Saved/Restored
@@ -108,6 +116,7 @@ public:
     std::string Directory;
     std::vector<std::string> Args;
     std::vector<std::string> RequiredFiles;
+    std::vector<std::string> ChangeDepends;
     std::vector<std::string> Depends;
     std::vector<std::string> AttachedFiles;
     std::vector<std::string> AttachOnFail;
@@ -247,6 +256,17 @@ private:
    * Get the list of tests in directory and subdirectories.
    */
   void GetListOfTests();
+
+  /**
+   * Read the tests of a directory from the CTestTestfile.json manifest
+   * written by CMake next to its CTestTestfile.cmake.  Returns false if
+   * there is no up-to-date manifest.
+   */
+  bool ReadTestManifest(cmMakefile* mf, std::string const& dir);
+
+  // set a property of a single test
+  void SetTestProperty(cmCTestTestProperties& rt, std::string const& key,
+                       std::string const& val);
   // compute the lists of tests that will actually run
   // based on union regex and -I stuff
   void ComputeTestList();
@@ -293,6 +313,8 @@ private:
   std::string ExcludeFixtureRegExp;
   std::string ExcludeFixtureSetupRegExp;
   std::string ExcludeFixtureCleanupRegExp;
+  std::string ChangedSince;
+  std::vector<std::string> ChangedFiles;
   cmsys::RegularExpression IncludeLabelRegularExpression;
   cmsys::RegularExpression ExcludeLabelRegularExpression;
   cmsys::RegularExpression IncludeTestsRegularExpression;
@@ -304,6 +326,11 @@ private:
   void CheckLabelFilterExclude(cmCTestTestProperties& it);
   void CheckLabelFilterInclude(cmCTestTestProperties& it);
 
+  // exclude tests that do not depend on any of the ChangedFiles
+  bool LoadChangedFiles();
+  void CheckChangedFilter(cmCTestTestProperties& it);
+  bool IsChangedFile(std::string const& file) const;
+
   std::string TestsToRunString;
   bool UseUnion;
   ListOfTests TestList;
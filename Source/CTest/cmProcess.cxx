@@ -292,11 +292,21 @@ void cmProcess::OnTimeoutCB(uv_timer_t* timer)
 }
 
 void cmProcess::OnTimeout()
+{
+  this->Terminate(cmProcess::State::Expired);
+}
+
+void cmProcess::Kill()
+{
+  this->Terminate(cmProcess::State::Killed);
+}
+
+void cmProcess::Terminate(State state)
 {
   if (this->ProcessState != cmProcess::State::Executing) {
     return;
   }
-  this->ProcessState = cmProcess::State::Expired;
+  this->ProcessState = state;
   bool const was_still_reading = !this->ReadHandleClosed;
   if (!this->ReadHandleClosed) {
     this->ReadHandleClosed = true;
@@ -322,7 +332,8 @@ void cmProcess::OnExitCB(uv_process_t* process, int64_t exit_status,
 
 void cmProcess::OnExit(int64_t exit_status, int term_signal)
 {
-  if (this->ProcessState != cmProcess::State::Expired) {
+  if (this->ProcessState != cmProcess::State::Expired &&
+      this->ProcessState != cmProcess::State::Killed) {
     if (
 #if defined(_WIN32)
       ((DWORD)exit_status & 0xF0000000) == 0xC0000000
@@ -37,6 +37,8 @@ public:
   void ResetStartTime();
   // Return true if the process starts
   bool StartProcess(uv_loop_t& loop);
+  // Kill the process if it is still executing
+  void Kill();
 
   enum class State
   {
@@ -100,6 +102,7 @@ private:
   void OnAllocate(size_t suggested_size, uv_buf_t* buf);
 
   void StartTimer();
+  void Terminate(State state);
 
   class Buffer : public std::vector<char>
   {
@@ -0,0 +1,73 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+#[=======================================================================[.rst:
+FindLibZstd
+------------
+
+Find LibZstd include directory and library.
+
+Imported Targets
+^^^^^^^^^^^^^^^^
+
+An :ref:`imported target <Imported targets>` named
+``LibZstd::LibZstd`` is provided if LibZstd has been found.
+
+Result Variables
+^^^^^^^^^^^^^^^^
+
+This module defines the following variables:
+
+``LibZstd_FOUND``
+  True if LibZstd was found, false otherwise.
+``LibZstd_INCLUDE_DIRS``
+  Include directories needed to include LibZstd headers.
+``LibZstd_LIBRARIES``
+  Libraries needed to link to LibZstd.
+
+Cache Variables
+^^^^^^^^^^^^^^^
+
+This module uses the following cache variables:
+
+``LibZstd_LIBRARY``
+  The location of the LibZstd library file.
+``LibZstd_INCLUDE_DIR``
+  The location of the LibZstd include directory containing ``zstd.h``.
+
+The cache variables should not be used by project code.
+They may be set by end users to point at LibZstd components.
+#]=======================================================================]
+
+#-----------------------------------------------------------------------------
+find_library(LibZstd_LIBRARY
+  NAMES zstd
+  )
+mark_as_advanced(LibZstd_LIBRARY)
+
+find_path(LibZstd_INCLUDE_DIR
+  NAMES zstd.h
+  )
+mark_as_advanced(LibZstd_INCLUDE_DIR)
+
+#-----------------------------------------------------------------------------
+include(${CMAKE_CURRENT_LIST_DIR}/../../Modules/FindPackageHandleStandardArgs.cmake)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(LibZstd
+  FOUND_VAR LibZstd_FOUND
+  REQUIRED_VARS LibZstd_LIBRARY LibZstd_INCLUDE_DIR
+  )
+set(LIBZSTD_FOUND ${LibZstd_FOUND})
+
+#-----------------------------------------------------------------------------
+# Provide documented result variables and targets.
+if(LibZstd_FOUND)
+  set(LibZstd_INCLUDE_DIRS ${LibZstd_INCLUDE_DIR})
+  set(LibZstd_LIBRARIES ${LibZstd_LIBRARY})
+  if(NOT TARGET LibZstd::LibZstd)
+    add_library(LibZstd::LibZstd UNKNOWN IMPORTED)
+    set_target_properties(LibZstd::LibZstd PROPERTIES
+      IMPORTED_LOCATION "${LibZstd_LIBRARY}"
+      INTERFACE_INCLUDE_DIRECTORIES "${LibZstd_INCLUDE_DIRS}"
+      )
+  endif()
+endif()
@@ -2,16 +2,24 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmArchiveWrite.h"
 
+#include "cmAlgorithms.h"
 #include "cmLocale.h"
 #include "cmSystemTools.h"
+#include "cmWorkerPool.h"
 #include "cm_get_date.h"
 #include "cm_libarchive.h"
+#include "cm_zstd.h"
 #include "cmsys/Directory.hxx"
 #include "cmsys/Encoding.hxx"
 #include "cmsys/FStream.hxx"
+#include <algorithm>
+#include <deque>
+#include <future>
 #include <iostream>
 #include <string.h>
 #include <time.h>
+#include <utility>
+#include <vector>
 
 #ifndef __LA_SSIZE_T
 #define __LA_SSIZE_T la_ssize_t
@@ -56,31 +64,344 @@ public:
   operator struct archive_entry*() { return this->Object; }
 };
 
+// Compress the data libarchive writes for the archive on our own.
+class cmArchiveWrite::Compressor
+{
+public:
+  virtual ~Compressor() = default;
+
+  virtual bool Write(const char* data, size_t n) = 0;
+  virtual bool Finish() = 0;
+  std::string const& GetError() const { return this->Error; }
+
+protected:
+  std::string Error;
+};
+
+// Compress the archive in blocks of fixed size on worker threads.  Each
+// block becomes a complete gzip member or xz stream.  Readers of either
+// format decompress such a concatenation as one stream of data.
+class cmArchiveWrite::BlockCompressor : public cmArchiveWrite::Compressor
+{
+public:
+  BlockCompressor(std::ostream& os, Compress c, int threads);
+
+  bool Write(const char* data, size_t n) override;
+  bool Finish() override;
+
+private:
+  struct Block
+  {
+    std::string Data;
+    std::string Output;
+    std::string Error;
+    std::promise<void> Done;
+    std::future<void> Ready;
+  };
+
+  void Post();
+  void WriteFront();
+  static void CompressBlock(Compress c, Block& block);
+  static __LA_SSIZE_T Output(struct archive* a, void* cd, const void* b,
+                             size_t n);
+
+  std::ostream& Stream;
+  Compress const Compression;
+  size_t const BlockSize;
+  size_t MaxPending;
+  std::string Data;
+  std::deque<std::unique_ptr<Block>> Pending;
+  // Destroyed first so that the jobs finish before their blocks go away.
+  std::unique_ptr<cmWorkerPool> Pool;
+};
+
+// Use the block size of parallel xz at its default level, and blocks of
+// 1 MiB for gzip, which finds matches within 32 KiB anyway.  At most
+// 256 MiB of data wait to be compressed or written, whatever the number
+// of threads, which limits xz to 10 blocks and threads.
+cmArchiveWrite::BlockCompressor::BlockCompressor(std::ostream& os,
+                                                 Compress c, int threads)
+  : Stream(os)
+  , Compression(c)
+  , BlockSize(c == CompressXZ ? 3 * (8 << 20) : 1 << 20)
+{
+  size_t const maxPendingSize = 256 << 20;
+  size_t n = threads > 0 ? static_cast<size_t>(threads)
+                         : cmWorkerPool::GetHardwareThreads();
+  this->MaxPending = std::min(2 * n, maxPendingSize / this->BlockSize);
+  n = std::min(n, this->MaxPending);
+  this->Pool =
+    cm::make_unique<cmWorkerPool>(static_cast<unsigned int>(n), n);
+  this->Data.reserve(this->BlockSize);
+}
+
+bool cmArchiveWrite::BlockCompressor::Write(const char* data, size_t n)
+{
+  while (n > 0 && this->Error.empty()) {
+    size_t const room = this->BlockSize - this->Data.size();
+    size_t const next = std::min(n, room);
+    this->Data.append(data, next);
+    data += next;
+    n -= next;
+    if (this->Data.size() == this->BlockSize) {
+      this->Post();
+      if (this->Pending.size() >= this->MaxPending) {
+        this->WriteFront();
+      }
+    }
+  }
+  return this->Error.empty();
+}
+
+bool cmArchiveWrite::BlockCompressor::Finish()
+{
+  if (!this->Data.empty()) {
+    this->Post();
+  }
+  while (!this->Pending.empty() && this->Error.empty()) {
+    this->WriteFront();
+  }
+  return this->Error.empty();
+}
+
+void cmArchiveWrite::BlockCompressor::Post()
+{
+  std::unique_ptr<Block> block = cm::make_unique<Block>();
+  block->Data.swap(this->Data);
+  block->Ready = block->Done.get_future();
+  this->Data.reserve(this->BlockSize);
+
+  Block* b = block.get();
+  Compress const c = this->Compression;
+  this->Pending.push_back(std::move(block));
+  this->Pool->Post([b, c]() {
+    CompressBlock(c, *b);
+    b->Done.set_value();
+  });
+}
+
+void cmArchiveWrite::BlockCompressor::WriteFront()
+{
+  std::unique_ptr<Block> block = std::move(this->Pending.front());
+  this->Pending.pop_front();
+  block->Ready.wait();
+  if (!block->Error.empty()) {
+    this->Error = block->Error;
+  } else if (!this->Stream.write(
+               block->Output.data(),
+               static_cast<std::streamsize>(block->Output.size()))) {
+    this->Error = "Error writing compressed data: ";
+    this->Error += cmSystemTools::GetLastSystemError();
+  }
+}
+
+void cmArchiveWrite::BlockCompressor::CompressBlock(Compress c, Block& block)
+{
+  struct archive* a = archive_write_new();
+  int r = archive_write_set_format_raw(a);
+  if (r == ARCHIVE_OK) {
+    r = c == CompressXZ ? archive_write_add_filter_xz(a)
+                        : archive_write_add_filter_gzip(a);
+  }
+  if (r == ARCHIVE_OK && c == CompressGZip) {
+    // Leave the time out of the gzip header so that the output depends
+    // only on the data.
+    r = archive_write_set_filter_option(a, "gzip", "timestamp", nullptr);
+  }
+  if (r == ARCHIVE_OK) {
+    r = archive_write_set_bytes_in_last_block(a, 1);
+  }
+  if (r == ARCHIVE_OK) {
+    r = archive_write_open(
+      a, &block.Output, nullptr,
+      reinterpret_cast<archive_write_callback*>(&BlockCompressor::Output),
+      nullptr);
+  }
+  if (r == ARCHIVE_OK) {
+    Entry e;
+    archive_entry_set_filetype(e, AE_IFREG);
+    r = archive_write_header(a, e);
+  }
+  if (r == ARCHIVE_OK &&
+      archive_write_data(a, block.Data.data(), block.Data.size()) !=
+        static_cast<__LA_SSIZE_T>(block.Data.size())) {
+    r = ARCHIVE_FATAL;
+  }
+  if (r == ARCHIVE_OK) {
+    r = archive_write_close(a);
+  }
+  if (r != ARCHIVE_OK) {
+    block.Error = "compressing block: ";
+    block.Error += cm_archive_error_string(a);
+  }
+  archive_write_free(a);
+  std::string().swap(block.Data);
+}
+
+__LA_SSIZE_T cmArchiveWrite::BlockCompressor::Output(struct archive* /*a*/,
+                                                     void* cd, const void* b,
+                                                     size_t n)
+{
+  static_cast<std::string*>(cd)->append(static_cast<const char*>(b), n);
+  return static_cast<__LA_SSIZE_T>(n);
+}
+
+// Compress the archive as one zstd frame.  The library compresses it on
+// worker threads if asked to and built with support for them.
+class cmArchiveWrite::ZstdCompressor : public cmArchiveWrite::Compressor
+{
+public:
+  ZstdCompressor(std::ostream& os, int level, int threads);
+  ~ZstdCompressor() override;
+
+  bool Write(const char* data, size_t n) override;
+  bool Finish() override;
+
+private:
+  bool Process(ZSTD_inBuffer& in, ZSTD_EndDirective mode);
+
+  std::ostream& Stream;
+  ZSTD_CCtx* Context;
+  std::vector<char> Buffer;
+};
+
+cmArchiveWrite::ZstdCompressor::ZstdCompressor(std::ostream& os, int level,
+                                               int threads)
+  : Stream(os)
+  , Context(ZSTD_createCCtx())
+  , Buffer(ZSTD_CStreamOutSize())
+{
+  if (!this->Context) {
+    this->Error = "ZSTD_createCCtx failed";
+    return;
+  }
+  size_t const r = ZSTD_CCtx_setParameter(
+    this->Context, ZSTD_c_compressionLevel,
+    level != 0 ? level : ZSTD_CLEVEL_DEFAULT);
+  if (ZSTD_isError(r)) {
+    this->Error = "ZSTD_CCtx_setParameter: ";
+    this->Error += ZSTD_getErrorName(r);
+    return;
+  }
+  ZSTD_CCtx_setParameter(this->Context, ZSTD_c_checksumFlag, 1);
+  if (threads >= 0) {
+    // This fails, and leaves compression on the calling thread, if the
+    // library has no support for worker threads.
+    int const n = threads > 0
+      ? threads
+      : static_cast<int>(cmWorkerPool::GetHardwareThreads());
+    ZSTD_CCtx_setParameter(this->Context, ZSTD_c_nbWorkers, n);
+  }
+}
+
+cmArchiveWrite::ZstdCompressor::~ZstdCompressor()
+{
+  ZSTD_freeCCtx(this->Context);
+}
+
+bool cmArchiveWrite::ZstdCompressor::Write(const char* data, size_t n)
+{
+  ZSTD_inBuffer in = { data, n, 0 };
+  return this->Process(in, ZSTD_e_continue);
+}
+
+bool cmArchiveWrite::ZstdCompressor::Finish()
+{
+  ZSTD_inBuffer in = { nullptr, 0, 0 };
+  return this->Process(in, ZSTD_e_end);
+}
+
+bool cmArchiveWrite::ZstdCompressor::Process(ZSTD_inBuffer& in,
+                                             ZSTD_EndDirective mode)
+{
+  if (!this->Error.empty()) {
+    return false;
+  }
+  for (;;) {
+    ZSTD_outBuffer out = { this->Buffer.data(), this->Buffer.size(), 0 };
+    size_t const r = ZSTD_compressStream2(this->Context, &out, &in, mode);
+    if (ZSTD_isError(r)) {
+      this->Error = "ZSTD_compressStream2: ";
+      this->Error += ZSTD_getErrorName(r);
+      return false;
+    }
+    if (out.pos > 0 &&
+        !this->Stream.write(this->Buffer.data(),
+                            static_cast<std::streamsize>(out.pos))) {
+      this->Error = "Error writing compressed data: ";
+      this->Error += cmSystemTools::GetLastSystemError();
+      return false;
+    }
+    // Ending the frame is done when nothing is left to flush.
+    if (mode == ZSTD_e_end ? r == 0 : in.pos == in.size) {
+      return true;
+    }
+  }
+}
+
 struct cmArchiveWrite::Callback
 {
   // archive_write_callback
-  static __LA_SSIZE_T Write(struct archive* /*unused*/, void* cd,
-                            const void* b, size_t n)
+  static __LA_SSIZE_T Write(struct archive* a, void* cd, const void* b,
+                            size_t n)
   {
     cmArchiveWrite* self = static_cast<cmArchiveWrite*>(cd);
+    if (self->Compression) {
+      if (self->Compression->Write(static_cast<const char*>(b), n)) {
+        return static_cast<__LA_SSIZE_T>(n);
+      }
+      archive_set_error(a, -1, "%s",
+                        self->Compression->GetError().c_str());
+      return static_cast<__LA_SSIZE_T>(-1);
+    }
     if (self->Stream.write(static_cast<const char*>(b),
                            static_cast<std::streamsize>(n))) {
       return static_cast<__LA_SSIZE_T>(n);
     }
     return static_cast<__LA_SSIZE_T>(-1);
   }
+
+  // archive_close_callback
+  static int Close(struct archive* a, void* cd)
+  {
+    cmArchiveWrite* self = static_cast<cmArchiveWrite*>(cd);
+    if (self->Compression && !self->Compression->Finish()) {
+      archive_set_error(a, -1, "%s",
+                        self->Compression->GetError().c_str());
+      return ARCHIVE_FATAL;
+    }
+    return ARCHIVE_OK;
+  }
 };
 
 cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c,
-                               std::string const& format)
+                               std::string const& format, int threads,
+                               int compressionLevel)
   : Stream(os)
   , Archive(archive_write_new())
   , Disk(archive_read_disk_new())
   , Verbose(false)
   , Format(format)
 {
+  // Compress zstd, and gzip or xz in blocks on worker threads, on our
+  // own and let libarchive write the archive uncompressed to them.
+  if (c == CompressZstd) {
+    this->Compression =
+      cm::make_unique<ZstdCompressor>(os, compressionLevel, threads);
+  } else if (threads >= 0 && (c == CompressGZip || c == CompressXZ)) {
+    this->Compression = cm::make_unique<BlockCompressor>(os, c, threads);
+  }
+  if (this->Compression) {
+    if (!this->Compression->GetError().empty()) {
+      this->Error = this->Compression->GetError();
+      return;
+    }
+    c = CompressNone;
+  }
+
   switch (c) {
     case CompressNone:
+    case CompressZstd:
       if (archive_write_add_filter_none(this->Archive) != ARCHIVE_OK) {
         this->Error = "archive_write_add_filter_none: ";
         this->Error += cm_archive_error_string(this->Archive);
@@ -148,7 +469,7 @@ cmArchiveWrite::cmArchiveWrite(std::ostream& os, Compress c,
   if (archive_write_open(
         this->Archive, this, nullptr,
         reinterpret_cast<archive_write_callback*>(&Callback::Write),
-        nullptr) != ARCHIVE_OK) {
+        &Callback::Close) != ARCHIVE_OK) {
     this->Error = "archive_write_open: ";
     this->Error += cm_archive_error_string(this->Archive);
     return;
@@ -6,6 +6,7 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <iosfwd>
+#include <memory>
 #include <stddef.h>
 #include <string>
 
@@ -50,12 +51,24 @@ public:
     CompressGZip,
     CompressBZip2,
     CompressLZMA,
-    CompressXZ
+    CompressXZ,
+    CompressZstd
   };
 
-  /** Construct with output stream to which to write archive.  */
+  /**
+   * Construct with output stream to which to write archive.  Given a
+   * number of threads that is not negative, gzip and xz compression
+   * splits the archive into blocks of fixed size and compresses them on
+   * that many threads, or on one thread per processor if the number is
+   * 0.  Zstd compression uses that many worker threads instead.  The
+   * output is the same for any such number of threads.  A negative
+   * number compresses on the calling thread as one stream.  A non-zero
+   * compression level selects the zstd level; others use their default
+   * level.
+   */
   cmArchiveWrite(std::ostream& os, Compress c = CompressNone,
-                 std::string const& format = "paxr");
+                 std::string const& format = "paxr", int threads = -1,
+                 int compressionLevel = 0);
 
   ~cmArchiveWrite();
 
@@ -150,8 +163,12 @@ private:
   friend struct Callback;
 
   class Entry;
+  class Compressor;
+  class BlockCompressor;
+  class ZstdCompressor;
 
   std::ostream& Stream;
+  std::unique_ptr<Compressor> Compression;
   struct archive* Archive;
   struct archive* Disk;
   bool Verbose;
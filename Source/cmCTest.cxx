@@ -289,6 +289,8 @@ cmCTest::cmCTest()
   this->OutputTestOutputOnTestFailure = false;
   this->RepeatTests = 1; // default to run each test once
   this->RepeatUntilFail = false;
+  this->RepeatUntilPass = false;
+  this->StopOnFailure = false;
   std::string outOnFail;
   if (cmSystemTools::GetEnv("CTEST_OUTPUT_ON_FAILURE", outOnFail)) {
     this->OutputTestOutputOnTestFailure =
@@ -1722,24 +1724,37 @@ bool cmCTest::HandleCommandLineArguments(size_t& i,
     this->SetParallelLevel(plevel);
     this->ParallelLevelSetInCli = true;
   }
-  if (this->CheckArgument(arg, "--repeat-until-fail")) {
+  if (this->CheckArgument(arg, "--repeat-until-fail") ||
+      this->CheckArgument(arg, "--repeat-until-pass")) {
     if (i >= args.size() - 1) {
-      errormsg = "'--repeat-until-fail' requires an argument";
+      errormsg = "'" + arg + "' requires an argument";
+      return false;
+    }
+    if (this->RepeatUntilFail || this->RepeatUntilPass) {
+      errormsg = "At most one of '--repeat-until-fail' and "
+                 "'--repeat-until-pass' may be given";
       return false;
     }
     i++;
     long repeat = 1;
     if (!cmSystemTools::StringToLong(args[i].c_str(), &repeat)) {
-      errormsg =
-        "'--repeat-until-fail' given non-integer value '" + args[i] + "'";
+      errormsg = "'" + arg + "' given non-integer value '" + args[i] + "'";
       return false;
     }
     this->RepeatTests = static_cast<int>(repeat);
     if (repeat > 1) {
-      this->RepeatUntilFail = true;
+      if (arg == "--repeat-until-fail") {
+        this->RepeatUntilFail = true;
+      } else {
+        this->RepeatUntilPass = true;
+      }
     }
   }
 
+  if (this->CheckArgument(arg, "--stop-on-failure")) {
+    this->StopOnFailure = true;
+  }
+
   if (this->CheckArgument(arg, "--test-load") && i < args.size() - 1) {
     i++;
     unsigned long load;
@@ -1960,6 +1975,13 @@ bool cmCTest::HandleCommandLineArguments(size_t& i,
     this->GetHandler("test")->SetPersistentOption("RerunFailed", "true");
     this->GetHandler("memcheck")->SetPersistentOption("RerunFailed", "true");
   }
+  if (this->CheckArgument(arg, "--changed-since") && i < args.size() - 1) {
+    i++;
+    this->GetHandler("test")->SetPersistentOption("ChangedSince",
+                                                  args[i].c_str());
+    this->GetHandler("memcheck")
+      ->SetPersistentOption("ChangedSince", args[i].c_str());
+  }
   return true;
 }
 
@@ -2706,6 +2728,7 @@ void cmCTest::Log(int logType, const char* file, int line, const char* msg,
       (this->Debug || this->ExtraVerbose)) {
     return;
   }
+  std::lock_guard<std::mutex> lock(this->LogMutex);
   if (this->OutputLogFile) {
     bool display = true;
     if (logType == cmCTest::DEBUG && !this->Debug) {
@@ -10,6 +10,7 @@
 #include "cmsys/String.hxx"
 #include <chrono>
 #include <map>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
@@ -455,6 +456,12 @@ public:
   /** Return true if test should run until fail */
   bool GetRepeatUntilFail() { return this->RepeatUntilFail; }
 
+  /** Return true if a failing test should be run again until it passes */
+  bool GetRepeatUntilPass() { return this->RepeatUntilPass; }
+
+  /** Return true if testing should stop after the first failure */
+  bool GetStopOnFailure() { return this->StopOnFailure; }
+
   void GenerateSubprojectsOutput(cmXMLWriter& xml);
   std::vector<std::string> GetLabelsForSubprojects();
 
@@ -463,6 +470,8 @@ public:
 private:
   int RepeatTests;
   bool RepeatUntilFail;
+  bool RepeatUntilPass;
+  bool StopOnFailure;
   std::string ConfigType;
   std::string ScheduleType;
   std::chrono::system_clock::time_point StopTime;
@@ -603,6 +612,8 @@ private:
 
   cmGeneratedFileStream* OutputLogFile;
   int OutputLogFileLastTag;
+  // Serializes Log calls made from handler worker threads.
+  std::mutex LogMutex;
 
   bool OutputTestOutputOnTestFailure;
 
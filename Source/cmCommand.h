@@ -74,6 +74,12 @@ public:
    */
   virtual bool HasFinalPass() const { return false; }
 
+  /**
+   * Does this command write files or run processes?  The find commands
+   * check the directories they look in for changes after such a command.
+   */
+  virtual bool WritesFiles() const { return false; }
+
   /**
    * This is a virtual constructor for the command.
    */
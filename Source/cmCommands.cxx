@@ -74,6 +74,7 @@
 #include "cmTargetIncludeDirectoriesCommand.h"
 #include "cmTargetLinkLibrariesCommand.h"
 #include "cmTargetSourcesCommand.h"
+#include "cmTryCompileBatchCommand.h"
 #include "cmTryCompileCommand.h"
 #include "cmTryRunCommand.h"
 #include "cmUnsetCommand.h"
@@ -250,6 +251,8 @@ void GetProjectCommands(cmState* state)
                            new cmTargetLinkLibrariesCommand);
   state->AddBuiltinCommand("target_sources", new cmTargetSourcesCommand);
   state->AddBuiltinCommand("try_compile", new cmTryCompileCommand);
+  state->AddBuiltinCommand("try_compile_batch",
+                           new cmTryCompileBatchCommand);
   state->AddBuiltinCommand("try_run", new cmTryRunCommand);
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
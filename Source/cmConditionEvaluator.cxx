@@ -2,7 +2,6 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmConditionEvaluator.h"
 
-#include "cmsys/RegularExpression.hxx"
 #include <algorithm>
 #include <sstream>
 #include <stdio.h>
@@ -11,6 +10,7 @@
 
 #include "cmAlgorithms.h"
 #include "cmMakefile.h"
+#include "cmRegularExpression.h"
 #include "cmState.h"
 #include "cmSystemTools.h"
 
@@ -536,7 +536,7 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
         }
         const char* rex = argP2->c_str();
         this->Makefile.ClearMatches();
-        cmsys::RegularExpression regEntry;
+        cmRegularExpression regEntry;
         if (!regEntry.compile(rex)) {
           std::ostringstream error;
           error << "Regular expression \"" << rex << "\" cannot compile";
@@ -3,6 +3,13 @@
 #include "cmCoreTryCompile.h"
 
 #include "cmsys/Directory.hxx"
+#include "cmsys/FStream.hxx"
+#include "cmsys/RegularExpression.hxx"
+#include <algorithm>
+#include <ios>
+#include <iterator>
+#include <map>
+#include <memory> // IWYU pragma: keep
 #include <set>
 #include <sstream>
 #include <stdio.h>
@@ -10,11 +17,14 @@
 #include <utility>
 
 #include "cmAlgorithms.h"
+#include "cmCryptoHash.h"
 #include "cmExportTryCompileFileGenerator.h"
 #include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmOutputConverter.h"
 #include "cmPolicies.h"
+#include "cmRulePlaceholderExpander.h"
 #include "cmState.h"
 #include "cmSystemTools.h"
 #include "cmTarget.h"
@@ -74,6 +84,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   this->OutputFile.clear();
   // which signature were we called with ?
   this->SrcFileSignature = true;
+  this->Deferred = false;
 
   cmStateEnums::TargetType targetType = cmStateEnums::EXECUTABLE;
   const char* tt =
@@ -118,6 +129,8 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   std::string cxxExtensions;
   std::string cudaExtensions;
   std::vector<std::string> targets;
+  std::vector<std::string> linkLibraries;
+  bool linkTargets = false;
   std::string libsToLink = " ";
   bool useOldLinkLibs = true;
   char targetNameBuf[64];
@@ -207,7 +220,9 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       compileDefs.push_back(argv[i]);
     } else if (doing == DoingLinkLibraries) {
       libsToLink += "\"" + cmSystemTools::TrimWhitespace(argv[i]) + "\" ";
+      linkLibraries.push_back(cmSystemTools::TrimWhitespace(argv[i]));
       if (cmTarget* tgt = this->Makefile->FindTargetToUse(argv[i])) {
+        linkTargets = true;
         switch (tgt->GetType()) {
           case cmStateEnums::SHARED_LIBRARY:
           case cmStateEnums::STATIC_LIBRARY:
@@ -370,9 +385,42 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     return -1;
   }
 
+  // An open try_compile_batch defers source file signatures that need
+  // nothing but the result.  CMAKE_FLAGS other than definitions of
+  // project variables may change the whole test project, so calls
+  // using them still run right away.
+  cmTryCompileBatch* batch = this->Makefile->GetTryCompileBatch();
+  size_t const userFlagCount = cmakeFlags.size();
+  if (batch && this->SrcFileSignature && !isTryRun && copyFile.empty()) {
+    this->Deferred = std::all_of(
+      cmakeFlags.begin() + 1, cmakeFlags.end(), [](std::string const& flag) {
+        // Arguments that are not options cmake::SetCacheArgs knows are
+        // ignored by the test project.
+        if (cmHasLiteralPrefix(flag, "-D")) {
+          return !cmHasLiteralPrefix(flag, "-DCMAKE_");
+        }
+        return !cmHasLiteralPrefix(flag, "-U") &&
+          !cmHasLiteralPrefix(flag, "-C") && !cmHasLiteralPrefix(flag, "-P") &&
+          !cmHasLiteralPrefix(flag, "-W") &&
+          !cmHasLiteralPrefix(flag, "--find-package");
+      });
+  }
+
+  // Sources under this directory are written by the calling check and
+  // may be overwritten by the next one.
+  std::string const tempDir =
+    argv[1] + cmake::GetCMakeFilesDirectory() + "/CMakeTmp";
+
   // compute the binary dir when TRY_COMPILE is called with a src file
   // signature
-  if (this->SrcFileSignature) {
+  if (this->Deferred) {
+    do {
+      sprintf(targetNameBuf, "cmTC_%05x",
+              cmSystemTools::RandomSeed() & 0xFFFFF);
+      targetName = targetNameBuf;
+      this->BinaryDirectory = batch->Directory + "/" + targetName;
+    } while (cmSystemTools::FileExists(this->BinaryDirectory));
+  } else if (this->SrcFileSignature) {
     this->BinaryDirectory += cmake::GetCMakeFilesDirectory();
     this->BinaryDirectory += "/CMakeTmp";
   } else {
@@ -403,6 +451,9 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   }
 
   std::string outFileName = this->BinaryDirectory + "/CMakeLists.txt";
+  std::string resultCacheFile;
+  std::string directLang;
+  std::string directSource;
   // which signature are we using? If we are using var srcfile bindir
   if (this->SrcFileSignature) {
     // remove any CMakeCache.txt files so we will have a clean test
@@ -414,6 +465,19 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       sources.push_back(argv[2]);
     }
 
+    // Later checks may overwrite temporary sources before a deferred
+    // check is built, so it gets copies of them.
+    if (this->Deferred) {
+      for (std::string& si : sources) {
+        if (cmSystemTools::IsSubDirectory(si, tempDir)) {
+          std::string copy =
+            this->BinaryDirectory + "/" + cmSystemTools::GetFilenameName(si);
+          cmSystemTools::CopyFileAlways(si, copy);
+          si = std::move(copy);
+        }
+      }
+    }
+
     // Detect languages to enable.
     cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
     std::set<std::string> testLangs;
@@ -464,6 +528,22 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     if (def) {
       fprintf(fout, "set(CMAKE_MODULE_PATH \"%s\")\n", def);
     }
+    if (this->Deferred) {
+      // The batch shares one cache, so definitions from CMAKE_FLAGS
+      // become variables of this directory instead.
+      for (auto fi = cmakeFlags.begin() + 1; fi != cmakeFlags.end(); ++fi) {
+        if (!cmHasLiteralPrefix(*fi, "-D")) {
+          continue;
+        }
+        std::string::size_type const eq = fi->find('=');
+        std::string var = fi->substr(2, eq == std::string::npos ? eq : eq - 2);
+        var = var.substr(0, var.find(':'));
+        std::string const val =
+          eq == std::string::npos ? std::string() : fi->substr(eq + 1);
+        fprintf(fout, "set(%s %s)\n", var.c_str(),
+                cmOutputConverter::EscapeForCMake(val).c_str());
+      }
+    }
 
     std::string projectLangs;
     for (std::string const& li : testLangs) {
@@ -575,8 +655,11 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
 
     /* Use a random file name to avoid rapid creation and deletion
        of the same executable name (some filesystems fail on that).  */
-    sprintf(targetNameBuf, "cmTC_%05x", cmSystemTools::RandomSeed() & 0xFFFFF);
-    targetName = targetNameBuf;
+    if (targetName.empty()) {
+      sprintf(targetNameBuf, "cmTC_%05x",
+              cmSystemTools::RandomSeed() & 0xFFFFF);
+      targetName = targetNameBuf;
+    }
 
     if (!targets.empty()) {
       std::string fname = "/" + std::string(targetName) + "Targets.cmake";
@@ -668,7 +751,8 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       fprintf(fout, " \"%s\"", si.c_str());
 
       // Add dependencies on any non-temporary sources.
-      if (si.find("CMakeTmp") == std::string::npos) {
+      if (!cmSystemTools::IsSubDirectory(si, tempDir) &&
+          !cmSystemTools::IsSubDirectory(si, this->BinaryDirectory)) {
         this->Makefile->AddCMakeDependFile(si);
       }
     }
@@ -810,15 +894,78 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     }
     fclose(fout);
     projectName = "CMAKE_TRY_COMPILE";
+
+    // Only the result of a build can be cached, not its files.
+    if (!isTryRun && copyFile.empty() && copyFileError.empty()) {
+      resultCacheFile =
+        this->GetResultCacheFile(targetName, sources, testLangs, cmakeFlags);
+    }
+
+    // A single source without language standard or imported targets may
+    // be built without the test project.
+    if (!isTryRun && copyFile.empty() && copyFileError.empty() &&
+        !this->Deferred && sources.size() == 1 && testLangs.size() == 1 &&
+        !linkTargets && cStandard.empty() && cStandardRequired.empty() &&
+        cExtensions.empty() && cxxStandard.empty() &&
+        cxxStandardRequired.empty() && cxxExtensions.empty() &&
+        this->Makefile->IsOn("CMAKE_TRY_COMPILE_DIRECT")) {
+      directLang = *testLangs.begin();
+      directSource = sources.front();
+    }
+  }
+
+  if (!resultCacheFile.empty() &&
+      !this->Makefile->GetCMakeInstance()->GetDebugTryCompile()) {
+    int res;
+    std::string output;
+    if (this->LoadCachedResult(resultCacheFile, res, output)) {
+      this->Deferred = false;
+      this->Makefile->AddCacheDefinition(
+        argv[0], (res == 0 ? "TRUE" : "FALSE"), "Result of TRY_COMPILE",
+        cmStateEnums::INTERNAL);
+      if (!outputVariable.empty()) {
+        output = "Result loaded from try_compile cache file\n  " +
+          resultCacheFile + "\n\n" + output;
+        this->Makefile->AddDefinition(outputVariable, output.c_str());
+      }
+      return res;
+    }
+  }
+
+  if (this->Deferred) {
+    cmTryCompileBatch::Entry entry;
+    entry.ResultVariable = argv[0];
+    entry.OutputVariable = outputVariable;
+    entry.BinaryDirectory = this->BinaryDirectory;
+    entry.TargetName = targetName;
+    entry.CMakeFlags = cmakeFlags;
+    entry.ForwardedFlags.assign(cmakeFlags.begin() + userFlagCount,
+                                cmakeFlags.end());
+    entry.ResultCacheFile = resultCacheFile;
+    batch->Entries.push_back(std::move(entry));
+    return 0;
   }
 
   bool erroroc = cmSystemTools::GetErrorOccuredFlag();
   cmSystemTools::ResetErrorOccuredFlag();
   std::string output;
   // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(
-    sourceDirectory, this->BinaryDirectory, projectName, targetName,
-    this->SrcFileSignature, &cmakeFlags, output);
+  int res;
+  if (directLang.empty() ||
+      !this->TryCompileDirect(directLang, directSource, targetName,
+                              targetType, compileDefs, cmakeFlags,
+                              useOldLinkLibs ? nullptr : &linkLibraries, res,
+                              output)) {
+    res = this->Makefile->TryCompile(sourceDirectory, this->BinaryDirectory,
+                                     projectName, targetName,
+                                     this->SrcFileSignature, &cmakeFlags,
+                                     output);
+  }
+  // A test project that failed to configure does not tell anything
+  // about the code, so its result is not cached.
+  if (!resultCacheFile.empty() && !cmSystemTools::GetErrorOccuredFlag()) {
+    this->StoreCachedResult(resultCacheFile, res, output);
+  }
   if (erroroc) {
     cmSystemTools::SetErrorOccured();
   }
@@ -865,6 +1012,387 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   return res;
 }
 
+bool cmCoreTryCompile::TryCompileDirect(
+  std::string const& lang, std::string const& source,
+  std::string const& targetName, cmStateEnums::TargetType targetType,
+  std::vector<std::string> const& compileDefs,
+  std::vector<std::string> const& cmakeFlags,
+  std::vector<std::string> const* linkLibraries, int& res,
+  std::string& output)
+{
+  // The rules are run by a POSIX shell.  Multi-configuration generators
+  // and those using other shells do not build with these rules.
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+  cmState* state = this->Makefile->GetState();
+  if ((lang != "C" && lang != "CXX") || gg->IsMultiConfig() ||
+      state->UseWindowsShell() || state->UseMSYSShell()) {
+    return false;
+  }
+
+  // The test project would choose its own configuration and rules.
+  if (*this->Makefile->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION") ||
+      *this->Makefile->GetSafeDefinition("CMAKE_BUILD_TYPE_INIT") ||
+      this->Makefile->GetDefinition("CMAKE_USER_MAKE_RULES_OVERRIDE") ||
+      this->Makefile->GetDefinition("CMAKE_USER_MAKE_RULES_OVERRIDE_" +
+                                    lang) ||
+      this->Makefile->GetPolicyStatus(cmPolicies::CMP0056) !=
+        cmPolicies::NEW) {
+    return false;
+  }
+
+  // Only the variables the generated CMakeLists.txt uses may be given.
+  std::map<std::string, std::string> vars;
+  for (auto fi = cmakeFlags.begin() + 1; fi != cmakeFlags.end(); ++fi) {
+    if (cmHasLiteralPrefix(*fi, "-D")) {
+      std::string var;
+      std::string value;
+      cmStateEnums::CacheEntryType type = cmStateEnums::UNINITIALIZED;
+      if (!cmState::ParseCacheEntry(fi->substr(2), var, value, type) ||
+          type == cmStateEnums::PATH || type == cmStateEnums::FILEPATH) {
+        return false;
+      }
+      if (var != "COMPILE_DEFINITIONS" && var != "INCLUDE_DIRECTORIES" &&
+          var != "LINK_DIRECTORIES" && var != "LINK_LIBRARIES" &&
+          var != "EXE_LINKER_FLAGS" && var != "CMAKE_WARN_DEPRECATED") {
+        return false;
+      }
+      vars[var] = value;
+    } else if (cmHasLiteralPrefix(*fi, "-U") ||
+               cmHasLiteralPrefix(*fi, "-C") ||
+               cmHasLiteralPrefix(*fi, "-P") ||
+               cmHasLiteralPrefix(*fi, "-W") ||
+               cmHasLiteralPrefix(*fi, "--find-package")) {
+      return false;
+    }
+  }
+
+  // add_definitions() splits definitions the CMake language would
+  // change.  Leave those to the test project.
+  static cmsys::RegularExpression defineRegex(
+    "^[-/]D[A-Za-z_][A-Za-z0-9_]*(=.*)?$");
+  std::set<std::string> defines;
+  std::string defineFlags;
+  for (std::string const& def : compileDefs) {
+    if (def.find_first_of(" \t\r\n\"#$;()\\") != std::string::npos) {
+      return false;
+    }
+    if (defineRegex.find(def)) {
+      defines.insert(def.substr(2));
+    } else if (!def.empty()) {
+      defineFlags += " " + def;
+    }
+  }
+
+  // Library names are turned into link flags.  Anything else a target
+  // could link to is left to the test project.
+  std::vector<std::string> libraries;
+  if (linkLibraries) {
+    libraries = *linkLibraries;
+  } else {
+    cmSystemTools::ExpandListArgument(vars["LINK_LIBRARIES"], libraries);
+  }
+  for (std::string const& lib : libraries) {
+    if (lib == "debug" || lib == "optimized" || lib == "general" ||
+        (lib[0] != '-' && !cmSystemTools::FileIsFullPath(lib) &&
+         lib.find_first_of("/.$<") != std::string::npos)) {
+      return false;
+    }
+  }
+
+  std::string const compileRuleVar = "CMAKE_" + lang + "_COMPILE_OBJECT";
+  std::string const linkRuleVar = "CMAKE_" + lang + "_LINK_EXECUTABLE";
+  std::string const includeFlagVar = "CMAKE_INCLUDE_FLAG_" + lang;
+  if (!this->Makefile->GetDefinition(compileRuleVar) ||
+      !this->Makefile->GetDefinition(linkRuleVar) ||
+      (!vars["INCLUDE_DIRECTORIES"].empty() &&
+       !this->Makefile->GetDefinition(includeFlagVar))) {
+    return false;
+  }
+
+  cmLocalGenerator lg(gg, this->Makefile);
+  std::unique_ptr<cmRulePlaceholderExpander> expander(
+    lg.CreateRulePlaceholderExpander());
+
+  // Compile and link flags as the test project would compute them.
+  std::string flags = this->Makefile->GetSafeDefinition("CMAKE_" + lang +
+                                                        "_FLAGS");
+  lg.AppendFlags(flags, vars["COMPILE_DEFINITIONS"]);
+  std::string compileFlags = flags;
+  lg.AppendFlags(compileFlags, defineFlags);
+
+  std::string definesString;
+  lg.JoinDefines(defines, definesString, lang);
+
+  std::vector<std::string> includes;
+  {
+    std::vector<std::string> dirs;
+    cmSystemTools::ExpandListArgument(vars["INCLUDE_DIRECTORIES"], dirs);
+    std::vector<std::string> implicitDirs;
+    cmSystemTools::ExpandListArgument(
+      this->Makefile->GetSafeDefinition("CMAKE_" + lang +
+                                        "_IMPLICIT_INCLUDE_DIRECTORIES"),
+      implicitDirs);
+    for (std::string const& dir : dirs) {
+      std::string const full =
+        cmSystemTools::CollapseFullPath(dir, this->BinaryDirectory);
+      if (std::find(implicitDirs.begin(), implicitDirs.end(), full) ==
+          implicitDirs.end()) {
+        includes.push_back(full);
+      }
+    }
+  }
+  std::string const includesString =
+    lg.GetIncludeFlags(includes, nullptr, lang, true);
+
+  std::string linkFlags =
+    this->Makefile->GetSafeDefinition("CMAKE_EXE_LINKER_FLAGS");
+  lg.AppendFlags(linkFlags, vars["EXE_LINKER_FLAGS"]);
+  lg.AppendFlags(linkFlags,
+                 this->Makefile->GetDefinition("CMAKE_CREATE_CONSOLE_EXE"));
+  if (this->Makefile->GetPolicyStatus(cmPolicies::CMP0065) !=
+        cmPolicies::NEW &&
+      state->GetGlobalPropertyAsBool("TARGET_SUPPORTS_SHARED_LIBS")) {
+    lg.AppendFlags(linkFlags, this->Makefile->GetDefinition(
+                                "CMAKE_SHARED_LIBRARY_LINK_" + lang +
+                                "_FLAGS"));
+  }
+
+  std::string linkLibs;
+  {
+    std::vector<std::string> dirs;
+    cmSystemTools::ExpandListArgument(vars["LINK_DIRECTORIES"], dirs);
+    std::string const pathFlag =
+      this->Makefile->GetSafeDefinition("CMAKE_LIBRARY_PATH_FLAG");
+    for (std::string const& dir : dirs) {
+      linkLibs += pathFlag;
+      linkLibs += lg.ConvertToOutputFormat(
+        cmSystemTools::CollapseFullPath(dir, this->BinaryDirectory),
+        cmOutputConverter::SHELL);
+      linkLibs += " ";
+    }
+    std::string const libFlag =
+      this->Makefile->GetSafeDefinition("CMAKE_LINK_LIBRARY_FLAG");
+    for (std::string const& lib : libraries) {
+      if (lib[0] == '-') {
+        linkLibs += lib;
+      } else if (cmSystemTools::FileIsFullPath(lib)) {
+        linkLibs += lg.ConvertToOutputFormat(lib, cmOutputConverter::SHELL);
+      } else {
+        linkLibs += libFlag + lib;
+      }
+      linkLibs += " ";
+    }
+    linkLibs += this->Makefile->GetSafeDefinition("CMAKE_" + lang +
+                                                  "_STANDARD_LIBRARIES");
+  }
+
+  std::string const objectDir = this->BinaryDirectory +
+    cmake::GetCMakeFilesDirectory() + "/" + targetName + ".dir";
+  std::string const object = objectDir + "/" +
+    cmSystemTools::GetFilenameName(source) +
+    this->Makefile->GetSafeDefinition("CMAKE_" + lang + "_OUTPUT_EXTENSION");
+  std::string const executable = this->BinaryDirectory + "/" + targetName +
+    this->Makefile->GetSafeDefinition("CMAKE_EXECUTABLE_SUFFIX");
+  cmSystemTools::MakeDirectory(objectDir);
+
+  std::string const shellSource =
+    lg.ConvertToOutputFormat(source, cmOutputConverter::SHELL);
+  std::string const shellObject =
+    lg.ConvertToOutputFormat(object, cmOutputConverter::SHELL);
+  std::string const shellObjectDir =
+    lg.ConvertToOutputFormat(objectDir, cmOutputConverter::SHELL);
+  std::string const shellExecutable =
+    lg.ConvertToOutputFormat(executable, cmOutputConverter::SHELL);
+
+  cmRulePlaceholderExpander::RuleVariables ruleVars;
+  ruleVars.CMTargetName = targetName.c_str();
+  ruleVars.CMTargetType = cmState::GetTargetTypeName(targetType);
+  ruleVars.Language = lang.c_str();
+  ruleVars.Source = shellSource.c_str();
+  ruleVars.Object = shellObject.c_str();
+  ruleVars.ObjectDir = shellObjectDir.c_str();
+  ruleVars.ObjectFileDir = shellObjectDir.c_str();
+  ruleVars.Flags = compileFlags.c_str();
+  ruleVars.Defines = definesString.c_str();
+  ruleVars.Includes = includesString.c_str();
+
+  std::vector<std::string> commands;
+  cmSystemTools::ExpandListArgument(
+    this->Makefile->GetSafeDefinition(compileRuleVar), commands);
+  for (std::string& command : commands) {
+    expander->ExpandRuleVariables(&lg, command, ruleVars);
+  }
+  // A static library is built from the object unconditionally, so the
+  // object tells the result.
+  if (targetType == cmStateEnums::EXECUTABLE) {
+    cmRulePlaceholderExpander::RuleVariables linkVars;
+    linkVars.CMTargetName = targetName.c_str();
+    linkVars.CMTargetType = cmState::GetTargetTypeName(targetType);
+    linkVars.Language = lang.c_str();
+    linkVars.Objects = shellObject.c_str();
+    linkVars.ObjectDir = shellObjectDir.c_str();
+    linkVars.Target = shellExecutable.c_str();
+    linkVars.LinkLibraries = linkLibs.c_str();
+    linkVars.Flags = flags.c_str();
+    linkVars.LinkFlags = linkFlags.c_str();
+    std::vector<std::string> linkCommands;
+    cmSystemTools::ExpandListArgument(
+      this->Makefile->GetSafeDefinition(linkRuleVar), linkCommands);
+    for (std::string& command : linkCommands) {
+      expander->ExpandRuleVariables(&lg, command, linkVars);
+      commands.push_back(std::move(command));
+    }
+  }
+
+  // Report the commands as a verbose build of the test project would.
+  output = "Change Dir: " + this->BinaryDirectory + "\n\n";
+  res = 0;
+  for (std::string const& command : commands) {
+    output += command;
+    output += "\n";
+    std::vector<std::string> argv;
+    argv.push_back("/bin/sh");
+    argv.push_back("-c");
+    argv.push_back(command);
+    std::string commandOutput;
+    int retVal = 0;
+    if (!cmSystemTools::RunSingleCommand(
+          argv, &commandOutput, &commandOutput, &retVal,
+          this->BinaryDirectory.c_str(), cmSystemTools::OUTPUT_NONE) ||
+        retVal != 0) {
+      res = 1;
+    }
+    output += commandOutput;
+    if (res != 0) {
+      break;
+    }
+  }
+
+  // Match cmGlobalGenerator::Build for compilers that do not fail on
+  // #error.
+  if (res == 0 && output.find("#error") != std::string::npos) {
+    res = 1;
+  }
+  return true;
+}
+
+std::string cmCoreTryCompile::GetResultCacheFile(
+  std::string const& targetName, std::vector<std::string> const& sources,
+  std::set<std::string> const& langs,
+  std::vector<std::string> const& cmakeFlags)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  std::string cacheDir =
+    this->Makefile->GetSafeDefinition("CMAKE_TRY_COMPILE_CACHE_DIR");
+  if (cacheDir.empty()) {
+    cmSystemTools::GetEnv("CMAKE_TRY_COMPILE_CACHE_DIR", cacheDir);
+  }
+  if (cacheDir.empty()) {
+    return std::string();
+  }
+  cacheDir = cmSystemTools::CollapseFullPath(cacheDir);
+
+  // Paths into this build tree and the random target name are the only
+  // parts of a test project that differ between identical checks.
+  std::string const homeOutput = this->Makefile->GetHomeOutputDirectory();
+  auto normalize = [this, &homeOutput, &targetName](std::string str) {
+    cmSystemTools::ReplaceString(str, this->BinaryDirectory.c_str(),
+                                 "<TRY_COMPILE_DIR>");
+    cmSystemTools::ReplaceString(str, homeOutput.c_str(), "<BINARY_DIR>");
+    cmSystemTools::ReplaceString(str, targetName.c_str(), "<TARGET>");
+    return str;
+  };
+
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  auto append = [&hasher](std::string const& str) {
+    hasher.Append(str);
+    hasher.Append("", 1);
+  };
+
+  // The tools, as identified by CMakeDetermineCompilerId.
+  append(cmVersion::GetCMakeVersion());
+  append(this->Makefile->GetGlobalGenerator()->GetName());
+  static const char* const toolVars[] = {
+    "CMAKE_GENERATOR_INSTANCE",
+    "CMAKE_GENERATOR_PLATFORM",
+    "CMAKE_GENERATOR_TOOLSET",
+    "CMAKE_TRY_COMPILE_CONFIGURATION",
+    "CMAKE_AR",
+    "CMAKE_RANLIB",
+    "CMAKE_LINKER",
+  };
+  for (const char* var : toolVars) {
+    append(this->Makefile->GetSafeDefinition(var));
+  }
+  static const char* const langVars[] = {
+    "COMPILER",         "COMPILER_ARG1",    "COMPILER_ID",
+    "COMPILER_VERSION", "COMPILER_TARGET",  "SIMULATE_ID",
+    "SIMULATE_VERSION", "PLATFORM_ID",
+  };
+  for (std::string const& lang : langs) {
+    append(lang);
+    for (const char* var : langVars) {
+      append(this->Makefile->GetSafeDefinition("CMAKE_" + lang + "_" + var));
+    }
+    // Tell apart compilers replaced without changing their version.
+    std::string const compiler =
+      this->Makefile->GetSafeDefinition("CMAKE_" + lang + "_COMPILER");
+    append(std::to_string(cmSystemTools::FileLength(compiler)));
+    append(std::to_string(cmSystemTools::ModifiedTime(compiler)));
+  }
+
+  // The test project, with its flags, definitions and link libraries.
+  std::vector<std::string> files;
+  files.push_back(this->BinaryDirectory + "/CMakeLists.txt");
+  files.push_back(this->BinaryDirectory + "/" + targetName + "Targets.cmake");
+  for (std::string const& file : files) {
+    cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
+    append(normalize(std::string(std::istreambuf_iterator<char>(fin),
+                                 std::istreambuf_iterator<char>())));
+  }
+  for (std::string const& flag : cmakeFlags) {
+    append(normalize(flag));
+  }
+  for (std::string const& source : sources) {
+    cmCryptoHash sourceHasher(cmCryptoHash::AlgoSHA256);
+    append(normalize(source));
+    append(sourceHasher.HashFile(source));
+  }
+
+  return cacheDir + "/" + hasher.FinalizeHex();
+#else
+  // The bootstrap build has no hash implementation to key the cache.
+  static_cast<void>(targetName);
+  static_cast<void>(sources);
+  static_cast<void>(langs);
+  static_cast<void>(cmakeFlags);
+  return std::string();
+#endif
+}
+
+bool cmCoreTryCompile::LoadCachedResult(std::string const& file, int& res,
+                                        std::string& output)
+{
+  cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  if (!fin || !std::getline(fin, line) || (line != "0" && line != "1")) {
+    return false;
+  }
+  res = line == "0" ? 0 : 1;
+  output.assign(std::istreambuf_iterator<char>(fin),
+                std::istreambuf_iterator<char>());
+  return true;
+}
+
+void cmCoreTryCompile::StoreCachedResult(std::string const& file, int res,
+                                         std::string const& output)
+{
+  // Several builds may share the cache directory.
+  cmSystemTools::WriteFileAtomically(file,
+                                     (res == 0 ? "0\n" : "1\n") + output);
+}
+
 void cmCoreTryCompile::CleanupFiles(std::string const& binDir)
 {
   if (binDir.empty()) {
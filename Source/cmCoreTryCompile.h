@@ -5,12 +5,40 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <set>
 #include <string>
 #include <vector>
 
 #include "cmCommand.h"
 #include "cmStateTypes.h"
 
+/** \class cmTryCompileBatch
+ * \brief try_compile calls deferred by try_compile_batch(BEGIN)
+ *
+ * Each entry is a complete test project in its own directory below
+ * Directory.  try_compile_batch(END) configures all of them as one
+ * project and builds their targets, concurrently when possible.
+ */
+struct cmTryCompileBatch
+{
+  struct Entry
+  {
+    std::string ResultVariable;
+    std::string OutputVariable;
+    std::string BinaryDirectory;
+    std::string TargetName;
+    // The complete CMAKE_FLAGS to build the entry as a separate project.
+    std::vector<std::string> CMakeFlags;
+    // The part of CMakeFlags forwarded from the calling project.
+    std::vector<std::string> ForwardedFlags;
+    // Where to store the result, if results are cached.
+    std::string ResultCacheFile;
+  };
+
+  std::string Directory;
+  std::vector<Entry> Entries;
+};
+
 /** \class cmCoreTryCompile
  * \brief Base class for cmTryCompileCommand and cmTryRunCommand
  *
@@ -20,6 +48,8 @@
 class cmCoreTryCompile : public cmCommand
 {
 public:
+  bool WritesFiles() const override { return true; }
+
 protected:
   /**
    * This is the core code for try compile. It is here so that other
@@ -43,14 +73,49 @@ protected:
   void FindOutputFile(const std::string& targetName,
                       cmStateEnums::TargetType targetType);
 
+  /**
+   * Store the result and output of a test project in the file returned
+   * for it by GetResultCacheFile.
+   */
+  static void StoreCachedResult(std::string const& file, int res,
+                                std::string const& output);
+
   std::string BinaryDirectory;
   std::string OutputFile;
   std::string FindErrorMessage;
   bool SrcFileSignature;
+  bool Deferred;
 
 private:
   std::vector<std::string> WarnCMP0067;
   std::string LookupStdVar(std::string const& var, bool warnCMP0067);
+
+  /**
+   * Return the file of the CMAKE_TRY_COMPILE_CACHE_DIR entry for the
+   * test project written to BinaryDirectory, or an empty string if
+   * results are not cached.
+   */
+  std::string GetResultCacheFile(std::string const& targetName,
+                                 std::vector<std::string> const& sources,
+                                 std::set<std::string> const& langs,
+                                 std::vector<std::string> const& cmakeFlags);
+  static bool LoadCachedResult(std::string const& file, int& res,
+                               std::string& output);
+
+  /**
+   * Build the test project written for a single source file by running
+   * the compile and link rules of the calling project directly, without
+   * configuring the test project and running the build tool.  Returns
+   * false without building if the call needs anything the test project
+   * would add beyond those rules.
+   */
+  bool TryCompileDirect(std::string const& lang, std::string const& source,
+                        std::string const& targetName,
+                        cmStateEnums::TargetType targetType,
+                        std::vector<std::string> const& compileDefs,
+                        std::vector<std::string> const& cmakeFlags,
+                        std::vector<std::string> const* linkLibraries,
+                        int& res, std::string& output);
 };
 
 #endif
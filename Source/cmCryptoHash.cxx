@@ -24,14 +24,11 @@ static unsigned int const cmCryptoHashAlgoToId[] = {
   RHASH_SHA3_512
 };
 
-static int cmCryptoHash_rhash_library_initialized;
-
 static rhash cmCryptoHash_rhash_init(unsigned int id)
 {
-  if (!cmCryptoHash_rhash_library_initialized) {
-    cmCryptoHash_rhash_library_initialized = 1;
-    rhash_library_init();
-  }
+  // Files may be hashed concurrently.  Initialize the library only once.
+  static bool const initialized = (rhash_library_init(), true);
+  static_cast<void>(initialized);
   return rhash_init(id);
 }
 
@@ -48,37 +45,56 @@ cmCryptoHash::~cmCryptoHash()
 
 std::unique_ptr<cmCryptoHash> cmCryptoHash::New(const char* algo)
 {
-  if (strcmp(algo, "MD5") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoMD5);
+  Algo id;
+  if (cmCryptoHash::AlgoFromName(algo, id)) {
+    return cm::make_unique<cmCryptoHash>(id);
   }
-  if (strcmp(algo, "SHA1") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoSHA1);
+  return std::unique_ptr<cmCryptoHash>(nullptr);
+}
+
+bool cmCryptoHash::AlgoFromName(const char* name, Algo& algo)
+{
+  if (strcmp(name, "MD5") == 0) {
+    algo = AlgoMD5;
+    return true;
   }
-  if (strcmp(algo, "SHA224") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoSHA224);
+  if (strcmp(name, "SHA1") == 0) {
+    algo = AlgoSHA1;
+    return true;
   }
-  if (strcmp(algo, "SHA256") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoSHA256);
+  if (strcmp(name, "SHA224") == 0) {
+    algo = AlgoSHA224;
+    return true;
   }
-  if (strcmp(algo, "SHA384") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoSHA384);
+  if (strcmp(name, "SHA256") == 0) {
+    algo = AlgoSHA256;
+    return true;
   }
-  if (strcmp(algo, "SHA512") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoSHA512);
+  if (strcmp(name, "SHA384") == 0) {
+    algo = AlgoSHA384;
+    return true;
   }
-  if (strcmp(algo, "SHA3_224") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoSHA3_224);
+  if (strcmp(name, "SHA512") == 0) {
+    algo = AlgoSHA512;
+    return true;
   }
-  if (strcmp(algo, "SHA3_256") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoSHA3_256);
+  if (strcmp(name, "SHA3_224") == 0) {
+    algo = AlgoSHA3_224;
+    return true;
   }
-  if (strcmp(algo, "SHA3_384") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoSHA3_384);
+  if (strcmp(name, "SHA3_256") == 0) {
+    algo = AlgoSHA3_256;
+    return true;
   }
-  if (strcmp(algo, "SHA3_512") == 0) {
-    return cm::make_unique<cmCryptoHash>(AlgoSHA3_512);
+  if (strcmp(name, "SHA3_384") == 0) {
+    algo = AlgoSHA3_384;
+    return true;
   }
-  return std::unique_ptr<cmCryptoHash>(nullptr);
+  if (strcmp(name, "SHA3_512") == 0) {
+    algo = AlgoSHA3_512;
+    return true;
+  }
+  return false;
 }
 
 bool cmCryptoHash::IntFromHexDigit(char input, char& output)
@@ -128,7 +144,9 @@ std::vector<unsigned char> cmCryptoHash::ByteHashFile(const std::string& file)
   if (fin) {
     this->Initialize();
     {
-      // Should be efficient enough on most system:
+      // Should be efficient enough on most system.  The file is not
+      // mapped into memory: the process would crash on a read past the
+      // end if another process truncated the file meanwhile.
       KWIML_INT_uint64_t buffer[512];
       char* buffer_c = reinterpret_cast<char*>(buffer);
       unsigned char const* buffer_uc =
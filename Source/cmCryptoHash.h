@@ -43,6 +43,12 @@ public:
   ///         an invalid/NULL pointer otherwise
   static std::unique_ptr<cmCryptoHash> New(const char* algo);
 
+  /// @brief Looks up the hash type of the given name
+  /// @arg name Hash type name as accepted by New()
+  /// @arg algo Hash type of the name
+  /// @return True if the name is supported
+  static bool AlgoFromName(const char* name, Algo& algo);
+
   /// @brief Converts a hex character to its binary value (4 bits)
   /// @arg input Hex character [0-9a-fA-F].
   /// @arg output Binary value of the input character (4 bits)
@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmCustomCommandGenerator.h"
 
+#include "cmAlgorithms.h"
 #include "cmCustomCommand.h"
 #include "cmCustomCommandLines.h"
 #include "cmGeneratorExpression.h"
@@ -11,6 +12,7 @@
 #include "cmStateTypes.h"
 #include "cmSystemTools.h"
 
+#include <algorithm>
 #include <memory> // IWYU pragma: keep
 #include <stddef.h>
 #include <utility>
@@ -170,11 +172,78 @@ void cmCustomCommandGenerator::AppendArguments(unsigned int c,
     } else {
       arg = commandLine[j];
     }
-    cmd += " ";
-    if (this->OldStyle) {
-      cmd += escapeForShellOldStyle(arg);
-    } else {
-      cmd += this->LG->EscapeForShell(arg, this->MakeVars);
+    this->AppendArgument(arg, cmd);
+  }
+}
+
+void cmCustomCommandGenerator::AppendArgument(std::string const& arg,
+                                              std::string& cmd) const
+{
+  cmd += " ";
+  if (this->OldStyle) {
+    cmd += escapeForShellOldStyle(arg);
+  } else {
+    cmd += this->LG->EscapeForShell(arg, this->MakeVars);
+  }
+}
+
+bool cmCustomCommandGenerator::IsBatchCommand(unsigned int c) const
+{
+  // The "cmake -E" commands that work on files and that a custom
+  // command typically runs many of.
+  static const char* const batchCommands[] = {
+    "copy",   "copy_directory",   "copy_if_different", "make_directory",
+    "remove", "remove_directory", "rename",            "touch",
+    "touch_nocreate"
+  };
+
+  cmCustomCommandLine const& commandLine = this->CommandLines[c];
+  if (commandLine.size() < 3 || commandLine[1] != "-E" ||
+      commandLine[0] !=
+        this->LG->GetMakefile()->GetSafeDefinition("CMAKE_COMMAND") ||
+      std::find(cm::cbegin(batchCommands), cm::cend(batchCommands),
+                commandLine[2]) == cm::cend(batchCommands)) {
+    return false;
+  }
+  for (unsigned int j = 3; j < commandLine.size(); ++j) {
+    std::string const& arg = commandLine[j];
+    // The batch separates commands by "--".  Without VERBATIM an argument
+    // may redirect or chain with shell syntax that would then apply to
+    // the whole batch.
+    if (arg == "--" ||
+        (this->OldStyle && arg.find_first_of("<>|&;`") != std::string::npos)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+unsigned int cmCustomCommandGenerator::GetBatchSize(unsigned int c) const
+{
+  unsigned int n = 1;
+  if (this->IsBatchCommand(c)) {
+    while (c + n < this->CommandLines.size() &&
+           this->IsBatchCommand(c + n)) {
+      ++n;
+    }
+  }
+  return n;
+}
+
+void cmCustomCommandGenerator::AppendBatchArguments(unsigned int c,
+                                                    unsigned int n,
+                                                    std::string& cmd) const
+{
+  if (n < 2) {
+    this->AppendArguments(c, cmd);
+    return;
+  }
+  cmd += " -E batch";
+  for (unsigned int i = c; i < c + n; ++i) {
+    cmCustomCommandLine const& commandLine = this->CommandLines[i];
+    cmd += " --";
+    for (unsigned int j = 2; j < commandLine.size(); ++j) {
+      this->AppendArgument(commandLine[j], cmd);
     }
   }
 }
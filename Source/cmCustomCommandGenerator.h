@@ -26,6 +26,8 @@ class cmCustomCommandGenerator
 
   const char* GetCrossCompilingEmulator(unsigned int c) const;
   const char* GetArgv0Location(unsigned int c) const;
+  bool IsBatchCommand(unsigned int c) const;
+  void AppendArgument(std::string const& arg, std::string& cmd) const;
 
 public:
   cmCustomCommandGenerator(cmCustomCommand const& cc,
@@ -35,6 +37,16 @@ public:
   unsigned int GetNumberOfCommands() const;
   std::string GetCommand(unsigned int c) const;
   void AppendArguments(unsigned int c, std::string& cmd) const;
+
+  /** Get the number of command lines, starting at the given one, that
+      run file operations "cmake -E batch" can run in one process.  */
+  unsigned int GetBatchSize(unsigned int c) const;
+
+  /** Append the arguments of n command lines, starting at the given one,
+      as those of one "cmake -E batch" command.  */
+  void AppendBatchArguments(unsigned int c, unsigned int n,
+                            std::string& cmd) const;
+
   const char* GetComment() const;
   std::string GetWorkingDirectory() const;
   std::vector<std::string> const& GetOutputs() const;
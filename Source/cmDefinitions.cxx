@@ -6,6 +6,8 @@
 #include <set>
 #include <utility>
 
+#include "cmSystemTools.h"
+
 cmDefinitions::Def cmDefinitions::NoDef;
 
 cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
@@ -55,12 +57,72 @@ bool cmDefinitions::HasKey(const std::string& key, StackIter begin,
   return false;
 }
 
+std::vector<std::string> const* cmDefinitions::GetList(
+  const std::string& key, StackIter begin, StackIter end)
+{
+  Def const& def = cmDefinitions::GetInternal(key, begin, end, false);
+  if (!def.Exists) {
+    return nullptr;
+  }
+  if (!def.Split) {
+    def.Split = std::make_shared<List>();
+    if (!def.empty()) {
+      cmSystemTools::ExpandListArgument(def, def.Split->Elements, true);
+    }
+    def.Split->Nesting = cmDefinitions::GetNesting(def);
+  }
+  return &def.Split->Elements;
+}
+
 void cmDefinitions::Set(const std::string& key, const char* value)
 {
   Def def(value);
   this->Map[key] = def;
 }
 
+bool cmDefinitions::Append(const std::string& key, const std::string& value,
+                           StackIter begin, StackIter end)
+{
+  if (!cmDefinitions::Get(key, begin, end)) {
+    return false;
+  }
+  cmDefinitions::Raise(key, begin, end);
+  Def& def = begin->Map[key];
+  def.Used = false;
+  if (def.empty()) {
+    def.assign(value);
+    def.Split.reset();
+    return true;
+  }
+
+  // Split only the new elements if the existing ones are not affected.
+  // A backslash would escape the separator.
+  std::shared_ptr<List>& split = def.Split;
+  if (split && split.use_count() == 1 && split->Nesting == 0 &&
+      def.back() != '\\') {
+    cmSystemTools::ExpandListArgument(value, split->Elements, true);
+    split->Nesting = cmDefinitions::GetNesting(value);
+  } else {
+    split.reset();
+  }
+  def += ";";
+  def += value;
+  return true;
+}
+
+int cmDefinitions::GetNesting(std::string const& value)
+{
+  int nesting = 0;
+  for (char c : value) {
+    if (c == '[') {
+      ++nesting;
+    } else if (c == ']') {
+      --nesting;
+    }
+  }
+  return nesting;
+}
+
 std::vector<std::string> cmDefinitions::UnusedKeys() const
 {
   std::vector<std::string> keys;
@@ -5,6 +5,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -30,9 +31,23 @@ public:
 
   static bool HasKey(const std::string& key, StackIter begin, StackIter end);
 
+  /** Get the value of a key split as a list, keeping empty elements,
+      or null if the key is not set.  An empty value is an empty list.
+      The split is cached with the value and the result stays valid
+      until the key is set again.  */
+  static std::vector<std::string> const* GetList(const std::string& key,
+                                                 StackIter begin,
+                                                 StackIter end);
+
   /** Set (or unset if null) a value associated with a key.  */
   void Set(const std::string& key, const char* value);
 
+  /** Append a list to the value of a key, separated by a semicolon if the
+      value is not empty.  The key is set in the first scope if it was
+      inherited.  Returns false if the key is not set.  */
+  static bool Append(const std::string& key, const std::string& value,
+                     StackIter begin, StackIter end);
+
   std::vector<std::string> UnusedKeys() const;
 
   static std::vector<std::string> ClosureKeys(StackIter begin, StackIter end);
@@ -40,6 +55,15 @@ public:
   static cmDefinitions MakeClosure(StackIter begin, StackIter end);
 
 private:
+  // Split form of a value.
+  struct List
+  {
+    std::vector<std::string> Elements;
+    // Number of '[' minus number of ']' in the value.  Elements appended
+    // after an unbalanced value may be part of its last element.
+    int Nesting = 0;
+  };
+
   // String with existence boolean.
   struct Def : public std::string
   {
@@ -67,6 +91,9 @@ private:
     }
     bool Exists;
     bool Used;
+    // Shared with copies of the definition in other scopes, so it is
+    // modified in place only while it has one owner.
+    mutable std::shared_ptr<List> Split;
   };
   static Def NoDef;
 
@@ -75,6 +102,7 @@ private:
 
   static Def const& GetInternal(const std::string& key, StackIter begin,
                                 StackIter end, bool raise);
+  static int GetNesting(std::string const& value);
 };
 
 #endif
@@ -0,0 +1,186 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmDirectorySnapshot.h"
+
+#include "cmsys/Directory.hxx"
+#include <istream>
+#include <ostream>
+#include <string.h>
+#include <time.h>
+#include <utility>
+
+#include "cmSystemTools.h"
+
+cmDirectorySnapshot::cmDirectorySnapshot(bool recordKinds)
+  : RecordKinds(recordKinds)
+  , Modified(false)
+  , Checks(0)
+  , Loads(0)
+{
+}
+
+cmDirectorySnapshot::Listing const& cmDirectorySnapshot::Get(
+  std::string const& dir, unsigned long epoch)
+{
+  return this->Lookup(dir, epoch, false);
+}
+
+cmDirectorySnapshot::Listing const& cmDirectorySnapshot::Update(
+  std::string const& dir)
+{
+  return this->Lookup(dir, 0, true);
+}
+
+bool cmDirectorySnapshot::HasName(std::string const& dir,
+                                  std::string const& name,
+                                  unsigned long epoch)
+{
+  Listing& l = this->Lookup(dir, epoch, false);
+  if (!l.Indexed) {
+    for (Entry const& e : l.Entries) {
+      l.Index.insert(cmSystemTools::LowerCase(e.Name));
+    }
+    l.Indexed = true;
+  }
+  return l.Index.find(cmSystemTools::LowerCase(name)) != l.Index.end();
+}
+
+cmDirectorySnapshot::Listing& cmDirectorySnapshot::Lookup(
+  std::string const& dir, unsigned long epoch, bool force)
+{
+  std::string key = dir;
+  if (key.size() > 1 && key.back() == '/') {
+    key.pop_back();
+  }
+  Listing& l = this->Listings[key];
+  if (force || l.Epoch != epoch) {
+    if (!force) {
+      l.Epoch = epoch;
+    }
+    this->Check(key, l);
+  }
+  return l;
+}
+
+void cmDirectorySnapshot::Check(std::string const& dir, Listing& l)
+{
+  ++this->Checks;
+
+  // Missing directories have a modification time of zero.
+  long const mt = cmSystemTools::ModifiedTime(dir);
+  if (l.Known && l.Stable && mt == l.ModifiedTime) {
+    return;
+  }
+
+  ++this->Loads;
+  ++l.Loads;
+  l.Known = true;
+  l.Stable = true;
+  l.Indexed = false;
+  l.ModifiedTime = mt;
+  l.Entries.clear();
+  l.Index.clear();
+  cmsys::Directory listing;
+  if (mt != 0 && listing.Load(dir)) {
+    unsigned long const n = listing.GetNumberOfFiles();
+    l.Entries.reserve(n);
+    std::string path;
+    for (unsigned long i = 0; i < n; ++i) {
+      const char* f = listing.GetFile(i);
+      if (strcmp(f, ".") == 0 || strcmp(f, "..") == 0) {
+        continue;
+      }
+      // Written snapshots hold one name per line.
+      if (strchr(f, '\n')) {
+        l.Stable = false;
+      }
+      Entry e;
+      e.Name = f;
+      e.Kind = '?';
+      if (this->RecordKinds) {
+        path = dir + "/" + f;
+        if (cmSystemTools::FileIsSymlink(path)) {
+          e.Kind = 'l';
+        } else if (cmSystemTools::FileIsDirectory(path)) {
+          e.Kind = 'd';
+        } else {
+          e.Kind = 'f';
+        }
+      }
+      l.Entries.push_back(std::move(e));
+    }
+  }
+
+  // The directory may change again within the resolution of its
+  // modification time.  Do not trust this listing after this epoch.
+  if (mt < 0 || mt >= static_cast<long>(time(nullptr)) - 1) {
+    l.Stable = false;
+  }
+  this->Modified = true;
+}
+
+bool cmDirectorySnapshot::Read(std::istream& fin)
+{
+  std::unordered_map<std::string, Listing> listings;
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    std::string::size_type const pos = line.find(' ', 2);
+    if (line.size() < 4 || line[0] != 'D' || line[1] != ' ' ||
+        pos == std::string::npos) {
+      return false;
+    }
+    std::string const mtime = line.substr(2, pos - 2);
+    unsigned long mt = 0;
+    if (!cmSystemTools::StringToULong(mtime.c_str(), &mt)) {
+      return false;
+    }
+    Listing& l = listings[line.substr(pos + 1)];
+    l.Known = true;
+    l.Stable = true;
+    l.ModifiedTime = static_cast<long>(mt);
+    for (;;) {
+      if (!cmSystemTools::GetLineFromStream(fin, line)) {
+        return false;
+      }
+      if (line.empty()) {
+        break;
+      }
+      char const kind = line[0];
+      if (line.size() < 3 || line[1] != ' ' ||
+          (this->RecordKinds ? kind != 'd' && kind != 'l' && kind != 'f'
+                             : kind != '?')) {
+        return false;
+      }
+      Entry e;
+      e.Kind = kind;
+      e.Name = line.substr(2);
+      l.Entries.push_back(std::move(e));
+    }
+  }
+  this->Listings = std::move(listings);
+  this->Modified = false;
+  return true;
+}
+
+void cmDirectorySnapshot::Write(std::ostream& fout) const
+{
+  for (auto const& l : this->Listings) {
+    if (!l.second.Known || !l.second.Stable ||
+        l.first.find('\n') != std::string::npos) {
+      continue;
+    }
+    fout << "D " << l.second.ModifiedTime << " " << l.first << "\n";
+    for (Entry const& e : l.second.Entries) {
+      fout << e.Kind << " " << e.Name << "\n";
+    }
+    fout << "\n";
+  }
+}
+
+void cmDirectorySnapshot::Clear()
+{
+  this->Listings.clear();
+  this->Modified = false;
+  this->Checks = 0;
+  this->Loads = 0;
+}
@@ -0,0 +1,102 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmDirectorySnapshot_h
+#define cmDirectorySnapshot_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/** \class cmDirectorySnapshot
+ * \brief Directory listings reused while a directory is unchanged
+ *
+ * A directory is listed on its first use and the listing is reused
+ * while the modification time of the directory stays the same.  The
+ * modification time is checked at most once per epoch given by the
+ * caller.  A directory that may still change within the resolution of
+ * its modification time is listed again after its epoch and is not
+ * written out.
+ *
+ * Listings can be written to a stream and read back in a later run.
+ * Each directory is a "D <mtime> <path>" line followed by one
+ * "<kind> <name>" line per entry and an empty line.
+ */
+class cmDirectorySnapshot
+{
+public:
+  struct Entry
+  {
+    std::string Name;
+    // 'd' for a directory, 'l' for a symbolic link, 'f' for anything
+    // else, or '?' if the snapshot does not record kinds.
+    char Kind;
+  };
+
+  struct Listing
+  {
+    // The entries without "." and "..", in the order the file system
+    // listed them.  Missing directories are empty.
+    std::vector<Entry> Entries;
+    // Incremented each time the directory is listed from disk.
+    unsigned long Loads = 0;
+
+  private:
+    friend class cmDirectorySnapshot;
+    bool Known = false;
+    bool Stable = false;
+    bool Indexed = false;
+    long ModifiedTime = 0;
+    unsigned long Epoch = 0;
+    std::unordered_set<std::string> Index;
+  };
+
+  /** Construct an empty snapshot.  Listings record the kind of each
+      entry only if requested since that needs a check per entry.  */
+  explicit cmDirectorySnapshot(bool recordKinds);
+
+  /** Get the listing of a directory.  Its modification time is checked
+      once per epoch, which must not be zero.  */
+  Listing const& Get(std::string const& dir, unsigned long epoch);
+
+  /** Get the listing of a directory, checking its modification time.  */
+  Listing const& Update(std::string const& dir);
+
+  /** Check whether the listing of a directory has a name, ignoring case
+      as case-insensitive file systems do.  */
+  bool HasName(std::string const& dir, std::string const& name,
+               unsigned long epoch);
+
+  /** Replace the listings by the ones read from a stream.  Returns false
+      and leaves the snapshot unchanged if the stream is malformed.  */
+  bool Read(std::istream& fin);
+
+  /** Write the listings that may be reused by later runs.  */
+  void Write(std::ostream& fout) const;
+
+  /** Whether any directory was listed from disk since the snapshot was
+      last read or marked saved.  */
+  bool IsModified() const { return this->Modified; }
+  void MarkSaved() { this->Modified = false; }
+
+  void Clear();
+
+  /** Number of modification time checks and listings from disk.  */
+  unsigned long GetNumberOfChecks() const { return this->Checks; }
+  unsigned long GetNumberOfLoads() const { return this->Loads; }
+
+private:
+  Listing& Lookup(std::string const& dir, unsigned long epoch, bool force);
+  void Check(std::string const& dir, Listing& l);
+
+  std::unordered_map<std::string, Listing> Listings;
+  bool RecordKinds;
+  bool Modified;
+  unsigned long Checks;
+  unsigned long Loads;
+};
+
+#endif
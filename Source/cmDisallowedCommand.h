@@ -39,6 +39,8 @@ public:
 
   bool HasFinalPass() const override { return this->Command->HasFinalPass(); }
 
+  bool WritesFiles() const override { return this->Command->WritesFiles(); }
+
 private:
   cmCommand* Command;
   cmPolicies::PolicyID Policy;
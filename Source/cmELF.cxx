@@ -3,7 +3,7 @@
 #include "cmELF.h"
 
 #include "cm_kwiml.h"
-#include "cmsys/FStream.hxx"
+#include <istream>
 #include <map>
 #include <memory> // IWYU pragma: keep
 #include <sstream>
@@ -11,6 +11,8 @@
 #include <utility>
 #include <vector>
 
+#include "cmFileBuffer.h"
+
 // Include the ELF format information system header.
 #if defined(__OpenBSD__)
 #include <elf_abi.h>
@@ -97,6 +99,68 @@ void cmELFByteSwap(T& x)
   cmELFByteSwap(reinterpret_cast<char*>(&x), cmELFByteSwapSize<sizeof(T)>());
 }
 
+// Read a file from memory through the stream interface.  Seeking and
+// reading only move a pointer, where a file stream would make system
+// calls for each of the many small reads the parser does.
+class cmELFBufferStream : public std::istream
+{
+public:
+  cmELFBufferStream()
+    : std::istream(nullptr)
+  {
+  }
+
+  bool Open(const char* fname)
+  {
+    if (!this->File.Open(fname)) {
+      return false;
+    }
+    this->Buffer.Reset(this->File.GetData(), this->File.GetSize());
+    this->rdbuf(&this->Buffer);
+    return true;
+  }
+
+private:
+  class MemoryBuffer : public std::streambuf
+  {
+  public:
+    void Reset(const char* data, size_t size)
+    {
+      // The stream is only read, so the buffer is never written.
+      char* begin = const_cast<char*>(data);
+      this->setg(begin, begin, begin + size);
+    }
+
+  protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode which) override
+    {
+      if (!(which & std::ios_base::in)) {
+        return pos_type(off_type(-1));
+      }
+      off_type base = 0;
+      if (dir == std::ios_base::cur) {
+        base = this->gptr() - this->eback();
+      } else if (dir == std::ios_base::end) {
+        base = this->egptr() - this->eback();
+      }
+      off_type const pos = base + off;
+      if (pos < 0 || pos > this->egptr() - this->eback()) {
+        return pos_type(off_type(-1));
+      }
+      this->setg(this->eback(), this->eback() + pos, this->egptr());
+      return pos_type(pos);
+    }
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+    {
+      return this->seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+  };
+
+  cmFileBuffer File;
+  MemoryBuffer Buffer;
+};
+
 class cmELFInternal
 {
 public:
@@ -108,7 +172,7 @@ public:
   };
 
   // Construct and take ownership of the file stream object.
-  cmELFInternal(cmELF* external, std::unique_ptr<cmsys::ifstream>& fin,
+  cmELFInternal(cmELF* external, std::unique_ptr<std::istream>& fin,
                 ByteOrderType order)
     : External(external)
     , Stream(*fin.release())
@@ -231,7 +295,7 @@ public:
   typedef typename Types::tagtype tagtype;
 
   // Construct with a stream and byte swap indicator.
-  cmELFInternalImpl(cmELF* external, std::unique_ptr<cmsys::ifstream>& fin,
+  cmELFInternalImpl(cmELF* external, std::unique_ptr<std::istream>& fin,
                     ByteOrderType order);
 
   // Return the number of sections as specified by the ELF header.
@@ -425,7 +489,7 @@ private:
 
 template <class Types>
 cmELFInternalImpl<Types>::cmELFInternalImpl(
-  cmELF* external, std::unique_ptr<cmsys::ifstream>& fin, ByteOrderType order)
+  cmELF* external, std::unique_ptr<std::istream>& fin, ByteOrderType order)
   : cmELFInternal(external, fin, order)
 {
   // Read the main header.
@@ -679,11 +743,13 @@ const long cmELF::TagMipsRldMapRel = 0;
 cmELF::cmELF(const char* fname)
   : Internal(nullptr)
 {
-  // Try to open the file.
-  std::unique_ptr<cmsys::ifstream> fin(new cmsys::ifstream(fname));
+  // Read the file into memory.
+  std::unique_ptr<cmELFBufferStream> stream(new cmELFBufferStream);
+  bool const opened = stream->Open(fname);
+  std::unique_ptr<std::istream> fin(std::move(stream));
 
   // Quit now if the file could not be opened.
-  if (!fin.get() || !*fin) {
+  if (!opened || !*fin) {
     this->ErrorMessage = "Error opening input file.";
     return;
   }
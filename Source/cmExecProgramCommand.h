@@ -36,6 +36,8 @@ public:
   bool InitialPass(std::vector<std::string> const& args,
                    cmExecutionStatus& status) override;
 
+  bool WritesFiles() const override { return true; }
+
 private:
   static bool RunCommand(const char* command, std::string& output, int& retVal,
                          const char* directory = nullptr, bool verbose = true,
@@ -32,6 +32,8 @@ public:
    */
   bool InitialPass(std::vector<std::string> const& args,
                    cmExecutionStatus& status) override;
+
+  bool WritesFiles() const override { return true; }
 };
 
 #endif
@@ -0,0 +1,35 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmFileBuffer.h"
+
+#include "cmsys/FStream.hxx"
+#include <algorithm>
+#include <istream>
+
+#include "cmSystemTools.h"
+
+bool cmFileBuffer::Open(std::string const& fname, size_t maxSize)
+{
+  this->Buffer.clear();
+  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+
+  // Read a regular file in one block of its size.  Read other files,
+  // whose size is not known, in smaller blocks.
+  size_t const blockSize = 1 << 16;
+  size_t size = static_cast<size_t>(cmSystemTools::FileLength(fname));
+  size = std::min(std::max(size, blockSize), maxSize);
+  while (size > 0) {
+    size_t const start = this->Buffer.size();
+    this->Buffer.resize(start + size);
+    fin.read(&this->Buffer[start], static_cast<std::streamsize>(size));
+    this->Buffer.resize(start + static_cast<size_t>(fin.gcount()));
+    if (!fin) {
+      break;
+    }
+    size = std::min(blockSize, maxSize - this->Buffer.size());
+  }
+  return true;
+}
@@ -0,0 +1,39 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmFileBuffer_h
+#define cmFileBuffer_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <stddef.h>
+#include <string>
+
+/** \class cmFileBuffer
+ * \brief Contents of a file read into memory.
+ *
+ * The contents are the bytes of the file, without any newline
+ * conversion.  The file is read rather than mapped into memory: a
+ * process reading a mapping past the end of a file that another process
+ * truncated meanwhile is killed by SIGBUS.
+ */
+class cmFileBuffer
+{
+  CM_DISABLE_COPY(cmFileBuffer)
+
+public:
+  cmFileBuffer() {}
+
+  /** Read the given file up to maxSize bytes, since files such as
+      devices may never end.  Returns false if it cannot be opened, with
+      the reason available from cmSystemTools::GetLastSystemError().  */
+  bool Open(std::string const& fname,
+            size_t maxSize = std::string::npos);
+
+  const char* GetData() const { return this->Buffer.data(); }
+  size_t GetSize() const { return this->Buffer.size(); }
+
+private:
+  std::string Buffer;
+};
+
+#endif
@@ -10,7 +10,11 @@
 #include "cmsys/String.hxx"
 #include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <memory> // IWYU pragma: keep
+#include <set>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
@@ -21,6 +25,7 @@
 #include "cmCommandArgumentsHelper.h"
 #include "cmCryptoHash.h"
 #include "cmFSPermissions.h"
+#include "cmFileBuffer.h"
 #include "cmFileLockPool.h"
 #include "cmFileTimeComparison.h"
 #include "cmGeneratorExpression.h"
@@ -38,6 +43,9 @@
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 #include "cmCurl.h"
 #include "cmFileLockResult.h"
+#include "cmGlobCache.h"
+#include "cmInstallState.h"
+#include "cmWorkerPool.h"
 #include "cm_curl.h"
 #endif
 
@@ -78,6 +86,164 @@ static std::string fix_file_url_windows(const std::string& url)
 }
 #endif
 
+// Write two lower-case hex digits for each input byte.
+static void cmFileCommandHexEncode(const char* in, size_t n, char* out)
+{
+  static const char digits[] = "0123456789abcdef";
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(in);
+  for (size_t i = 0; i < n; ++i) {
+    out[2 * i] = digits[data[i] >> 4];
+    out[2 * i + 1] = digits[data[i] & 0xf];
+  }
+}
+
+namespace {
+// Input of file(STRINGS) read from memory.  The get(), putback() and
+// tellg() members behave as those of the input stream used before:
+// reading past the end fails the input, after which nothing can be put
+// back and the position is -1.
+class cmFileCommandStringsInput
+{
+public:
+  cmFileCommandStringsInput(const char* data, size_t size)
+    : Data(reinterpret_cast<const unsigned char*>(data))
+    , Size(size)
+    , Pos(0)
+    , Good(true)
+  {
+  }
+
+  explicit operator bool() const { return this->Good; }
+
+  long tellg() const
+  {
+    return this->Good ? static_cast<long>(this->Pos) : -1;
+  }
+
+  int get()
+  {
+    if (this->Good && this->Pos < this->Size) {
+      return this->Data[this->Pos++];
+    }
+    this->Good = false;
+    return EOF;
+  }
+
+  // The byte put back is always the one read before it.
+  void putback(char)
+  {
+    if (this->Good && this->Pos > 0) {
+      --this->Pos;
+    }
+  }
+
+  // Skip a byte order mark as cmsys::FStream::ReadBOM does.
+  int ReadBOM();
+
+  // Length of the run of at most max characters at the current position
+  // that are printable ASCII, tabs, or newlines if newline is true.
+  size_t PrintableRun(size_t max, bool newline) const;
+
+  // Length of the run of at most max characters at the current position
+  // that end no string and can never be part of one in a file without
+  // encoding: control characters other than tab and newline, and bytes
+  // outside ASCII.
+  size_t BinaryRun(size_t max) const;
+
+  const char* Consume(size_t n)
+  {
+    const char* run = reinterpret_cast<const char*>(this->Data + this->Pos);
+    this->Pos += n;
+    return run;
+  }
+
+private:
+  const unsigned char* Data;
+  size_t Size;
+  size_t Pos;
+  bool Good;
+};
+
+int cmFileCommandStringsInput::ReadBOM()
+{
+  const unsigned char* d = this->Data;
+  size_t const n = this->Size;
+  if (n >= 3 && d[0] == 0xEF && d[1] == 0xBB && d[2] == 0xBF) {
+    this->Pos = 3;
+    return cmsys::FStream::BOM_UTF8;
+  }
+  if (n >= 2 && d[0] == 0xFE && d[1] == 0xFF) {
+    this->Pos = 2;
+    return cmsys::FStream::BOM_UTF16BE;
+  }
+  if (n >= 4 && d[0] == 0x00 && d[1] == 0x00 && d[2] == 0xFE &&
+      d[3] == 0xFF) {
+    this->Pos = 4;
+    return cmsys::FStream::BOM_UTF32BE;
+  }
+  if (n >= 2 && d[0] == 0xFF && d[1] == 0xFE) {
+    if (n >= 4 && d[2] == 0x00 && d[3] == 0x00) {
+      this->Pos = 4;
+      return cmsys::FStream::BOM_UTF32LE;
+    }
+    // The stream failed looking for a UTF-32 mark in a short file.
+    this->Good = n >= 4;
+    this->Pos = 2;
+    return cmsys::FStream::BOM_UTF16LE;
+  }
+  return cmsys::FStream::BOM_None;
+}
+
+size_t cmFileCommandStringsInput::PrintableRun(size_t max, bool newline) const
+{
+  if (!this->Good) {
+    return 0;
+  }
+  const unsigned char* p = this->Data + this->Pos;
+  size_t const n = std::min(max, this->Size - this->Pos);
+  size_t i = 0;
+
+  // Check eight bytes at a time for any byte below 0x20 or above 0x7E.
+  typedef KWIML_INT_uint64_t word;
+  word const ones = static_cast<word>(-1) / 0xff;
+  word const highs = ones * 0x80;
+  for (; i + sizeof(word) <= n; i += sizeof(word)) {
+    word x;
+    memcpy(&x, p + i, sizeof(word));
+    word const below = (x - ones * 0x20) & ~x & highs;
+    word const above = ((x + ones * (0x7F - 0x7E)) | x) & highs;
+    if ((below | above) != 0) {
+      break;
+    }
+  }
+
+  for (; i < n; ++i) {
+    unsigned char const c = p[i];
+    if (!((c >= 0x20 && c < 0x7F) || c == '\t' || (c == '\n' && newline))) {
+      break;
+    }
+  }
+  return i;
+}
+
+size_t cmFileCommandStringsInput::BinaryRun(size_t max) const
+{
+  if (!this->Good) {
+    return 0;
+  }
+  const unsigned char* p = this->Data + this->Pos;
+  size_t const n = std::min(max, this->Size - this->Pos);
+  size_t i = 0;
+  for (; i < n; ++i) {
+    unsigned char const c = p[i];
+    if ((c >= 0x20 && c < 0x7F) || c == '\t' || c == '\n') {
+      break;
+    }
+  }
+  return i;
+}
+}
+
 // cmLibraryCommand
 bool cmFileCommand::InitialPass(std::vector<std::string> const& args,
                                 cmExecutionStatus&)
@@ -136,6 +302,9 @@ bool cmFileCommand::InitialPass(std::vector<std::string> const& args,
   if (subCommand == "INSTALL") {
     return this->HandleInstallCommand(args);
   }
+  if (subCommand == "INSTALL_STATE") {
+    return this->HandleInstallStateCommand(args);
+  }
   if (subCommand == "DIFFERENT") {
     return this->HandleDifferentCommand(args);
   }
@@ -265,24 +434,6 @@ bool cmFileCommand::HandleReadCommand(std::vector<std::string> const& args)
 
   std::string variable = resultArg.GetString();
 
-// Open the specified file.
-#if defined(_WIN32) || defined(__CYGWIN__)
-  cmsys::ifstream file(
-    fileName.c_str(), std::ios::in |
-      (hexOutputArg.IsEnabled() ? std::ios::binary : std::ios::in));
-#else
-  cmsys::ifstream file(fileName.c_str());
-#endif
-
-  if (!file) {
-    std::string error = "failed to open for reading (";
-    error += cmSystemTools::GetLastSystemError();
-    error += "):\n  ";
-    error += fileName;
-    this->SetError(error);
-    return false;
-  }
-
   // is there a limit?
   long sizeLimit = -1;
   if (!limitArg.GetString().empty()) {
@@ -295,22 +446,49 @@ bool cmFileCommand::HandleReadCommand(std::vector<std::string> const& args)
     offset = atoi(offsetArg.GetCString());
   }
 
-  file.seekg(offset, std::ios::beg); // explicit ios::beg for IBM VisualAge 6
+  // Open the specified file.  Hex output reads the bytes of the file
+  // into memory, only as far as the limit.
+  cmFileBuffer buffer;
+  cmsys::ifstream file;
+  bool opened;
+  if (hexOutputArg.IsEnabled()) {
+    size_t maxSize = std::string::npos;
+    if (sizeLimit >= 0 && offset >= 0) {
+      maxSize = static_cast<size_t>(offset) + static_cast<size_t>(sizeLimit);
+    }
+    opened = buffer.Open(fileName, maxSize);
+  } else {
+    file.open(fileName.c_str());
+    opened = static_cast<bool>(file);
+  }
+
+  if (!opened) {
+    std::string error = "failed to open for reading (";
+    error += cmSystemTools::GetLastSystemError();
+    error += "):\n  ";
+    error += fileName;
+    this->SetError(error);
+    return false;
+  }
 
   std::string output;
 
   if (hexOutputArg.IsEnabled()) {
-    // Convert part of the file into hex code
-    char c;
-    while ((sizeLimit != 0) && (file.get(c))) {
-      char hex[4];
-      sprintf(hex, "%.2x", c & 0xff);
-      output += hex;
-      if (sizeLimit > 0) {
-        sizeLimit--;
+    // Convert part of the file into hex code.  A negative limit means
+    // no limit, and nothing can be read at a negative offset.
+    size_t const size = buffer.GetSize();
+    if (offset >= 0 && static_cast<size_t>(offset) < size) {
+      size_t count = size - static_cast<size_t>(offset);
+      if (sizeLimit >= 0 && static_cast<size_t>(sizeLimit) < count) {
+        count = static_cast<size_t>(sizeLimit);
       }
+      output.resize(count * 2);
+      cmFileCommandHexEncode(buffer.GetData() + offset, count, &output[0]);
     }
   } else {
+    // explicit ios::beg for IBM VisualAge 6
+    file.seekg(offset, std::ios::beg);
+
     std::string line;
     bool has_newline = false;
     while (sizeLimit != 0 && cmSystemTools::GetLineFromStream(
@@ -337,6 +515,9 @@ bool cmFileCommand::HandleReadCommand(std::vector<std::string> const& args)
 bool cmFileCommand::HandleHashCommand(std::vector<std::string> const& args)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (args.size() >= 4 && (args[2] == "FILES" || args[2] == "HASH_TREE")) {
+    return this->HandleHashFilesCommand(args);
+  }
   if (args.size() != 3) {
     std::ostringstream e;
     e << args[0] << " requires a file name and output variable";
@@ -365,6 +546,115 @@ bool cmFileCommand::HandleHashCommand(std::vector<std::string> const& args)
 #endif
 }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+// List the files below a directory by their paths relative to it.
+// Symbolic links to directories are not followed.
+static void cmFileCommandListTree(std::string const& dir,
+                                  std::string const& prefix,
+                                  std::vector<std::string>& names)
+{
+  cmsys::Directory d;
+  if (!d.Load(dir)) {
+    return;
+  }
+  for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
+    std::string const name = d.GetFile(i);
+    if (name == "." || name == "..") {
+      continue;
+    }
+    std::string const path = dir + "/" + name;
+    if (!cmSystemTools::FileIsDirectory(path)) {
+      names.push_back(prefix + name);
+    } else if (!cmSystemTools::FileIsSymlink(path)) {
+      cmFileCommandListTree(path, prefix + name + "/", names);
+    }
+  }
+}
+#endif
+
+bool cmFileCommand::HandleHashFilesCommand(
+  std::vector<std::string> const& args)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmCryptoHash::Algo algo;
+  if (!cmCryptoHash::AlgoFromName(args[0].c_str(), algo)) {
+    return false;
+  }
+  std::string const& outVar = args[1];
+  bool const tree = args[2] == "HASH_TREE";
+  if (tree && args.size() != 4) {
+    std::ostringstream e;
+    e << args[0] << " HASH_TREE requires exactly one directory";
+    this->SetError(e.str());
+    return false;
+  }
+
+  std::string const srcDir = this->Makefile->GetCurrentSourceDirectory();
+  std::vector<std::string> files;
+  std::vector<std::string> names;
+  if (tree) {
+    std::string dir = args[3];
+    if (!cmsys::SystemTools::FileIsFullPath(dir)) {
+      dir = srcDir + "/" + dir;
+    }
+    if (!cmSystemTools::FileIsDirectory(dir)) {
+      std::ostringstream e;
+      e << args[0] << " HASH_TREE given \"" << dir
+        << "\" which is not a directory";
+      this->SetError(e.str());
+      return false;
+    }
+
+    // Hash the files below the directory in the order of their paths.
+    cmFileCommandListTree(dir, std::string(), names);
+    std::sort(names.begin(), names.end());
+    for (std::string const& name : names) {
+      files.push_back(dir + "/" + name);
+    }
+  } else {
+    for (std::vector<std::string>::const_iterator i = args.begin() + 3;
+         i != args.end(); ++i) {
+      std::string file = *i;
+      if (!cmsys::SystemTools::FileIsFullPath(file)) {
+        file = srcDir + "/" + file;
+      }
+      files.push_back(std::move(file));
+    }
+  }
+
+  std::vector<std::string> const hashes =
+    cmSystemTools::ComputeFileHashes(files, algo);
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (hashes[i].empty()) {
+      std::ostringstream e;
+      e << args[0] << " failed to read file \"" << files[i] << "\"";
+      this->SetError(e.str());
+      return false;
+    }
+  }
+
+  std::string output;
+  if (tree) {
+    // Hash the lines that "cmake -E <hash>sum" prints for the files.
+    cmCryptoHash hash(algo);
+    hash.Initialize();
+    for (size_t i = 0; i < files.size(); ++i) {
+      hash.Append(hashes[i] + "  " + names[i] + "\n");
+    }
+    output = hash.FinalizeHex();
+  } else {
+    output = cmJoin(hashes, ";");
+  }
+  this->Makefile->AddDefinition(outVar, output.c_str());
+  return true;
+#else
+  std::ostringstream e;
+  e << args[0] << " not available during bootstrap";
+  this->SetError(e.str().c_str());
+  return false;
+#endif
+}
+
 bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
 {
   if (args.size() < 3) {
@@ -536,21 +826,21 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
     }
   }
 
-// Open the specified file.
-#if defined(_WIN32) || defined(__CYGWIN__)
-  cmsys::ifstream fin(fileName.c_str(), std::ios::in | std::ios::binary);
-#else
-  cmsys::ifstream fin(fileName.c_str());
-#endif
-  if (!fin) {
+  // Read the specified file, only as far as the input limit.  Read it as
+  // a binary file on all platforms.
+  cmFileBuffer buffer;
+  size_t const maxSize = limit_input >= 0 ? static_cast<size_t>(limit_input)
+                                          : std::string::npos;
+  if (!buffer.Open(fileName, maxSize)) {
     std::ostringstream e;
     e << "STRINGS file \"" << fileName << "\" cannot be read.";
     this->SetError(e.str());
     return false;
   }
+  cmFileCommandStringsInput fin(buffer.GetData(), buffer.GetSize());
 
   // If BOM is found and encoding was not specified, use the BOM
-  int bom_found = cmsys::FStream::ReadBOM(fin);
+  int bom_found = fin.ReadBOM();
   if (encoding == encoding_none && bom_found != cmsys::FStream::BOM_None) {
     encoding = bom_found;
   }
@@ -567,9 +857,55 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
   int output_size = 0;
   std::vector<std::string> strings;
   std::string s;
+
+  // Store the current string if it matches the requirements and reset
+  // it to empty.  Returns false if the output limit is reached.
+  auto storeString = [&]() -> bool {
+    if (s.length() >= minlen && (!have_regex || regex.find(s.c_str()))) {
+      output_size += static_cast<int>(s.size()) + 1;
+      if (limit_output >= 0 && output_size >= limit_output) {
+        s.clear();
+        return false;
+      }
+      strings.push_back(s);
+    }
+    s.clear();
+    return true;
+  };
+
   while ((!limit_count || strings.size() < limit_count) &&
          (limit_input < 0 || static_cast<int>(fin.tellg()) < limit_input) &&
          fin) {
+    if (bytes_rem == 0) {
+      // The input may not be read past the limit.
+      size_t run_max = static_cast<size_t>(-1);
+      if (limit_input >= 0) {
+        run_max = static_cast<size_t>(limit_input - fin.tellg());
+      }
+
+      // Skip bytes that neither end a string nor are part of one.
+      if (encoding == encoding_none && s.empty()) {
+        size_t const skip = fin.BinaryRun(run_max);
+        if (skip > 0) {
+          fin.Consume(skip);
+          continue;
+        }
+      }
+
+      // Append printable characters up to the maximum length at once.
+      if (maxlen > 0 && s.size() < maxlen) {
+        run_max = std::min<size_t>(run_max, maxlen - s.size());
+      }
+      size_t const run = fin.PrintableRun(run_max, newline_consume);
+      if (run > 0) {
+        s.append(fin.Consume(run), run);
+        if (maxlen > 0 && s.size() == maxlen && !storeString()) {
+          break;
+        }
+        continue;
+      }
+    }
+
     std::string current_str;
 
     int c = fin.get();
@@ -640,48 +976,25 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
       // The current line has been terminated.  Check if the current
       // string matches the requirements.  The length may now be as
       // low as zero since blank lines are allowed.
-      if (s.length() >= minlen && (!have_regex || regex.find(s.c_str()))) {
-        output_size += static_cast<int>(s.size()) + 1;
-        if (limit_output >= 0 && output_size >= limit_output) {
-          s.clear();
-          break;
-        }
-        strings.push_back(s);
+      if (!storeString()) {
+        break;
       }
-
-      // Reset the string to empty.
-      s.clear();
     } else if (current_str.empty()) {
       // A non-string character has been found.  Check if the current
       // string matches the requirements.  We require that the length
       // be at least one no matter what the user specified.
-      if (s.length() >= minlen && !s.empty() &&
-          (!have_regex || regex.find(s.c_str()))) {
-        output_size += static_cast<int>(s.size()) + 1;
-        if (limit_output >= 0 && output_size >= limit_output) {
-          s.clear();
-          break;
-        }
-        strings.push_back(s);
+      if (!s.empty() && !storeString()) {
+        break;
       }
-
-      // Reset the string to empty.
-      s.clear();
     } else {
       s += current_str;
     }
 
     if (maxlen > 0 && s.size() == maxlen) {
       // Terminate a string if the maximum length is reached.
-      if (s.length() >= minlen && (!have_regex || regex.find(s.c_str()))) {
-        output_size += static_cast<int>(s.size()) + 1;
-        if (limit_output >= 0 && output_size >= limit_output) {
-          s.clear();
-          break;
-        }
-        strings.push_back(s);
+      if (!storeString()) {
+        break;
       }
-      s.clear();
     }
   }
 
@@ -751,7 +1064,19 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
     }
   }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+  cmGlobCache& globCache = gg->GetGlobCache();
+  if (this->Makefile->IsOn("CMAKE_GLOB_SNAPSHOT")) {
+    globCache.UseSnapshotFile(this->Makefile->GetHomeOutputDirectory() +
+                              std::string("/CMakeFiles/GlobSnapshot.txt"));
+  }
+#endif
+
   std::string output;
+  std::string relative;
+  unsigned int followedSymlinks = 0;
+  bool configureDepends = false;
   bool first = true;
   for (; i != args.end(); ++i) {
     if (*i == "LIST_DIRECTORIES") {
@@ -792,6 +1117,7 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
         return false;
       }
       g.SetRelative(i->c_str());
+      relative = *i;
       ++i;
       if (i == args.end()) {
         this->SetError("GLOB requires a glob expression after the directory");
@@ -799,18 +1125,47 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
       }
     }
 
-    cmsys::Glob::GlobMessages globMessages;
+    if (*i == "CONFIGURE_DEPENDS") {
+      // The build checks the result, so there must be a build.
+      if (this->Makefile->GetCMakeInstance()->GetWorkingMode() !=
+          cmake::NORMAL_MODE) {
+        this->SetError("CONFIGURE_DEPENDS is invalid for script and find "
+                       "package modes.");
+        return false;
+      }
+      configureDepends = true;
+      ++i;
+      if (i == args.end()) {
+        this->SetError(
+          "GLOB requires a glob expression after CONFIGURE_DEPENDS");
+        return false;
+      }
+    }
+
+    std::string expr = *i;
     if (!cmsys::SystemTools::FileIsFullPath(*i)) {
-      std::string expr = this->Makefile->GetCurrentSourceDirectory();
+      expr = this->Makefile->GetCurrentSourceDirectory();
       // Handle script mode
       if (!expr.empty()) {
         expr += "/" + *i;
-        g.FindFiles(expr, &globMessages);
       } else {
-        g.FindFiles(*i, &globMessages);
+        expr = *i;
       }
-    } else {
-      g.FindFiles(*i, &globMessages);
+    }
+
+    cmsys::Glob::GlobMessages globMessages;
+    std::vector<std::string> cachedFiles;
+    bool cached = false;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    if (recurse) {
+      cached = globCache.FindFilesRecursive(
+        expr, g.GetRecurseThroughSymlinks(), g.GetRecurseListDirs(),
+        relative, gg->GetFindEpoch(), cachedFiles, followedSymlinks,
+        globMessages);
+    }
+#endif
+    if (!cached) {
+      g.FindFiles(expr, &globMessages);
     }
 
     if (!globMessages.empty()) {
@@ -834,7 +1189,7 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
     }
 
     std::vector<std::string>::size_type cc;
-    std::vector<std::string>& files = g.GetFiles();
+    std::vector<std::string>& files = cached ? cachedFiles : g.GetFiles();
     std::sort(files.begin(), files.end());
     for (cc = 0; cc < files.size(); cc++) {
       if (!first) {
@@ -843,6 +1198,18 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
       output += files[cc];
       first = false;
     }
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    if (configureDepends) {
+      cmListFileContext const lfc = this->Makefile->GetExecutionContext();
+      std::ostringstream origin;
+      origin << lfc.FilePath << ":" << lfc.Line;
+      globCache.AddConfigureDepends(
+        recurse, recurse ? g.GetRecurseListDirs() : g.GetListDirs(),
+        recurse && g.GetRecurseThroughSymlinks(), relative, expr,
+        cmJoin(files, ";"), origin.str());
+    }
+#endif
   }
 
   if (recurse && !explicitFollowSymlinks) {
@@ -858,7 +1225,7 @@ bool cmFileCommand::HandleGlobCommand(std::vector<std::string> const& args,
       case cmPolicies::WARN:
         // Possibly unexpected old behavior *and* we actually traversed
         // symlinks without being explicitly asked to: warn the author.
-        if (g.GetFollowedSymlinkCount() != 0) {
+        if (g.GetFollowedSymlinkCount() != 0 || followedSymlinks != 0) {
           this->Makefile->IssueMessage(
             cmake::AUTHOR_WARNING,
             cmPolicies::GetPolicyWarning(cmPolicies::CMP0009));
@@ -970,6 +1337,8 @@ struct cmFileCopier
     , MatchlessFiles(true)
     , FilePermissions(0)
     , DirPermissions(0)
+    , CopyJobsPosted(0)
+    , CopyFailed(false)
     , CurrentMatchRule(nullptr)
     , UseGivenPermissionsFile(false)
     , UseGivenPermissionsDir(false)
@@ -1084,6 +1453,27 @@ protected:
     return true;
   }
 
+  // Copies of files that are out of date run on worker threads, so they
+  // may finish in any order.  Permissions are set in order afterwards.
+  struct CopyJob
+  {
+    std::string FromFile;
+    std::string ToFile;
+    mode_t Permissions;
+    std::string Error;
+  };
+  std::deque<CopyJob> CopyJobs;
+  size_t CopyJobsPosted;
+  std::atomic<bool> CopyFailed;
+  std::set<std::string> CopyDestinations;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Declared after the jobs so that it finishes them before they go.
+  std::unique_ptr<cmWorkerPool> CopyPool;
+#endif
+  void RunCopyJob(CopyJob& job) const;
+  bool QueueCopy(CopyJob job);
+  bool FinishCopies();
+
   bool InstallSymlink(const char* fromFile, const char* toFile);
   bool InstallFile(const char* fromFile, const char* toFile,
                    MatchProperties match_properties);
@@ -1423,7 +1813,7 @@ bool cmFileCopier::Run(std::vector<std::string> const& args)
       return false;
     }
   }
-  return true;
+  return this->FinishCopies();
 }
 
 bool cmFileCopier::Install(const char* fromFile, const char* toFile)
@@ -1446,6 +1836,11 @@ bool cmFileCopier::Install(const char* fromFile, const char* toFile)
   if (cmSystemTools::SameFile(fromFile, toFile)) {
     return true;
   }
+  // Replace a file only after copying it earlier has finished.
+  if (this->CopyDestinations.find(toFile) != this->CopyDestinations.end() &&
+      !this->FinishCopies()) {
+    return false;
+  }
   if (cmSystemTools::FileIsSymlink(fromFile)) {
     return this->InstallSymlink(fromFile, toFile);
   }
@@ -1511,8 +1906,10 @@ bool cmFileCopier::InstallFile(const char* fromFile, const char* toFile,
   // Determine whether we will copy the file.
   bool copy = true;
   if (!this->Always) {
-    // If both files exist with the same time do not copy.
-    if (!this->FileTimes.FileTimesDiffer(fromFile, toFile)) {
+    // If both files exist with the same time and size do not copy.
+    if (!this->FileTimes.FileTimesDiffer(fromFile, toFile) &&
+        cmSystemTools::FileLength(fromFile) ==
+          cmSystemTools::FileLength(toFile)) {
       copy = false;
     }
   }
@@ -1520,42 +1917,122 @@ bool cmFileCopier::InstallFile(const char* fromFile, const char* toFile,
   // Inform the user about this file installation.
   this->ReportCopy(toFile, TypeFile, copy);
 
+  // Set permissions of the destination file.
+  mode_t permissions =
+    (match_properties.Permissions ? match_properties.Permissions
+                                  : this->FilePermissions);
+  if (!permissions) {
+    // No permissions were explicitly provided but the user requested
+    // that the source file permissions be used.
+    cmSystemTools::GetPermissions(fromFile, permissions);
+  }
+  if (!copy) {
+    return this->SetPermissions(toFile, permissions);
+  }
+
   // Copy the file.
-  if (copy && !cmSystemTools::CopyAFile(fromFile, toFile, true)) {
+  CopyJob job;
+  job.FromFile = fromFile;
+  job.ToFile = toFile;
+  job.Permissions = permissions;
+  return this->QueueCopy(std::move(job));
+}
+
+void cmFileCopier::RunCopyJob(CopyJob& job) const
+{
+  // This runs on a worker thread and must not use the makefile.
+  if (!cmSystemTools::CloneFile(job.FromFile, job.ToFile)) {
     std::ostringstream e;
-    e << this->Name << " cannot copy file \"" << fromFile << "\" to \""
-      << toFile << "\".";
-    this->FileCommand->SetError(e.str());
-    return false;
+    e << this->Name << " cannot copy file \"" << job.FromFile << "\" to \""
+      << job.ToFile << "\".";
+    job.Error = e.str();
+    return;
   }
 
   // Set the file modification time of the destination file.
-  if (copy && !this->Always) {
+  if (!this->Always) {
     // Add write permission so we can set the file time.
-    // Permissions are set unconditionally below anyway.
+    // Permissions are set unconditionally later anyway.
     mode_t perm = 0;
-    if (cmSystemTools::GetPermissions(toFile, perm)) {
-      cmSystemTools::SetPermissions(toFile, perm | mode_owner_write);
+    if (cmSystemTools::GetPermissions(job.ToFile, perm)) {
+      cmSystemTools::SetPermissions(job.ToFile, perm | mode_owner_write);
     }
-    if (!cmSystemTools::CopyFileTime(fromFile, toFile)) {
+    if (!cmSystemTools::CopyFileTime(job.FromFile.c_str(),
+                                     job.ToFile.c_str())) {
       std::ostringstream e;
-      e << this->Name << " cannot set modification time on \"" << toFile
+      e << this->Name << " cannot set modification time on \"" << job.ToFile
         << "\"";
-      this->FileCommand->SetError(e.str());
-      return false;
+      job.Error = e.str();
     }
   }
+}
 
-  // Set permissions of the destination file.
-  mode_t permissions =
-    (match_properties.Permissions ? match_properties.Permissions
-                                  : this->FilePermissions);
-  if (!permissions) {
-    // No permissions were explicitly provided but the user requested
-    // that the source file permissions be used.
-    cmSystemTools::GetPermissions(fromFile, permissions);
+bool cmFileCopier::QueueCopy(CopyJob job)
+{
+  // Queue no more copies after one failed, as a serial copy would stop.
+  if (this->CopyFailed) {
+    return this->FinishCopies();
+  }
+  this->CopyDestinations.insert(job.ToFile);
+  this->CopyJobs.push_back(std::move(job));
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Copying a single file needs no threads, so start them for the second.
+  if (this->CopyJobs.size() < 2) {
+    return true;
+  }
+  if (!this->CopyPool) {
+    unsigned int const threads = cmWorkerPool::GetHardwareThreads();
+    if (threads > 1) {
+      this->CopyPool.reset(new cmWorkerPool(threads, 4 * threads));
+    }
+  }
+  if (this->CopyPool) {
+    for (; this->CopyJobsPosted < this->CopyJobs.size();
+         ++this->CopyJobsPosted) {
+      CopyJob* queued = &this->CopyJobs[this->CopyJobsPosted];
+      this->CopyPool->Post([this, queued]() {
+        this->RunCopyJob(*queued);
+        if (!queued->Error.empty()) {
+          this->CopyFailed = true;
+        }
+      });
+    }
+    return true;
+  }
+#endif
+
+  return this->FinishCopies();
+}
+
+bool cmFileCopier::FinishCopies()
+{
+  for (; this->CopyJobsPosted < this->CopyJobs.size();
+       ++this->CopyJobsPosted) {
+    this->RunCopyJob(this->CopyJobs[this->CopyJobsPosted]);
+  }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (this->CopyPool) {
+    this->CopyPool->Wait();
+  }
+#endif
+
+  // Report the first failure as a serial copy would.
+  std::deque<CopyJob> jobs;
+  jobs.swap(this->CopyJobs);
+  this->CopyJobsPosted = 0;
+  this->CopyFailed = false;
+  this->CopyDestinations.clear();
+  for (CopyJob const& job : jobs) {
+    if (!job.Error.empty()) {
+      this->FileCommand->SetError(job.Error);
+      return false;
+    }
+    if (!this->SetPermissions(job.ToFile.c_str(), job.Permissions)) {
+      return false;
+    }
   }
-  return this->SetPermissions(toFile, permissions);
+  return true;
 }
 
 bool cmFileCopier::InstallDirectory(const char* source,
@@ -1628,7 +2105,11 @@ bool cmFileCopier::InstallDirectory(const char* source,
     }
   }
 
-  // Set the requested permissions of the destination directory.
+  // Set the requested permissions of the destination directory once
+  // the files in it are complete.
+  if (permissions_after && !this->FinishCopies()) {
+    return false;
+  }
   return this->SetPermissions(destination, permissions_after);
 }
 
@@ -1659,6 +2140,10 @@ struct cmFileInstaller : public cmFileCopier
     // Get the current manifest.
     this->Manifest =
       this->Makefile->GetSafeDefinition("CMAKE_INSTALL_MANIFEST_FILES");
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    // Record the files for the install script being run, if any.
+    this->State = &this->Makefile->GetGlobalGenerator()->GetInstallState();
+#endif
   }
   ~cmFileInstaller() override
   {
@@ -1675,6 +2160,9 @@ protected:
   bool MessageNever;
   int DestDirLength;
   std::string Rename;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  cmInstallState* State;
+#endif
 
   std::string Manifest;
   void ManifestAppend(std::string const& file)
@@ -1701,6 +2189,9 @@ protected:
       // Add the file to the manifest.
       this->ManifestAppend(toFile);
     }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    this->State->AddOutput(toFile, !this->MessageNever && !this->MessageLazy);
+#endif
   }
   bool ReportMissing(const char* fromFile) override
   {
@@ -1708,6 +2199,11 @@ protected:
   }
   bool Install(const char* fromFile, const char* toFile) override
   {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    if (*fromFile) {
+      this->State->AddInput(fromFile);
+    }
+#endif
     // Support installing from empty source to make a directory.
     if (this->InstallType == cmInstallType_DIRECTORY && !*fromFile) {
       return this->InstallDirectory(fromFile, toFile, MatchProperties());
@@ -2009,11 +2505,32 @@ bool cmFileInstaller::HandleInstallDestination()
   return true;
 }
 
+// Run a job for each of several files, on worker threads when there is
+// more than one.  The jobs must not use the cmMakefile.
+static void cmFileCommandForEachFile(std::vector<std::string> const& files,
+                                     std::function<void(size_t)> const& job)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  unsigned int const threads = cmWorkerPool::GetHardwareThreads();
+  if (threads > 1 && files.size() > 1) {
+    cmWorkerPool pool(threads, threads);
+    for (size_t i = 0; i < files.size(); ++i) {
+      pool.Post([&job, i]() { job(i); });
+    }
+    pool.Wait();
+    return;
+  }
+#endif
+  for (size_t i = 0; i < files.size(); ++i) {
+    job(i);
+  }
+}
+
 bool cmFileCommand::HandleRPathChangeCommand(
   std::vector<std::string> const& args)
 {
   // Evaluate arguments.
-  const char* file = nullptr;
+  std::vector<std::string> files;
   const char* oldRPath = nullptr;
   const char* newRPath = nullptr;
   enum Doing
@@ -2032,8 +2549,7 @@ bool cmFileCommand::HandleRPathChangeCommand(
     } else if (args[i] == "FILE") {
       doing = DoingFile;
     } else if (doing == DoingFile) {
-      file = args[i].c_str();
-      doing = DoingNone;
+      files.push_back(args[i]);
     } else if (doing == DoingOld) {
       oldRPath = args[i].c_str();
       doing = DoingNone;
@@ -2047,7 +2563,7 @@ bool cmFileCommand::HandleRPathChangeCommand(
       return false;
     }
   }
-  if (!file) {
+  if (files.empty()) {
     this->SetError("RPATH_CHANGE not given FILE option.");
     return false;
   }
@@ -2059,51 +2575,65 @@ bool cmFileCommand::HandleRPathChangeCommand(
     this->SetError("RPATH_CHANGE not given NEW_RPATH option.");
     return false;
   }
-  if (!cmSystemTools::FileExists(file, true)) {
-    std::ostringstream e;
-    e << "RPATH_CHANGE given FILE \"" << file << "\" that does not exist.";
-    this->SetError(e.str());
-    return false;
-  }
-  bool success = true;
-  cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
-  bool have_ft = cmSystemTools::FileTimeGet(file, ft);
-  std::string emsg;
-  bool changed;
-  if (!cmSystemTools::ChangeRPath(file, oldRPath, newRPath, &emsg, &changed)) {
-    std::ostringstream e;
-    /* clang-format off */
-    e << "RPATH_CHANGE could not write new RPATH:\n"
-      << "  " << newRPath << "\n"
-      << "to the file:\n"
-      << "  " << file << "\n"
-      << emsg;
-    /* clang-format on */
-    this->SetError(e.str());
-    success = false;
+  for (std::string const& file : files) {
+    if (!cmSystemTools::FileExists(file, true)) {
+      std::ostringstream e;
+      e << "RPATH_CHANGE given FILE \"" << file << "\" that does not exist.";
+      this->SetError(e.str());
+      return false;
+    }
   }
-  if (success) {
-    if (changed) {
+
+  // Each file is parsed once to both check and change its RPATH.
+  std::vector<std::string> emsgs(files.size());
+  std::vector<char> results(files.size(), 0);
+  std::vector<char> changes(files.size(), 0);
+  cmFileCommandForEachFile(files, [&](size_t i) {
+    std::string const& file = files[i];
+    cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
+    bool have_ft = cmSystemTools::FileTimeGet(file.c_str(), ft);
+    bool changed = false;
+    if (cmSystemTools::ChangeRPath(file, oldRPath, newRPath, &emsgs[i],
+                                   &changed)) {
+      results[i] = 1;
+      changes[i] = changed ? 1 : 0;
+      if (have_ft) {
+        cmSystemTools::FileTimeSet(file.c_str(), ft);
+      }
+    }
+    cmSystemTools::FileTimeDelete(ft);
+  });
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!results[i]) {
+      std::ostringstream e;
+      /* clang-format off */
+      e << "RPATH_CHANGE could not write new RPATH:\n"
+        << "  " << newRPath << "\n"
+        << "to the file:\n"
+        << "  " << files[i] << "\n"
+        << emsgs[i];
+      /* clang-format on */
+      this->SetError(e.str());
+      return false;
+    }
+    if (changes[i]) {
       std::string message = "Set runtime path of \"";
-      message += file;
+      message += files[i];
       message += "\" to \"";
       message += newRPath;
       message += "\"";
       this->Makefile->DisplayStatus(message.c_str(), -1);
     }
-    if (have_ft) {
-      cmSystemTools::FileTimeSet(file, ft);
-    }
   }
-  cmSystemTools::FileTimeDelete(ft);
-  return success;
+  return true;
 }
 
 bool cmFileCommand::HandleRPathRemoveCommand(
   std::vector<std::string> const& args)
 {
   // Evaluate arguments.
-  const char* file = nullptr;
+  std::vector<std::string> files;
   enum Doing
   {
     DoingNone,
@@ -2114,8 +2644,7 @@ bool cmFileCommand::HandleRPathRemoveCommand(
     if (args[i] == "FILE") {
       doing = DoingFile;
     } else if (doing == DoingFile) {
-      file = args[i].c_str();
-      doing = DoingNone;
+      files.push_back(args[i]);
     } else {
       std::ostringstream e;
       e << "RPATH_REMOVE given unknown argument " << args[i];
@@ -2123,51 +2652,63 @@ bool cmFileCommand::HandleRPathRemoveCommand(
       return false;
     }
   }
-  if (!file) {
+  if (files.empty()) {
     this->SetError("RPATH_REMOVE not given FILE option.");
     return false;
   }
-  if (!cmSystemTools::FileExists(file, true)) {
-    std::ostringstream e;
-    e << "RPATH_REMOVE given FILE \"" << file << "\" that does not exist.";
-    this->SetError(e.str());
-    return false;
-  }
-  bool success = true;
-  cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
-  bool have_ft = cmSystemTools::FileTimeGet(file, ft);
-  std::string emsg;
-  bool removed;
-  if (!cmSystemTools::RemoveRPath(file, &emsg, &removed)) {
-    std::ostringstream e;
-    /* clang-format off */
-    e << "RPATH_REMOVE could not remove RPATH from file:\n"
-      << "  " << file << "\n"
-      << emsg;
-    /* clang-format on */
-    this->SetError(e.str());
-    success = false;
+  for (std::string const& file : files) {
+    if (!cmSystemTools::FileExists(file, true)) {
+      std::ostringstream e;
+      e << "RPATH_REMOVE given FILE \"" << file << "\" that does not exist.";
+      this->SetError(e.str());
+      return false;
+    }
   }
-  if (success) {
-    if (removed) {
+
+  std::vector<std::string> emsgs(files.size());
+  std::vector<char> results(files.size(), 0);
+  std::vector<char> removals(files.size(), 0);
+  cmFileCommandForEachFile(files, [&](size_t i) {
+    std::string const& file = files[i];
+    cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
+    bool have_ft = cmSystemTools::FileTimeGet(file.c_str(), ft);
+    bool removed = false;
+    if (cmSystemTools::RemoveRPath(file, &emsgs[i], &removed)) {
+      results[i] = 1;
+      removals[i] = removed ? 1 : 0;
+      if (have_ft) {
+        cmSystemTools::FileTimeSet(file.c_str(), ft);
+      }
+    }
+    cmSystemTools::FileTimeDelete(ft);
+  });
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!results[i]) {
+      std::ostringstream e;
+      /* clang-format off */
+      e << "RPATH_REMOVE could not remove RPATH from file:\n"
+        << "  " << files[i] << "\n"
+        << emsgs[i];
+      /* clang-format on */
+      this->SetError(e.str());
+      return false;
+    }
+    if (removals[i]) {
       std::string message = "Removed runtime path from \"";
-      message += file;
+      message += files[i];
       message += "\"";
       this->Makefile->DisplayStatus(message.c_str(), -1);
     }
-    if (have_ft) {
-      cmSystemTools::FileTimeSet(file, ft);
-    }
   }
-  cmSystemTools::FileTimeDelete(ft);
-  return success;
+  return true;
 }
 
 bool cmFileCommand::HandleRPathCheckCommand(
   std::vector<std::string> const& args)
 {
   // Evaluate arguments.
-  const char* file = nullptr;
+  std::vector<std::string> files;
   const char* rpath = nullptr;
   enum Doing
   {
@@ -2182,8 +2723,7 @@ bool cmFileCommand::HandleRPathCheckCommand(
     } else if (args[i] == "FILE") {
       doing = DoingFile;
     } else if (doing == DoingFile) {
-      file = args[i].c_str();
-      doing = DoingNone;
+      files.push_back(args[i]);
     } else if (doing == DoingRPath) {
       rpath = args[i].c_str();
       doing = DoingNone;
@@ -2194,7 +2734,7 @@ bool cmFileCommand::HandleRPathCheckCommand(
       return false;
     }
   }
-  if (!file) {
+  if (files.empty()) {
     this->SetError("RPATH_CHECK not given FILE option.");
     return false;
   }
@@ -2206,10 +2746,13 @@ bool cmFileCommand::HandleRPathCheckCommand(
   // If the file exists but does not have the desired RPath then
   // delete it.  This is used during installation to re-install a file
   // if its RPath will change.
-  if (cmSystemTools::FileExists(file, true) &&
-      !cmSystemTools::CheckRPath(file, rpath)) {
-    cmSystemTools::RemoveFile(file);
-  }
+  cmFileCommandForEachFile(files, [&](size_t i) {
+    std::string const& file = files[i];
+    if (cmSystemTools::FileExists(file, true) &&
+        !cmSystemTools::CheckRPath(file, rpath)) {
+      cmSystemTools::RemoveFile(file);
+    }
+  });
 
   return true;
 }
@@ -2281,6 +2824,78 @@ bool cmFileCommand::HandleInstallCommand(std::vector<std::string> const& args)
   return installer.Run(args);
 }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+// Variables set by the install rules for the code that runs them.
+static const char* const cmFileCommandInstallStateVariables[] = {
+  "CMAKE_INSTALL_MANIFEST_FILES", "CMAKE_ABSOLUTE_DESTINATION_FILES"
+};
+#endif
+
+bool cmFileCommand::HandleInstallStateCommand(
+  std::vector<std::string> const& args)
+{
+  // Evaluate arguments.
+  //   file(INSTALL_STATE BEGIN <dir> <result-var> <settings>...)
+  //   file(INSTALL_STATE END)
+  if (args[1] == "END" && args.size() == 2) {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    // Keep the variables the install rules set for their callers.
+    cmInstallState::Variables variables;
+    for (const char* name : cmFileCommandInstallStateVariables) {
+      if (const char* value = this->Makefile->GetDefinition(name)) {
+        variables.emplace_back(name, value);
+      }
+    }
+    this->Makefile->GetGlobalGenerator()->GetInstallState().Finish(
+      this->Makefile->GetListFiles(), variables);
+#endif
+    return true;
+  }
+  if (args[1] != "BEGIN" || args.size() < 4) {
+    this->SetError("INSTALL_STATE must be given BEGIN <dir> <result-var> "
+                   "[<settings>...] or END.");
+    return false;
+  }
+  std::string const& resultVar = args[3];
+  this->Makefile->AddDefinition(resultVar, false);
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Files installed always are never up to date, and warnings about
+  // absolute destinations must be issued each time.
+  std::string install_always;
+  if ((cmSystemTools::GetEnv("CMAKE_INSTALL_ALWAYS", install_always) &&
+       cmSystemTools::IsOn(install_always.c_str())) ||
+      this->Makefile->IsOn("CMAKE_WARN_ON_ABSOLUTE_INSTALL_DESTINATION")) {
+    return true;
+  }
+
+  // Each combination of settings has its own state.
+  std::string const settings = cmJoin(cmMakeRange(args).advance(4), ";");
+  std::string const file = args[2] + "/" +
+    cmCryptoHash(cmCryptoHash::AlgoMD5).HashString(settings) + ".txt";
+
+  cmInstallState& state =
+    this->Makefile->GetGlobalGenerator()->GetInstallState();
+  if (!state.Load(file, settings)) {
+    state.Start(file, settings);
+    return true;
+  }
+
+  // Report the files as the install rules would.
+  for (cmInstallState::Output const& output : state.GetOutputs()) {
+    if (output.ReportUpToDate) {
+      std::string const message = "Up-to-date: " + output.Path;
+      this->Makefile->DisplayStatus(message.c_str(), -1);
+    }
+  }
+  for (auto const& v : state.GetVariables()) {
+    this->Makefile->AddDefinition(v.first, v.second.c_str());
+  }
+  this->Makefile->AddDefinition(resultVar, true);
+#endif
+  return true;
+}
+
 bool cmFileCommand::HandleRelativePathCommand(
   std::vector<std::string> const& args)
 {
@@ -353,7 +353,7 @@ bool cmFindLibraryHelper::CheckDirectoryForName(std::string const& path,
   if (name.TryRaw) {
     this->TestPath = path;
     this->TestPath += name.Raw;
-    if (cmSystemTools::FileExists(this->TestPath, true)) {
+    if (this->GG->FindFileExists(this->TestPath, true)) {
       this->BestPath = cmSystemTools::CollapseFullPath(this->TestPath);
       cmSystemTools::ConvertToUnixSlashes(this->BestPath);
       return true;
@@ -369,7 +369,7 @@ bool cmFindLibraryHelper::CheckDirectoryForName(std::string const& path,
   // Search for a file matching the library name regex.
   std::string dir = path;
   cmSystemTools::ConvertToUnixSlashes(dir);
-  std::set<std::string> const& files = this->GG->GetDirectoryContent(dir);
+  std::set<std::string> const& files = this->GG->GetFindDirectoryContent(dir);
   for (std::string const& origName : files) {
 #if defined(_WIN32) || defined(__APPLE__)
     std::string testName = cmSystemTools::LowerCase(origName);
@@ -464,6 +464,7 @@ std::string cmFindLibraryCommand::FindFrameworkLibrary()
 
 std::string cmFindLibraryCommand::FindFrameworkLibraryNamesPerDir()
 {
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
   std::string fwPath;
   // Search for all names in each search path.
   for (std::string const& d : this->SearchPaths) {
@@ -471,7 +472,8 @@ std::string cmFindLibraryCommand::FindFrameworkLibraryNamesPerDir()
       fwPath = d;
       fwPath += n;
       fwPath += ".framework";
-      if (cmSystemTools::FileIsDirectory(fwPath)) {
+      if (gg->FindFileExists(fwPath) &&
+          cmSystemTools::FileIsDirectory(fwPath)) {
         return cmSystemTools::CollapseFullPath(fwPath);
       }
     }
@@ -483,6 +485,7 @@ std::string cmFindLibraryCommand::FindFrameworkLibraryNamesPerDir()
 
 std::string cmFindLibraryCommand::FindFrameworkLibraryDirsPerName()
 {
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
   std::string fwPath;
   // Search for each name in all search paths.
   for (std::string const& n : this->Names) {
@@ -490,7 +493,8 @@ std::string cmFindLibraryCommand::FindFrameworkLibraryDirsPerName()
       fwPath = d;
       fwPath += n;
       fwPath += ".framework";
-      if (cmSystemTools::FileIsDirectory(fwPath)) {
+      if (gg->FindFileExists(fwPath) &&
+          cmSystemTools::FileIsDirectory(fwPath)) {
         return cmSystemTools::CollapseFullPath(fwPath);
       }
     }
@@ -16,10 +16,12 @@
 #include <memory> // IWYU pragma: keep
 #include <sstream>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <utility>
 
 #include "cmAlgorithms.h"
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSearchPath.h"
 #include "cmState.h"
@@ -27,6 +29,10 @@
 #include "cmVersion.h"
 #include "cmake.h"
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#include "cmFindPackageIndex.h"
+#endif
+
 #if defined(__HAIKU__)
 #include <FindDirectory.h>
 #include <StorageDefs.h>
@@ -91,6 +97,7 @@ cmFindPackageCommand::cmFindPackageCommand()
   this->UseConfigFiles = true;
   this->UseFindModules = true;
   this->DebugMode = false;
+  this->Index = nullptr;
   this->UseLib32Paths = false;
   this->UseLib64Paths = false;
   this->UseLibx32Paths = false;
@@ -192,6 +199,20 @@ bool cmFindPackageCommand::InitialPass(std::vector<std::string> const& args,
     this->NoSystemRegistry = true;
   }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Check if directory listings of search prefixes should be kept.
+  this->IndexDir =
+    this->Makefile->GetSafeDefinition("CMAKE_FIND_PACKAGE_INDEX_DIR");
+  if (this->IndexDir.empty()) {
+    cmSystemTools::GetEnv("CMAKE_FIND_PACKAGE_INDEX_DIR", this->IndexDir);
+  }
+  if (!this->IndexDir.empty()) {
+    this->IndexDir = cmSystemTools::CollapseFullPath(this->IndexDir);
+    this->Index =
+      &this->Makefile->GetGlobalGenerator()->GetFindPackageIndex();
+  }
+#endif
+
   // Check if Sorting should be enabled
   if (const char* so =
         this->Makefile->GetDefinition("CMAKE_FIND_PACKAGE_SORT_ORDER")) {
@@ -1442,13 +1463,23 @@ bool cmFindPackageCommand::FindConfigFile(std::string const& dir,
     if (this->DebugMode) {
       fprintf(stderr, "Checking file [%s]\n", file.c_str());
     }
-    if (cmSystemTools::FileExists(file, true) && this->CheckVersion(file)) {
+    if (this->ConfigFileExists(file) && this->CheckVersion(file)) {
       return true;
     }
   }
   return false;
 }
 
+bool cmFindPackageCommand::ConfigFileExists(std::string const& file)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (this->Index && this->Index->IsActive()) {
+    return this->Index->FileExists(file);
+  }
+#endif
+  return cmSystemTools::FileExists(file, true);
+}
+
 bool cmFindPackageCommand::CheckVersion(std::string const& config_file)
 {
   bool result = false; // by default, assume the version is not ok.
@@ -1462,7 +1493,7 @@ bool cmFindPackageCommand::CheckVersion(std::string const& config_file)
   // Look for foo-config-version.cmake
   std::string version_file = version_file_base;
   version_file += "-version.cmake";
-  if (!haveResult && cmSystemTools::FileExists(version_file, true)) {
+  if (!haveResult && this->ConfigFileExists(version_file)) {
     result = this->CheckVersionFile(version_file, version);
     haveResult = true;
   }
@@ -1470,7 +1501,7 @@ bool cmFindPackageCommand::CheckVersion(std::string const& config_file)
   // Look for fooConfigVersion.cmake
   version_file = version_file_base;
   version_file += "Version.cmake";
-  if (!haveResult && cmSystemTools::FileExists(version_file, true)) {
+  if (!haveResult && this->ConfigFileExists(version_file)) {
     result = this->CheckVersionFile(version_file, version);
     haveResult = true;
   }
@@ -1491,42 +1522,25 @@ bool cmFindPackageCommand::CheckVersion(std::string const& config_file)
 bool cmFindPackageCommand::CheckVersionFile(std::string const& version_file,
                                             std::string& result_version)
 {
-  // The version file will be loaded in an isolated scope.
-  cmMakefile::ScopePushPop varScope(this->Makefile);
-  cmMakefile::PolicyPushPop polScope(this->Makefile);
-  static_cast<void>(varScope);
-  static_cast<void>(polScope);
-
-  // Clear the output variables.
-  this->Makefile->RemoveDefinition("PACKAGE_VERSION");
-  this->Makefile->RemoveDefinition("PACKAGE_VERSION_UNSUITABLE");
-  this->Makefile->RemoveDefinition("PACKAGE_VERSION_COMPATIBLE");
-  this->Makefile->RemoveDefinition("PACKAGE_VERSION_EXACT");
-
-  // Set the input variables.
-  this->Makefile->AddDefinition("PACKAGE_FIND_NAME", this->Name.c_str());
-  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION", this->Version.c_str());
-  char buf[64];
-  sprintf(buf, "%u", this->VersionMajor);
-  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_MAJOR", buf);
-  sprintf(buf, "%u", this->VersionMinor);
-  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_MINOR", buf);
-  sprintf(buf, "%u", this->VersionPatch);
-  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_PATCH", buf);
-  sprintf(buf, "%u", this->VersionTweak);
-  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_TWEAK", buf);
-  sprintf(buf, "%u", this->VersionCount);
-  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_COUNT", buf);
+  // Version files written by write_basic_package_version_file() are
+  // evaluated without running them.  Traces must show the commands.
+  VersionFileResult versionResult;
+  bool loaded = false;
+  if (!this->Makefile->GetCMakeInstance()->GetTrace() &&
+      this->EvaluateBasicConfigVersionFile(version_file, versionResult)) {
+    this->Makefile->AddCMakeDependFile(version_file);
+    loaded = true;
+  } else {
+    loaded = this->ReadVersionFile(version_file, versionResult);
+  }
 
-  // Load the version check file.  Pass NoPolicyScope because we do
-  // our own policy push/pop independent of CMP0011.
   bool suitable = false;
-  if (this->ReadListFile(version_file.c_str(), NoPolicyScope)) {
+  if (loaded) {
     // Check the output variables.
-    bool okay = this->Makefile->IsOn("PACKAGE_VERSION_EXACT");
-    bool unsuitable = this->Makefile->IsOn("PACKAGE_VERSION_UNSUITABLE");
+    bool okay = versionResult.Exact;
+    bool unsuitable = versionResult.Unsuitable;
     if (!okay && !this->VersionExact) {
-      okay = this->Makefile->IsOn("PACKAGE_VERSION_COMPATIBLE");
+      okay = versionResult.Compatible;
     }
 
     // The package is suitable if the version is okay and not
@@ -1534,8 +1548,7 @@ bool cmFindPackageCommand::CheckVersionFile(std::string const& version_file,
     suitable = !unsuitable && (okay || this->Version.empty());
     if (suitable) {
       // Get the version found.
-      this->VersionFound =
-        this->Makefile->GetSafeDefinition("PACKAGE_VERSION");
+      this->VersionFound = versionResult.Version;
 
       // Try to parse the version number and store the results that were
       // successfully parsed.
@@ -1565,7 +1578,7 @@ bool cmFindPackageCommand::CheckVersionFile(std::string const& version_file,
     }
   }
 
-  result_version = this->Makefile->GetSafeDefinition("PACKAGE_VERSION");
+  result_version = versionResult.Version;
   if (result_version.empty()) {
     result_version = "unknown";
   }
@@ -1574,6 +1587,253 @@ bool cmFindPackageCommand::CheckVersionFile(std::string const& version_file,
   return suitable;
 }
 
+bool cmFindPackageCommand::ReadVersionFile(std::string const& version_file,
+                                           VersionFileResult& result)
+{
+  // The version file will be loaded in an isolated scope.
+  cmMakefile::ScopePushPop varScope(this->Makefile);
+  cmMakefile::PolicyPushPop polScope(this->Makefile);
+  static_cast<void>(varScope);
+  static_cast<void>(polScope);
+
+  // Clear the output variables.
+  this->Makefile->RemoveDefinition("PACKAGE_VERSION");
+  this->Makefile->RemoveDefinition("PACKAGE_VERSION_UNSUITABLE");
+  this->Makefile->RemoveDefinition("PACKAGE_VERSION_COMPATIBLE");
+  this->Makefile->RemoveDefinition("PACKAGE_VERSION_EXACT");
+
+  // Set the input variables.
+  this->Makefile->AddDefinition("PACKAGE_FIND_NAME", this->Name.c_str());
+  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION", this->Version.c_str());
+  char buf[64];
+  sprintf(buf, "%u", this->VersionMajor);
+  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_MAJOR", buf);
+  sprintf(buf, "%u", this->VersionMinor);
+  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_MINOR", buf);
+  sprintf(buf, "%u", this->VersionPatch);
+  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_PATCH", buf);
+  sprintf(buf, "%u", this->VersionTweak);
+  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_TWEAK", buf);
+  sprintf(buf, "%u", this->VersionCount);
+  this->Makefile->AddDefinition("PACKAGE_FIND_VERSION_COUNT", buf);
+
+  // Load the version check file.  Pass NoPolicyScope because we do
+  // our own policy push/pop independent of CMP0011.
+  bool loaded = this->ReadListFile(version_file.c_str(), NoPolicyScope);
+  if (loaded) {
+    result.Exact = this->Makefile->IsOn("PACKAGE_VERSION_EXACT");
+    result.Compatible = this->Makefile->IsOn("PACKAGE_VERSION_COMPATIBLE");
+    result.Unsuitable = this->Makefile->IsOn("PACKAGE_VERSION_UNSUITABLE");
+  }
+  result.Version = this->Makefile->GetSafeDefinition("PACKAGE_VERSION");
+  return loaded;
+}
+
+namespace {
+// A version file template of write_basic_package_version_file() split
+// at its @VAR@ placeholders.  Text has one more element than Vars.
+struct cmBasicConfigVersionTemplate
+{
+  std::string Compatibility;
+  std::vector<std::string> Text;
+  std::vector<std::string> Vars;
+};
+}
+
+static std::vector<cmBasicConfigVersionTemplate> const&
+cmFindPackageGetBasicConfigVersionTemplates()
+{
+  static std::vector<cmBasicConfigVersionTemplate> templates;
+  static bool loaded = false;
+  if (loaded) {
+    return templates;
+  }
+  loaded = true;
+
+  static const char* const compatibilities[] = {
+    "AnyNewerVersion", "SameMajorVersion", "SameMinorVersion",
+    "ExactVersion"
+  };
+  for (const char* compatibility : compatibilities) {
+    std::string const path = cmSystemTools::GetCMakeRoot() +
+      "/Modules/BasicConfigVersion-" + compatibility + ".cmake.in";
+    cmsys::ifstream fin(path.c_str());
+    if (!fin) {
+      continue;
+    }
+
+    // Read the template as configure_file() does.
+    std::string content;
+    std::string line;
+    while (cmSystemTools::GetLineFromStream(fin, line)) {
+      content += line;
+      content += "\n";
+    }
+
+    cmBasicConfigVersionTemplate t;
+    t.Compatibility = compatibility;
+    std::string::size_type pos = 0;
+    for (;;) {
+      std::string::size_type const begin = content.find("@CVF_VERSION@", pos);
+      std::string::size_type const sizeofBegin =
+        content.find("@CMAKE_SIZEOF_VOID_P@", pos);
+      std::string::size_type const next = std::min(begin, sizeofBegin);
+      if (next == std::string::npos) {
+        break;
+      }
+      std::string const var =
+        next == begin ? "CVF_VERSION" : "CMAKE_SIZEOF_VOID_P";
+      t.Text.push_back(content.substr(pos, next - pos));
+      t.Vars.push_back(var);
+      pos = next + var.size() + 2;
+    }
+    t.Text.push_back(content.substr(pos));
+
+    // The evaluation below knows only these placeholders.
+    if (t.Text.back().find('@') == std::string::npos &&
+        std::none_of(t.Text.begin(), t.Text.end() - 1,
+                     [](std::string const& text) {
+                       return text.find('@') != std::string::npos;
+                     })) {
+      templates.push_back(std::move(t));
+    }
+  }
+  return templates;
+}
+
+static bool cmFindPackageMatchBasicConfigVersion(
+  cmBasicConfigVersionTemplate const& t, std::string const& content,
+  std::map<std::string, std::string>& values)
+{
+  if (content.compare(0, t.Text[0].size(), t.Text[0]) != 0) {
+    return false;
+  }
+  std::string::size_type pos = t.Text[0].size();
+  for (size_t i = 0; i < t.Vars.size(); ++i) {
+    std::string const& text = t.Text[i + 1];
+    std::string::size_type const end = (i + 2 == t.Text.size())
+      ? content.size() - std::min(content.size(), text.size())
+      : content.find(text, pos);
+    if (end == std::string::npos || end < pos ||
+        content.compare(end, text.size(), text) != 0) {
+      return false;
+    }
+    std::string const value = content.substr(pos, end - pos);
+    auto const inserted = values.insert(std::make_pair(t.Vars[i], value));
+    if (!inserted.second && inserted.first->second != value) {
+      return false;
+    }
+    pos = end + text.size();
+  }
+  return pos == content.size();
+}
+
+bool cmFindPackageCommand::EvaluateBasicConfigVersionFile(
+  std::string const& version_file, VersionFileResult& result)
+{
+  std::vector<cmBasicConfigVersionTemplate> const& templates =
+    cmFindPackageGetBasicConfigVersionTemplates();
+  if (templates.empty()) {
+    return false;
+  }
+
+  std::string content;
+  {
+    cmsys::ifstream fin(version_file.c_str(),
+                        std::ios::in | std::ios::binary);
+    if (!fin) {
+      return false;
+    }
+    std::ostringstream ss;
+    ss << fin.rdbuf();
+    content = ss.str();
+  }
+
+  cmBasicConfigVersionTemplate const* match = nullptr;
+  std::map<std::string, std::string> values;
+  for (cmBasicConfigVersionTemplate const& t : templates) {
+    values.clear();
+    if (cmFindPackageMatchBasicConfigVersion(t, content, values)) {
+      match = &t;
+      break;
+    }
+  }
+  if (!match) {
+    return false;
+  }
+
+  // Values that CMake code would treat specially, for example by
+  // expanding a variable reference, are left to the script.
+  std::string const& version = values["CVF_VERSION"];
+  std::string const& sizeofVoidP = values["CMAKE_SIZEOF_VOID_P"];
+  cmsys::RegularExpression versionChars("^[A-Za-z0-9_.+-]*$");
+  cmsys::RegularExpression sizeofChars("^[0-9]?[0-9]?$");
+  if (!versionChars.find(version) || !sizeofChars.find(sizeofVoidP)) {
+    return false;
+  }
+
+  // Mirror the code of the templates.
+  std::string const& findVersion = this->Version;
+  char buf[64];
+  sprintf(buf, "%u", this->VersionMajor);
+  std::string const findMajor = buf;
+  sprintf(buf, "%u", this->VersionMinor);
+  std::string const findMinor = buf;
+
+  result.Version = version;
+  bool const older = cmSystemTools::VersionCompare(
+    cmSystemTools::OP_LESS, version.c_str(), findVersion.c_str());
+  if (match->Compatibility == "AnyNewerVersion") {
+    result.Compatible = !older;
+    result.Exact = !older && findVersion == version;
+  } else if (match->Compatibility == "SameMajorVersion") {
+    cmsys::RegularExpression majorRegex("^([0-9]+)\\.");
+    std::string major = version;
+    if (majorRegex.find(version)) {
+      major = majorRegex.match(1);
+    }
+    result.Compatible = !older && findMajor == major;
+    result.Exact = !older && findVersion == version;
+  } else if (match->Compatibility == "SameMinorVersion") {
+    cmsys::RegularExpression minorRegex("^([0-9]+)\\.([0-9]+)");
+    std::string major = version;
+    std::string minor;
+    if (minorRegex.find(version)) {
+      major = minorRegex.match(1);
+      minor = minorRegex.match(2);
+    }
+    result.Compatible = !older && findMajor == major && findMinor == minor;
+    result.Exact = !older && findVersion == version;
+  } else if (match->Compatibility == "ExactVersion") {
+    cmsys::RegularExpression noTweakRegex(
+      "^([0-9]+\\.[0-9]+\\.[0-9]+)\\.");
+    std::string versionNoTweak = version;
+    if (noTweakRegex.find(version)) {
+      versionNoTweak = noTweakRegex.match(1);
+    }
+    std::string findVersionNoTweak = findVersion;
+    if (noTweakRegex.find(findVersion)) {
+      findVersionNoTweak = noTweakRegex.match(1);
+    }
+    result.Compatible = findVersionNoTweak == versionNoTweak;
+    result.Exact = findVersion == version;
+  } else {
+    return false;
+  }
+
+  std::string const currentSizeofVoidP =
+    this->Makefile->GetSafeDefinition("CMAKE_SIZEOF_VOID_P");
+  if (!currentSizeofVoidP.empty() && !sizeofVoidP.empty() &&
+      currentSizeofVoidP != sizeofVoidP) {
+    sprintf(buf, "%d", atoi(sizeofVoidP.c_str()) * 8);
+    result.Version += " (";
+    result.Version += buf;
+    result.Version += "bit)";
+    result.Unsuitable = true;
+  }
+  return true;
+}
+
 void cmFindPackageCommand::StoreVersionFound()
 {
   // Store the whole version string.
@@ -1606,6 +1866,8 @@ public:
 
 protected:
   bool Consider(std::string const& fullPath, cmFileList& listing);
+  void LoadDirectory(std::string const& dir, cmFileList& listing,
+                     std::vector<std::string>& names);
 
 private:
   bool Search(cmFileList&);
@@ -1643,6 +1905,20 @@ public:
     return false;
   }
 
+protected:
+  virtual void LoadDirectory(std::string const& dir,
+                             std::vector<std::string>& names)
+  {
+    cmsys::Directory d;
+    d.Load(dir);
+    for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
+      const char* fname = d.GetFile(i);
+      if (strcmp(fname, ".") != 0 && strcmp(fname, "..") != 0) {
+        names.push_back(fname);
+      }
+    }
+  }
+
 private:
   virtual bool Visit(std::string const& fullPath) = 0;
   friend class cmFileListGeneratorBase;
@@ -1668,6 +1944,17 @@ private:
     }
     return this->FPC->CheckDirectory(fullPath);
   }
+  void LoadDirectory(std::string const& dir,
+                     std::vector<std::string>& names) override
+  {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    if (this->FPC->Index && this->FPC->Index->IsActive()) {
+      this->FPC->Index->GetDirectoryContent(dir, names);
+      return;
+    }
+#endif
+    this->cmFileList::LoadDirectory(dir, names);
+  }
   cmFindPackageCommand* FPC;
   bool UseSuffixes;
 };
@@ -1693,6 +1980,13 @@ bool cmFileListGeneratorBase::Consider(std::string const& fullPath,
   return listing.Visit(fullPath + "/");
 }
 
+void cmFileListGeneratorBase::LoadDirectory(std::string const& dir,
+                                            cmFileList& listing,
+                                            std::vector<std::string>& names)
+{
+  listing.LoadDirectory(dir, names);
+}
+
 class cmFileListGeneratorFixed : public cmFileListGeneratorBase
 {
 public:
@@ -1791,15 +2085,12 @@ private:
   {
     // Construct a list of matches.
     std::vector<std::string> matches;
-    cmsys::Directory d;
-    d.Load(parent);
-    for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
-      const char* fname = d.GetFile(i);
-      if (strcmp(fname, ".") == 0 || strcmp(fname, "..") == 0) {
-        continue;
-      }
+    std::vector<std::string> names;
+    this->LoadDirectory(parent, lister, names);
+    for (std::string const& fname : names) {
       for (std::string const& n : this->Names) {
-        if (cmsysString_strncasecmp(fname, n.c_str(), n.length()) == 0) {
+        if (cmsysString_strncasecmp(fname.c_str(), n.c_str(), n.length()) ==
+            0) {
           matches.push_back(fname);
         }
       }
@@ -1851,16 +2142,12 @@ private:
   {
     // Construct a list of matches.
     std::vector<std::string> matches;
-    cmsys::Directory d;
-    d.Load(parent);
-    for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
-      const char* fname = d.GetFile(i);
-      if (strcmp(fname, ".") == 0 || strcmp(fname, "..") == 0) {
-        continue;
-      }
+    std::vector<std::string> names;
+    this->LoadDirectory(parent, lister, names);
+    for (std::string const& fname : names) {
       for (std::string name : this->Names) {
         name += this->Extension;
-        if (cmsysString_strcasecmp(fname, name.c_str()) == 0) {
+        if (cmsysString_strcasecmp(fname.c_str(), name.c_str()) == 0) {
           matches.push_back(fname);
         }
       }
@@ -1901,15 +2188,10 @@ private:
   bool Search(std::string const& parent, cmFileList& lister) override
   {
     // Look for matching files.
-    std::vector<std::string> matches;
-    cmsys::Directory d;
-    d.Load(parent);
-    for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
-      const char* fname = d.GetFile(i);
-      if (strcmp(fname, ".") == 0 || strcmp(fname, "..") == 0) {
-        continue;
-      }
-      if (cmsysString_strcasecmp(fname, this->String.c_str()) == 0) {
+    std::vector<std::string> names;
+    this->LoadDirectory(parent, lister, names);
+    for (std::string const& fname : names) {
+      if (cmsysString_strcasecmp(fname.c_str(), this->String.c_str()) == 0) {
         if (this->Consider(parent + fname, lister)) {
           return true;
         }
@@ -1968,6 +2250,26 @@ private:
   }
 };
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+class cmFindPackageIndexScope
+{
+public:
+  cmFindPackageIndexScope(cmFindPackageIndex* index)
+    : Index(index)
+  {
+  }
+  ~cmFindPackageIndexScope()
+  {
+    if (this->Index) {
+      this->Index->EndPrefix();
+    }
+  }
+
+private:
+  cmFindPackageIndex* Index;
+};
+#endif
+
 bool cmFindPackageCommand::SearchPrefix(std::string const& prefix_in)
 {
   assert(!prefix_in.empty() && prefix_in[prefix_in.size() - 1] == '/');
@@ -1980,6 +2282,16 @@ bool cmFindPackageCommand::SearchPrefix(std::string const& prefix_in)
     return false;
   }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Take directory listings below the prefix from the index, if any.
+  if (this->Index) {
+    this->Index->BeginPrefix(
+      this->IndexDir, prefix_in,
+      this->Makefile->GetGlobalGenerator()->GetFindEpoch());
+  }
+  cmFindPackageIndexScope indexScope(this->Index);
+#endif
+
   //  PREFIX/ (useful on windows or in build trees)
   if (this->SearchDirectory(prefix_in)) {
     return true;
@@ -15,6 +15,7 @@
 
 class cmCommand;
 class cmExecutionStatus;
+class cmFindPackageIndex;
 class cmSearchPath;
 
 /** \class cmFindPackageCommand
@@ -119,9 +120,21 @@ private:
   bool SearchDirectory(std::string const& dir);
   bool CheckDirectory(std::string const& dir);
   bool FindConfigFile(std::string const& dir, std::string& file);
+  bool ConfigFileExists(std::string const& file);
   bool CheckVersion(std::string const& config_file);
   bool CheckVersionFile(std::string const& version_file,
                         std::string& result_version);
+  struct VersionFileResult
+  {
+    std::string Version;
+    bool Exact = false;
+    bool Compatible = false;
+    bool Unsuitable = false;
+  };
+  bool ReadVersionFile(std::string const& version_file,
+                       VersionFileResult& result);
+  bool EvaluateBasicConfigVersionFile(std::string const& version_file,
+                                      VersionFileResult& result);
   bool SearchPrefix(std::string const& prefix);
   bool SearchFrameworkPrefix(std::string const& prefix_in);
   bool SearchAppBundlePrefix(std::string const& prefix_in);
@@ -167,6 +180,8 @@ private:
   std::vector<std::string> Names;
   std::vector<std::string> Configs;
   std::set<std::string> IgnoredPaths;
+  std::string IndexDir;
+  cmFindPackageIndex* Index;
 
   /*! the selected sortOrder (None by default)*/
   SortOrderType SortOrder;
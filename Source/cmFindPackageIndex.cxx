@@ -0,0 +1,99 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmFindPackageIndex.h"
+
+#include "cmsys/FStream.hxx"
+#include <sstream>
+#include <utility>
+
+#include "cmCryptoHash.h"
+#include "cmSystemTools.h"
+
+static const char* const cmFindPackageIndexHeader =
+  "# CMake find_package index 2";
+
+cmFindPackageIndex::cmFindPackageIndex()
+  : Current(nullptr)
+  , Epoch(0)
+{
+}
+
+cmFindPackageIndex::~cmFindPackageIndex()
+{
+}
+
+void cmFindPackageIndex::BeginPrefix(std::string const& indexDir,
+                                     std::string const& prefix,
+                                     unsigned long epoch)
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  std::string const path = indexDir + "/" + hasher.HashString(prefix);
+  auto it = this->Files.find(path);
+  if (it == this->Files.end()) {
+    it = this->Files.insert(std::make_pair(path, File())).first;
+    if (!this->Load(path, it->second) || it->second.Prefix != prefix) {
+      it->second.Snapshot.Clear();
+      it->second.Prefix = prefix;
+    }
+  }
+  this->Current = &it->second;
+  this->Epoch = epoch;
+}
+
+void cmFindPackageIndex::GetDirectoryContent(std::string const& dir,
+                                             std::vector<std::string>& names)
+{
+  names.clear();
+  for (cmDirectorySnapshot::Entry const& e :
+       this->Current->Snapshot.Get(dir, this->Epoch).Entries) {
+    names.push_back(e.Name);
+  }
+}
+
+bool cmFindPackageIndex::FileExists(std::string const& path)
+{
+  std::string const dir = cmSystemTools::GetFilenamePath(path);
+  std::string const name = cmSystemTools::GetFilenameName(path);
+  if (dir.empty() || name.empty()) {
+    return cmSystemTools::FileExists(path, true);
+  }
+
+  // The lookup ignores case for case-insensitive file systems, so the
+  // file system has the final word on names the directory has.
+  if (!this->Current->Snapshot.HasName(dir, name, this->Epoch)) {
+    return false;
+  }
+  return cmSystemTools::FileExists(path, true);
+}
+
+void cmFindPackageIndex::Save()
+{
+  this->Current = nullptr;
+  for (auto& f : this->Files) {
+    if (f.second.Snapshot.IsModified() && this->Store(f.first, f.second)) {
+      f.second.Snapshot.MarkSaved();
+    }
+  }
+}
+
+bool cmFindPackageIndex::Load(std::string const& path, File& file)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  std::string line;
+  return cmSystemTools::GetLineFromStream(fin, line) &&
+    line == cmFindPackageIndexHeader &&
+    cmSystemTools::GetLineFromStream(fin, file.Prefix) &&
+    file.Snapshot.Read(fin);
+}
+
+bool cmFindPackageIndex::Store(std::string const& path, File const& file)
+{
+  // Other processes using the same index never see an incomplete file.
+  std::ostringstream fout;
+  fout << cmFindPackageIndexHeader << "\n" << file.Prefix << "\n";
+  file.Snapshot.Write(fout);
+  return cmSystemTools::WriteFileAtomically(path, fout.str());
+}
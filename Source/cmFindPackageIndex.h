@@ -0,0 +1,71 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmFindPackageIndex_h
+#define cmFindPackageIndex_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cmDirectorySnapshot.h"
+
+/** \class cmFindPackageIndex
+ * \brief Directory listings of package search prefixes kept across runs
+ *
+ * find_package() looks for configuration files by listing the
+ * directories below each search prefix.  The index remembers those
+ * listings in one file per prefix, stored in a directory named by
+ * CMAKE_FIND_PACKAGE_INDEX_DIR, so that later runs, possibly in other
+ * build trees, need only check the modification time of a directory
+ * instead of reading it again.  Each directory is checked once per
+ * find epoch of the global generator.
+ */
+class cmFindPackageIndex
+{
+  CM_DISABLE_COPY(cmFindPackageIndex)
+
+public:
+  cmFindPackageIndex();
+  ~cmFindPackageIndex();
+
+  /** Use the index file in indexDir for the directories searched
+      below the given prefix until EndPrefix is called.  */
+  void BeginPrefix(std::string const& indexDir, std::string const& prefix,
+                   unsigned long epoch);
+  void EndPrefix() { this->Current = nullptr; }
+  bool IsActive() const { return this->Current != nullptr; }
+
+  /** Get the names in a directory, without "." and "..", in the order
+      the file system listed them.  Missing directories are empty.  */
+  void GetDirectoryContent(std::string const& dir,
+                           std::vector<std::string>& names);
+
+  /** Check whether a file exists.  Only files the index lists are
+      looked up on disk.  */
+  bool FileExists(std::string const& path);
+
+  /** Write index files that changed.  */
+  void Save();
+
+private:
+  struct File
+  {
+    File()
+      : Snapshot(false)
+    {
+    }
+    std::string Prefix;
+    cmDirectorySnapshot Snapshot;
+  };
+
+  bool Load(std::string const& path, File& file);
+  bool Store(std::string const& path, File const& file);
+
+  std::map<std::string, File> Files;
+  File* Current;
+  unsigned long Epoch;
+};
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "cmsys/Glob.hxx"
 
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmStateTypes.h"
 #include "cmSystemTools.h"
@@ -94,7 +95,7 @@ std::string cmFindPathCommand::FindHeaderInFramework(std::string const& file,
       std::string intPath = fpath;
       intPath += "/Headers/";
       intPath += fileName;
-      if (cmSystemTools::FileExists(intPath)) {
+      if (this->Makefile->GetGlobalGenerator()->FindFileExists(intPath)) {
         if (this->IncludeFileInPath) {
           return intPath;
         }
@@ -123,12 +124,13 @@ std::string cmFindPathCommand::FindHeaderInFramework(std::string const& file,
 
 std::string cmFindPathCommand::FindNormalHeader()
 {
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
   std::string tryPath;
   for (std::string const& n : this->Names) {
     for (std::string const& sp : this->SearchPaths) {
       tryPath = sp;
       tryPath += n;
-      if (cmSystemTools::FileExists(tryPath)) {
+      if (gg->FindFileExists(tryPath)) {
         if (this->IncludeFileInPath) {
           return tryPath;
         }
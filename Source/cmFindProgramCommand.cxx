@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmFindProgramCommand.h"
 
+#include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
 #include "cmStateTypes.h"
 #include "cmSystemTools.h"
@@ -14,7 +15,8 @@ class cmExecutionStatus;
 
 struct cmFindProgramHelper
 {
-  cmFindProgramHelper()
+  cmFindProgramHelper(cmGlobalGenerator* gg)
+    : GG(gg)
   {
 #if defined(_WIN32) || defined(__CYGWIN__) || defined(__MINGW32__)
     // Consider platform-specific extensions.
@@ -25,6 +27,9 @@ struct cmFindProgramHelper
     this->Extensions.emplace_back();
   }
 
+  // Global generator caching directory content.
+  cmGlobalGenerator* GG;
+
   // List of valid extensions.
   std::vector<std::string> Extensions;
 
@@ -61,7 +66,7 @@ struct cmFindProgramHelper
         continue;
       }
       this->TestPath += ext;
-      if (cmSystemTools::FileExists(this->TestPath, true)) {
+      if (this->GG->FindFileExists(this->TestPath, true)) {
         this->BestPath = cmSystemTools::CollapseFullPath(this->TestPath);
         return true;
       }
@@ -140,7 +145,7 @@ std::string cmFindProgramCommand::FindNormalProgram()
 std::string cmFindProgramCommand::FindNormalProgramNamesPerDir()
 {
   // Search for all names in each directory.
-  cmFindProgramHelper helper;
+  cmFindProgramHelper helper(this->Makefile->GetGlobalGenerator());
   for (std::string const& n : this->Names) {
     helper.AddName(n);
   }
@@ -163,7 +168,7 @@ std::string cmFindProgramCommand::FindNormalProgramNamesPerDir()
 std::string cmFindProgramCommand::FindNormalProgramDirsPerName()
 {
   // Search the entire path for each name.
-  cmFindProgramHelper helper;
+  cmFindProgramHelper helper(this->Makefile->GetGlobalGenerator());
   for (std::string const& n : this->Names) {
     // Switch to searching for this name.
     helper.SetName(n);
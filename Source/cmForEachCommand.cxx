@@ -204,7 +204,13 @@ bool cmForEachCommand::HandleInMode(std::vector<std::string> const& args)
     } else if (doing == DoingLists) {
       const char* value = this->Makefile->GetDefinition(args[i]);
       if (value && *value) {
-        cmSystemTools::ExpandListArgument(value, f->Args, true);
+        // Normal variables cache their split.
+        if (std::vector<std::string> const* list =
+              this->Makefile->GetDefinitionList(args[i])) {
+          f->Args.insert(f->Args.end(), list->begin(), list->end());
+        } else {
+          cmSystemTools::ExpandListArgument(value, f->Args, true);
+        }
       }
     } else {
       std::ostringstream e;
@@ -2,7 +2,9 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmFunctionCommand.h"
 
+#include <memory>
 #include <sstream>
+#include <utility>
 
 #include "cmAlgorithms.h"
 #include "cmExecutionStatus.h"
@@ -26,7 +28,8 @@ public:
   cmCommand* Clone() override
   {
     cmFunctionHelperCommand* newC = new cmFunctionHelperCommand;
-    // we must copy when we clone
+    // we must copy when we clone, but the body is shared so that calls
+    // keep the commands they resolved to
     newC->Args = this->Args;
     newC->Functions = this->Functions;
     newC->Policies = this->Policies;
@@ -48,7 +51,7 @@ public:
   }
 
   std::vector<std::string> Args;
-  std::vector<cmListFileFunction> Functions;
+  std::shared_ptr<std::vector<cmListFileFunction> const> Functions;
   cmPolicies::PolicyMap Policies;
   std::string FilePath;
 };
@@ -104,7 +107,7 @@ bool cmFunctionHelperCommand::InvokeInitialPass(
 
   // Invoke all the functions that were collected in the block.
   // for each function
-  for (cmListFileFunction const& func : this->Functions) {
+  for (cmListFileFunction const& func : *this->Functions) {
     cmExecutionStatus status;
     if (!this->Makefile->ExecuteCommand(func, status) ||
         status.GetNestedError()) {
@@ -136,7 +139,9 @@ bool cmFunctionFunctionBlocker::IsFunctionBlocked(
       // create a new command and add it to cmake
       cmFunctionHelperCommand* f = new cmFunctionHelperCommand();
       f->Args = this->Args;
-      f->Functions = this->Functions;
+      f->Functions =
+        std::make_shared<std::vector<cmListFileFunction> const>(
+          std::move(this->Functions));
       f->FilePath = this->GetStartingContext().FilePath;
       mf.RecordPolicies(f->Policies);
       mf.GetState()->AddScriptedCommand(this->Args[0], f);
@@ -118,7 +118,8 @@ void cmGeneratorExpressionEvaluationFile::CreateOutputFile(
   }
 }
 
-void cmGeneratorExpressionEvaluationFile::Generate(cmLocalGenerator* lg)
+void cmGeneratorExpressionEvaluationFile::Generate(
+  cmLocalGenerator* lg, std::map<std::string, std::string>& inputFiles)
 {
   mode_t perm = 0;
   std::string inputContent;
@@ -133,21 +134,28 @@ void cmGeneratorExpressionEvaluationFile::Generate(cmLocalGenerator* lg)
     }
     lg->GetMakefile()->AddCMakeDependFile(inputFileName);
     cmSystemTools::GetPermissions(inputFileName.c_str(), perm);
-    cmsys::ifstream fin(inputFileName.c_str());
-    if (!fin) {
-      std::ostringstream e;
-      e << "Evaluation file \"" << inputFileName << "\" cannot be read.";
-      lg->IssueMessage(cmake::FATAL_ERROR, e.str());
-      return;
-    }
+    std::map<std::string, std::string>::iterator it =
+      inputFiles.find(inputFileName);
+    if (it != inputFiles.end()) {
+      inputContent = it->second;
+    } else {
+      cmsys::ifstream fin(inputFileName.c_str());
+      if (!fin) {
+        std::ostringstream e;
+        e << "Evaluation file \"" << inputFileName << "\" cannot be read.";
+        lg->IssueMessage(cmake::FATAL_ERROR, e.str());
+        return;
+      }
 
-    std::string line;
-    std::string sep;
-    while (cmSystemTools::GetLineFromStream(fin, line)) {
-      inputContent += sep + line;
-      sep = "\n";
+      std::string line;
+      std::string sep;
+      while (cmSystemTools::GetLineFromStream(fin, line)) {
+        inputContent += sep + line;
+        sep = "\n";
+      }
+      inputContent += sep;
+      inputFiles[inputFileName] = inputContent;
     }
-    inputContent += sep;
   }
 
   cmListFileBacktrace lfbt = this->OutputFileExpr->GetBacktrace();
@@ -176,6 +184,11 @@ void cmGeneratorExpressionEvaluationFile::Generate(cmLocalGenerator* lg)
       }
     }
   }
+
+  // Later calls may read the files written here.
+  for (auto const& output : outputFiles) {
+    inputFiles.erase(output.first);
+  }
 }
 
 std::string cmGeneratorExpressionEvaluationFile::FixRelativePath(
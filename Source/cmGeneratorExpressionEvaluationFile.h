@@ -25,7 +25,11 @@ public:
     std::unique_ptr<cmCompiledGeneratorExpression> condition,
     bool inputIsContent, cmPolicies::PolicyStatus policyStatusCMP0070);
 
-  void Generate(cmLocalGenerator* lg);
+  /** Evaluate and write the outputs for all configurations.  The
+      contents of input files are kept in the given map so that each is
+      read once.  */
+  void Generate(cmLocalGenerator* lg,
+                std::map<std::string, std::string>& inputFiles);
 
   std::vector<std::string> GetFiles() const { return this->Files; }
 
@@ -0,0 +1,279 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmGlobCache.h"
+
+#include "cmsys/FStream.hxx"
+#include "cmsys/RegularExpression.hxx"
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+#include "cmGeneratedFileStream.h"
+#include "cmOutputConverter.h"
+#include "cmSystemTools.h"
+#include "cmVersion.h"
+
+#if defined(_WIN32) || defined(__APPLE__) || defined(__CYGWIN__)
+// Match names as cmsys::Glob does on case-insensitive file systems.
+#define CM_GLOB_CACHE_CASE_INDEPENDENT
+#endif
+
+static const char* const cmGlobCacheHeader = "# CMake glob snapshot 1";
+
+cmGlobCache::cmGlobCache()
+  : Snapshot(true)
+{
+}
+
+cmGlobCache::~cmGlobCache()
+{
+}
+
+bool cmGlobCache::FindFilesRecursive(
+  std::string const& expr, bool followSymlinks, bool listDirs,
+  std::string const& relative, unsigned long epoch,
+  std::vector<std::string>& files, unsigned int& followedSymlinks,
+  cmsys::Glob::GlobMessages& messages)
+{
+  if (!cmSystemTools::FileIsFullPath(expr)) {
+    return false;
+  }
+
+  // Split the expression as cmsys::Glob does: the directory up to the
+  // last slash before the first wildcard, and a pattern for the names
+  // found below it.  Leave wildcards in directories to cmsys::Glob.
+  std::string::size_type lastSlash = 0;
+  for (std::string::size_type cc = 1; cc < expr.size(); ++cc) {
+    char const c = expr[cc];
+    if (expr[cc - 1] == '\\') {
+      continue;
+    }
+    if (c == '/') {
+      lastSlash = cc;
+    } else if (c == '[' || c == '?' || c == '*') {
+      break;
+    }
+  }
+  if (lastSlash == 0) {
+    return false;
+  }
+  std::string const pattern = expr.substr(lastSlash + 1);
+  if (pattern.empty() || pattern.find('/') != std::string::npos) {
+    return false;
+  }
+
+  cmsys::RegularExpression regex(cmsys::Glob::PatternToRegex(pattern));
+  Walk walk;
+  walk.Pattern = &regex;
+  walk.FollowSymlinks = followSymlinks;
+  walk.ListDirs = listDirs;
+  walk.Relative = relative;
+  walk.Epoch = epoch;
+  walk.Files = &files;
+  walk.FollowedSymlinks = 0;
+  walk.Messages = &messages;
+  files.clear();
+  this->WalkDirectory(walk, true, expr.substr(0, lastSlash) + "/");
+  followedSymlinks += walk.FollowedSymlinks;
+  return true;
+}
+
+// Mirror cmsys::Glob::RecurseDirectory, reading the directory entries
+// from the cache.
+bool cmGlobCache::WalkDirectory(Walk& walk, bool top, std::string const& dir)
+{
+  // Copy the entries since walking subdirectories may add directories.
+  std::vector<cmDirectorySnapshot::Entry> const entries =
+    this->Snapshot.Get(dir, walk.Epoch).Entries;
+  std::string realname;
+  for (cmDirectorySnapshot::Entry const& e : entries) {
+    realname = top ? dir + e.Name : dir + "/" + e.Name;
+
+    bool const isSymLink = e.Kind == 'l';
+    bool const isDir = isSymLink ? cmSystemTools::FileIsDirectory(realname)
+                                 : e.Kind == 'd';
+    if (isDir && (!isSymLink || walk.FollowSymlinks)) {
+      if (isSymLink) {
+        ++walk.FollowedSymlinks;
+        std::string realPathErrorMessage;
+        std::string const canonicalPath(
+          cmSystemTools::GetRealPath(dir, &realPathErrorMessage));
+        if (!realPathErrorMessage.empty()) {
+          walk.Messages->push_back(cmsys::Glob::Message(
+            cmsys::Glob::error, "Canonical path generation from path '" +
+              dir + "' failed! Reason: '" + realPathErrorMessage + "'"));
+          return false;
+        }
+
+        std::vector<std::string>::iterator visited =
+          std::find(walk.VisitedSymlinks.begin(), walk.VisitedSymlinks.end(),
+                    canonicalPath);
+        if (visited == walk.VisitedSymlinks.end()) {
+          if (walk.ListDirs) {
+            // symlinks are treated as directories
+            this->AddFile(walk, realname);
+          }
+          walk.VisitedSymlinks.push_back(canonicalPath);
+          bool const ok = this->WalkDirectory(walk, false, realname);
+          walk.VisitedSymlinks.pop_back();
+          if (!ok) {
+            return false;
+          }
+        } else {
+          // We have already visited this symlink.  Prevent cyclic recursion.
+          std::string message;
+          for (; visited != walk.VisitedSymlinks.end(); ++visited) {
+            message += *visited + "\n";
+          }
+          message += canonicalPath + "/" + e.Name;
+          walk.Messages->push_back(
+            cmsys::Glob::Message(cmsys::Glob::cyclicRecursion, message));
+        }
+      } else {
+        if (walk.ListDirs) {
+          this->AddFile(walk, realname);
+        }
+        if (!this->WalkDirectory(walk, false, realname)) {
+          return false;
+        }
+      }
+    } else {
+#if defined(CM_GLOB_CACHE_CASE_INDEPENDENT)
+      if (walk.Pattern->find(cmSystemTools::LowerCase(e.Name))) {
+#else
+      if (walk.Pattern->find(e.Name)) {
+#endif
+        this->AddFile(walk, realname);
+      }
+    }
+  }
+  return true;
+}
+
+void cmGlobCache::AddFile(Walk& walk, std::string const& file)
+{
+  if (!walk.Relative.empty()) {
+    walk.Files->push_back(cmSystemTools::RelativePath(walk.Relative, file));
+  } else {
+    walk.Files->push_back(file);
+  }
+}
+
+void cmGlobCache::UseSnapshotFile(std::string const& file)
+{
+  if (file == this->SnapshotFile) {
+    return;
+  }
+  this->SnapshotFile = file;
+  if (!this->Load()) {
+    this->Snapshot.Clear();
+  }
+}
+
+bool cmGlobCache::Load()
+{
+  cmsys::ifstream fin(this->SnapshotFile.c_str(),
+                      std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  std::string line;
+  return cmSystemTools::GetLineFromStream(fin, line) &&
+    line == cmGlobCacheHeader && this->Snapshot.Read(fin);
+}
+
+void cmGlobCache::Save()
+{
+  if (this->SnapshotFile.empty() || !this->Snapshot.IsModified()) {
+    return;
+  }
+
+  // A build checking globs at the same time never sees an incomplete file.
+  std::ostringstream fout;
+  fout << cmGlobCacheHeader << "\n";
+  this->Snapshot.Write(fout);
+  if (cmSystemTools::WriteFileAtomically(this->SnapshotFile, fout.str())) {
+    this->Snapshot.MarkSaved();
+  }
+}
+
+void cmGlobCache::AddConfigureDepends(bool recurse, bool listDirs,
+                                      bool followSymlinks,
+                                      std::string const& relative,
+                                      std::string const& expr,
+                                      std::string const& result,
+                                      std::string const& origin)
+{
+  std::string command = recurse ? "file(GLOB_RECURSE" : "file(GLOB";
+  command += " NEW_GLOB LIST_DIRECTORIES ";
+  command += listDirs ? "true" : "false";
+  if (!relative.empty()) {
+    command += " RELATIVE ";
+    command += cmOutputConverter::EscapeForCMake(relative);
+  }
+  command += " ";
+  if (followSymlinks) {
+    command += "FOLLOW_SYMLINKS ";
+  }
+  command += cmOutputConverter::EscapeForCMake(expr);
+  command += ")";
+
+  // A glob run again later in the configure step has the newer result.
+  auto it = this->VerifiedIndex.find(command);
+  if (it != this->VerifiedIndex.end()) {
+    this->Verified[it->second].Result = result;
+    return;
+  }
+  this->VerifiedIndex[command] = this->Verified.size();
+  VerifiedGlob glob;
+  glob.Command = std::move(command);
+  glob.Result = result;
+  glob.Origin = origin;
+  this->Verified.push_back(std::move(glob));
+}
+
+void cmGlobCache::ClearConfigureDepends()
+{
+  this->Verified.clear();
+  this->VerifiedIndex.clear();
+}
+
+bool cmGlobCache::WriteVerifyScript(std::string const& script,
+                                    std::string const& stamp) const
+{
+  cmGeneratedFileStream fout(script.c_str());
+  fout.SetCopyIfDifferent(true);
+  if (!fout) {
+    return false;
+  }
+  /* clang-format off */
+  fout << "# CMAKE generated file: DO NOT EDIT!\n"
+       << "# Generated by CMake Version " << cmVersion::GetMajorVersion()
+       << "." << cmVersion::GetMinorVersion() << "\n"
+       << "\n"
+       << "# Run the globs given CONFIGURE_DEPENDS again and write the\n"
+       << "# stamp file if any of them finds other files.\n"
+       << "cmake_policy(SET CMP0009 NEW)\n";
+  /* clang-format on */
+  if (this->IsUsingSnapshotFile()) {
+    fout << "set(CMAKE_GLOB_SNAPSHOT ON)\n";
+  }
+  for (VerifiedGlob const& glob : this->Verified) {
+    fout << "\n"
+         << "# " << glob.Origin << "\n"
+         << glob.Command << "\n"
+         << "set(OLD_GLOB " << cmOutputConverter::EscapeForCMake(glob.Result)
+         << ")\n"
+         << "if(NOT \"${NEW_GLOB}\" STREQUAL \"${OLD_GLOB}\")\n"
+         << "  message(\"-- GLOB mismatch!\")\n"
+         << "  file(WRITE " << cmOutputConverter::EscapeForCMake(stamp)
+         << " \"\")\n"
+         << "  return()\n"
+         << "endif()\n";
+  }
+  // Close() reports whether the file was replaced, not whether the
+  // write succeeded.
+  bool const ok = !fout.fail();
+  fout.Close();
+  return ok;
+}
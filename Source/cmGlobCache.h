@@ -0,0 +1,103 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmGlobCache_h
+#define cmGlobCache_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include "cmsys/Glob.hxx"
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cmDirectorySnapshot.h"
+
+namespace cmsys {
+class RegularExpression;
+}
+
+/** \class cmGlobCache
+ * \brief Directory snapshots for file(GLOB_RECURSE) and globs to verify
+ *
+ * file(GLOB_RECURSE) lists every directory below its base and checks
+ * whether each entry is a directory.  The cache keeps a snapshot of
+ * each directory walked, with the kinds of its entries, that is
+ * checked once per find epoch of the global generator.  With
+ * CMAKE_GLOB_SNAPSHOT the snapshots are kept in a file for later runs.
+ *
+ * The cache also records the globs given CONFIGURE_DEPENDS and writes
+ * a script that runs them again at build time to decide whether CMake
+ * must re-run.
+ */
+class cmGlobCache
+{
+  CM_DISABLE_COPY(cmGlobCache)
+
+public:
+  cmGlobCache();
+  ~cmGlobCache();
+
+  /** Find files matching a recursive glob expression as cmsys::Glob
+      does, and add the number of symbolic links followed.  Returns false
+      without doing anything if the expression is not a full path or has
+      wildcards in directory components.  */
+  bool FindFilesRecursive(std::string const& expr, bool followSymlinks,
+                          bool listDirs, std::string const& relative,
+                          unsigned long epoch,
+                          std::vector<std::string>& files,
+                          unsigned int& followedSymlinks,
+                          cmsys::Glob::GlobMessages& messages);
+
+  /** Keep snapshots in the given file across runs.  */
+  void UseSnapshotFile(std::string const& file);
+  bool IsUsingSnapshotFile() const { return !this->SnapshotFile.empty(); }
+
+  /** Write the snapshot file if it changed.  */
+  void Save();
+
+  /** Record a glob whose result the build checks.  */
+  void AddConfigureDepends(bool recurse, bool listDirs, bool followSymlinks,
+                           std::string const& relative,
+                           std::string const& expr, std::string const& result,
+                           std::string const& origin);
+  bool HasConfigureDepends() const { return !this->Verified.empty(); }
+  void ClearConfigureDepends();
+
+  /** Write the script that runs the recorded globs again and writes the
+      stamp file if any of their results changed.  */
+  bool WriteVerifyScript(std::string const& script,
+                         std::string const& stamp) const;
+
+private:
+  struct Walk
+  {
+    cmsys::RegularExpression* Pattern;
+    bool FollowSymlinks;
+    bool ListDirs;
+    std::string Relative;
+    unsigned long Epoch;
+    std::vector<std::string>* Files;
+    unsigned int FollowedSymlinks;
+    std::vector<std::string> VisitedSymlinks;
+    cmsys::Glob::GlobMessages* Messages;
+  };
+
+  struct VerifiedGlob
+  {
+    std::string Command;
+    std::string Result;
+    std::string Origin;
+  };
+
+  bool WalkDirectory(Walk& walk, bool top, std::string const& dir);
+  void AddFile(Walk& walk, std::string const& file);
+  bool Load();
+
+  cmDirectorySnapshot Snapshot;
+  std::string SnapshotFile;
+
+  std::vector<VerifiedGlob> Verified;
+  std::map<std::string, size_t> VerifiedIndex;
+};
+
+#endif
@@ -2,7 +2,6 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmGlobalGenerator.h"
 
-#include "cmsys/Directory.hxx"
 #include "cmsys/FStream.hxx"
 #include <algorithm>
 #include <assert.h>
@@ -71,6 +70,7 @@ bool cmTarget::StrictTargetComparison::operator()(cmTarget const* t1,
 
 cmGlobalGenerator::cmGlobalGenerator(cmake* cm)
   : CMakeInstance(cm)
+  , DirectorySnapshot(false)
 {
   // By default the .SYMBOLIC dependency is not needed on symbolic rules.
   this->NeedSymbolicMark = false;
@@ -96,6 +96,7 @@ cmGlobalGenerator::cmGlobalGenerator(cmake* cm)
 
   this->ConfigureDoneCMP0026AndCMP0024 = false;
   this->FirstTimeProgress = 0.0f;
+  this->FindEpoch = 1;
 
   cm->GetState()->SetIsGeneratorMultiConfig(false);
   cm->GetState()->SetMinGWMake(false);
@@ -601,6 +602,20 @@ void cmGlobalGenerator::EnableLanguage(
 
   std::map<std::string, bool> needTestLanguage;
   std::map<std::string, bool> needSetLanguageEnabledMaps;
+  std::map<std::string, std::string> compilerInfoCacheFiles;
+  std::map<std::string, std::vector<std::string>> compilerInfoCacheEntries;
+  cmState* state = this->CMakeInstance->GetState();
+  // Collect the cache entries created while identifying and testing a
+  // compiler so that a build tree reusing its results gets them too.
+  auto collectNewCacheEntries = [state](std::vector<std::string> const& old,
+                                        std::vector<std::string>& entries) {
+    std::set<std::string> const oldKeys(old.begin(), old.end());
+    for (std::string const& key : state->GetCacheEntryKeys()) {
+      if (oldKeys.find(key) == oldKeys.end()) {
+        entries.push_back(key);
+      }
+    }
+  };
   // foreach language
   // load the CMakeDetermine(LANG)Compiler.cmake file to find
   // the compiler
@@ -621,6 +636,17 @@ void cmGlobalGenerator::EnableLanguage(
       fpath += lang;
       fpath += "Compiler.cmake";
 
+      // Otherwise another build tree may have identified and tested
+      // the same compiler already.
+      if (!cmSystemTools::FileExists(fpath)) {
+        std::string const infoCacheFile =
+          this->GetCompilerInfoCacheFile(mf, l);
+        if (!infoCacheFile.empty() &&
+            !this->LoadCompilerInfo(infoCacheFile, fpath)) {
+          compilerInfoCacheFiles[l] = infoCacheFile;
+        }
+      }
+
       // If the existing build tree was already configured with this
       // version of CMake then try to load the configured file first
       // to avoid duplicate compiler tests.
@@ -652,6 +678,7 @@ void cmGlobalGenerator::EnableLanguage(
       determineCompiler += "Compiler.cmake";
       std::string determineFile =
         mf->GetModulesFile(determineCompiler.c_str());
+      std::vector<std::string> const oldCacheKeys = state->GetCacheEntryKeys();
       if (!mf->ReadListFile(determineFile.c_str())) {
         cmSystemTools::Error("Could not find cmake module file: ",
                              determineCompiler.c_str());
@@ -690,6 +717,9 @@ void cmGlobalGenerator::EnableLanguage(
         cmSystemTools::Error("Could not find cmake module file: ",
                              fpath.c_str());
       }
+      if (compilerInfoCacheFiles.count(l)) {
+        collectNewCacheEntries(oldCacheKeys, compilerInfoCacheEntries[l]);
+      }
       this->SetLanguageEnabledFlag(lang, mf);
       needSetLanguageEnabledMaps[lang] = true;
       // this can only be called after loading CMake(LANG)Compiler.cmake
@@ -804,6 +834,8 @@ void cmGlobalGenerator::EnableLanguage(
         testLang += lang;
         testLang += "Compiler.cmake";
         std::string ifpath = mf->GetModulesFile(testLang.c_str());
+        std::vector<std::string> const oldCacheKeys =
+          state->GetCacheEntryKeys();
         if (!mf->ReadListFile(ifpath.c_str())) {
           cmSystemTools::Error("Could not find cmake module file: ",
                                testLang.c_str());
@@ -811,15 +843,22 @@ void cmGlobalGenerator::EnableLanguage(
         std::string compilerWorks = "CMAKE_";
         compilerWorks += lang;
         compilerWorks += "_COMPILER_WORKS";
+        std::string compilerLangFile = rootBin;
+        compilerLangFile += "/CMake";
+        compilerLangFile += lang;
+        compilerLangFile += "Compiler.cmake";
         // if the compiler did not work, then remove the
         // CMake(LANG)Compiler.cmake file so that it will get tested the
         // next time cmake is run
         if (!mf->IsOn(compilerWorks)) {
-          std::string compilerLangFile = rootBin;
-          compilerLangFile += "/CMake";
-          compilerLangFile += lang;
-          compilerLangFile += "Compiler.cmake";
           cmSystemTools::RemoveFile(compilerLangFile);
+        } else if (compilerInfoCacheFiles.count(l) &&
+                   !cmSystemTools::GetErrorOccuredFlag()) {
+          std::vector<std::string>& cacheEntries =
+            compilerInfoCacheEntries[l];
+          collectNewCacheEntries(oldCacheKeys, cacheEntries);
+          this->StoreCompilerInfo(compilerInfoCacheFiles[l], mf, l,
+                                  compilerLangFile, cacheEntries);
         }
       } // end if in try compile
     }   // end need test language
@@ -951,6 +990,273 @@ void cmGlobalGenerator::CheckCompilerIdCompatibility(
   }
 }
 
+std::string cmGlobalGenerator::GetCompilerInfoCacheFile(
+  cmMakefile* mf, std::string const& lang) const
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (this->CMakeInstance->GetIsInTryCompile() ||
+      !this->ConfiguredFilesPath.empty()) {
+    return std::string();
+  }
+  std::string cacheDir =
+    mf->GetSafeDefinition("CMAKE_COMPILER_INFO_CACHE_DIR");
+  if (cacheDir.empty()) {
+    cmSystemTools::GetEnv("CMAKE_COMPILER_INFO_CACHE_DIR", cacheDir);
+  }
+  if (cacheDir.empty()) {
+    return std::string();
+  }
+  cacheDir = cmSystemTools::CollapseFullPath(cacheDir);
+
+  // Only languages whose inputs to compiler identification are known.
+  static const char* const langEnvVars[][3] = {
+    { "C", "CC", "CFLAGS" },
+    { "CXX", "CXX", "CXXFLAGS" },
+    { "CUDA", "CUDACXX", "CUDAFLAGS" },
+    { "Fortran", "FC", "FFLAGS" },
+  };
+  const char* const* envVars = nullptr;
+  for (const char* const* entry : langEnvVars) {
+    if (lang == entry[0]) {
+      envVars = entry;
+    }
+  }
+  if (!envVars) {
+    return std::string();
+  }
+
+  // Paths into this project are the only inputs that differ between
+  // build trees that find the same compiler.
+  std::string const homeOutput = this->CMakeInstance->GetHomeOutputDirectory();
+  std::string const home = this->CMakeInstance->GetHomeDirectory();
+  auto normalize = [&homeOutput, &home](std::string str) {
+    cmSystemTools::ReplaceString(str, homeOutput.c_str(), "<BINARY_DIR>");
+    cmSystemTools::ReplaceString(str, home.c_str(), "<SOURCE_DIR>");
+    return str;
+  };
+
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  hasher.Initialize();
+  auto append = [&hasher](std::string const& str) {
+    hasher.Append(str);
+    hasher.Append("", 1);
+  };
+
+  append(cmVersion::GetCMakeVersion());
+  append(this->GetName());
+  append(lang);
+
+  // The environment consulted to find and run the compiler.
+  std::vector<std::string> env(envVars + 1, envVars + 3);
+  static const char* const commonEnvVars[] = {
+    "PATH",           "LDFLAGS",      "LIBRARY_PATH",       "CPATH",
+    "C_INCLUDE_PATH", "COMPILER_PATH", "GCC_EXEC_PREFIX",   "SDKROOT",
+    "DEVELOPER_DIR",  "INCLUDE",       "LIB",
+  };
+  env.insert(env.end(), cm::cbegin(commonEnvVars), cm::cend(commonEnvVars));
+  for (std::string const& var : env) {
+    std::string value;
+    append(var);
+    append(cmSystemTools::GetEnv(var, value) ? "1" + value : "0");
+  }
+
+  // The target platform and any tools or flags given by the project.
+  static const char* const vars[] = {
+    "CMAKE_GENERATOR_INSTANCE",
+    "CMAKE_GENERATOR_PLATFORM",
+    "CMAKE_GENERATOR_TOOLSET",
+    "CMAKE_MAKE_PROGRAM",
+    "CMAKE_SYSTEM_NAME",
+    "CMAKE_SYSTEM_VERSION",
+    "CMAKE_SYSTEM_PROCESSOR",
+    "CMAKE_CROSSCOMPILING",
+    "CMAKE_SYSROOT",
+    "CMAKE_FIND_ROOT_PATH",
+    "CMAKE_FIND_ROOT_PATH_MODE_PROGRAM",
+    "CMAKE_PROGRAM_PATH",
+    "CMAKE_PREFIX_PATH",
+    "CMAKE_MODULE_PATH",
+    "CMAKE_USER_MAKE_RULES_OVERRIDE",
+    "CMAKE_OSX_ARCHITECTURES",
+    "CMAKE_OSX_DEPLOYMENT_TARGET",
+    "CMAKE_OSX_SYSROOT",
+    "CMAKE_TRY_COMPILE_CONFIGURATION",
+    "CMAKE_TRY_COMPILE_TARGET_TYPE",
+    "CMAKE_EXE_LINKER_FLAGS",
+    "CMAKE_EXE_LINKER_FLAGS_INIT",
+    "CMAKE_AR",
+    "CMAKE_RANLIB",
+    "CMAKE_LINKER",
+  };
+  for (const char* var : vars) {
+    append(normalize(mf->GetSafeDefinition(var)));
+  }
+  static const char* const langVars[] = {
+    "COMPILER",
+    "COMPILER_ARG1",
+    "COMPILER_ID",
+    "COMPILER_TARGET",
+    "COMPILER_EXTERNAL_TOOLCHAIN",
+    "COMPILER_AR",
+    "COMPILER_RANLIB",
+    "FLAGS",
+    "FLAGS_INIT",
+  };
+  for (const char* var : langVars) {
+    append(normalize(
+      mf->GetSafeDefinition(std::string("CMAKE_") + lang + "_" + var)));
+  }
+  append(normalize(mf->GetSafeDefinition("CMAKE_USER_MAKE_RULES_OVERRIDE_" +
+                                         lang)));
+
+  // Settings given on the command line or in an initial cache.
+  cmState* state = this->CMakeInstance->GetState();
+  for (std::string const& key : state->GetCacheEntryKeys()) {
+    cmStateEnums::CacheEntryType const type = state->GetCacheEntryType(key);
+    if (type != cmStateEnums::INTERNAL && type != cmStateEnums::STATIC &&
+        cmHasLiteralPrefix(key, "CMAKE_")) {
+      append(key);
+      append(normalize(state->GetCacheEntryValue(key)));
+    }
+  }
+  if (const char* toolchain =
+        state->GetCacheEntryValue("CMAKE_TOOLCHAIN_FILE")) {
+    cmCryptoHash toolchainHasher(cmCryptoHash::AlgoSHA256);
+    append(toolchainHasher.HashFile(toolchain));
+  }
+
+  return cacheDir + "/" + lang + "-" + hasher.FinalizeHex();
+#else
+  static_cast<void>(mf);
+  static_cast<void>(lang);
+  return std::string();
+#endif
+}
+
+bool cmGlobalGenerator::LoadCompilerInfo(std::string const& file,
+                                         std::string const& compilerLangFile)
+{
+  cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+
+  // The entry is valid only for the compiler it was created with.
+  std::string compiler;
+  std::string size;
+  std::string mtime;
+  std::string count;
+  if (!std::getline(fin, compiler) || !std::getline(fin, size) ||
+      !std::getline(fin, mtime) || !std::getline(fin, count) ||
+      !cmSystemTools::FileExists(compiler, true) ||
+      size != std::to_string(cmSystemTools::FileLength(compiler)) ||
+      mtime != std::to_string(cmSystemTools::ModifiedTime(compiler))) {
+    return false;
+  }
+
+  struct CacheEntry
+  {
+    std::string Key;
+    std::string Value;
+    std::string Help;
+    cmStateEnums::CacheEntryType Type;
+    bool Advanced;
+  };
+  std::vector<CacheEntry> entries;
+  unsigned long n = 0;
+  if (!cmSystemTools::StringToULong(count.c_str(), &n)) {
+    return false;
+  }
+  for (unsigned long i = 0; i < n; ++i) {
+    std::string line;
+    std::string advanced;
+    CacheEntry entry;
+    if (!std::getline(fin, line) || !std::getline(fin, entry.Help) ||
+        !std::getline(fin, advanced) ||
+        !cmState::ParseCacheEntry(line, entry.Key, entry.Value,
+                                  entry.Type)) {
+      return false;
+    }
+    entry.Advanced = advanced == "1";
+    entries.push_back(std::move(entry));
+  }
+  std::string const content((std::istreambuf_iterator<char>(fin)),
+                            std::istreambuf_iterator<char>());
+
+  {
+    cmsys::ofstream fout(compilerLangFile.c_str(),
+                         std::ios::out | std::ios::binary);
+    fout << content;
+    if (!fout) {
+      fout.close();
+      cmSystemTools::RemoveFile(compilerLangFile);
+      return false;
+    }
+  }
+
+  // Values given for this build tree take precedence.
+  cmState* state = this->CMakeInstance->GetState();
+  for (CacheEntry const& entry : entries) {
+    if (!state->GetCacheEntryValue(entry.Key)) {
+      this->CMakeInstance->AddCacheEntry(entry.Key, entry.Value.c_str(),
+                                         entry.Help.c_str(), entry.Type);
+      if (entry.Advanced) {
+        state->SetCacheEntryProperty(entry.Key, "ADVANCED", "1");
+      }
+    }
+  }
+  return true;
+}
+
+void cmGlobalGenerator::StoreCompilerInfo(
+  std::string const& file, cmMakefile* mf, std::string const& lang,
+  std::string const& compilerLangFile,
+  std::vector<std::string> const& cacheEntries) const
+{
+  std::string const compiler =
+    mf->GetSafeDefinition(std::string("CMAKE_") + lang + "_COMPILER");
+  if (!cmSystemTools::FileIsFullPath(compiler) ||
+      !cmSystemTools::FileExists(compiler, true)) {
+    return;
+  }
+  cmsys::ifstream fin(compilerLangFile.c_str(),
+                      std::ios::in | std::ios::binary);
+  if (!fin) {
+    return;
+  }
+
+  std::ostringstream entry;
+  entry << compiler << "\n"
+        << cmSystemTools::FileLength(compiler) << "\n"
+        << cmSystemTools::ModifiedTime(compiler) << "\n";
+  cmState* state = this->CMakeInstance->GetState();
+  std::ostringstream entries;
+  size_t count = 0;
+  for (std::string const& key : cacheEntries) {
+    const char* value = state->GetCacheEntryValue(key);
+    if (!value || strchr(value, '\n')) {
+      continue;
+    }
+    std::string help;
+    if (const char* h = state->GetCacheEntryProperty(key, "HELPSTRING")) {
+      help = h;
+    }
+    std::replace(help.begin(), help.end(), '\n', ' ');
+    entries << key << ":"
+            << cmState::CacheEntryTypeToString(state->GetCacheEntryType(key))
+            << "=" << value << "\n"
+            << help << "\n"
+            << (state->GetCacheEntryPropertyAsBool(key, "ADVANCED") ? "1"
+                                                                    : "0")
+            << "\n";
+    ++count;
+  }
+  entry << count << "\n" << entries.str() << fin.rdbuf();
+
+  // Several builds may share the cache directory.
+  cmSystemTools::WriteFileAtomically(file, entry.str());
+}
+
 std::string cmGlobalGenerator::GetLanguageOutputExtension(
   cmSourceFile const& source) const
 {
@@ -1196,6 +1502,21 @@ void cmGlobalGenerator::Configure()
   // and for infinite loops
   this->CheckTargetProperties();
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  this->FindPackageIndex.Save();
+  this->GlobCache.Save();
+#endif
+
+  if (this->CMakeInstance->GetDebugOutput()) {
+    std::ostringstream msg;
+    msg << "Find commands looked up " << this->FindStats.Lookups
+        << " files with " << this->DirectorySnapshot.GetNumberOfChecks()
+        << " directory checks, " << this->DirectorySnapshot.GetNumberOfLoads()
+        << " directory loads and " << this->FindStats.FileChecks
+        << " file checks.\n";
+    cmSystemTools::Stdout(msg.str().c_str());
+  }
+
   if (this->CMakeInstance->GetWorkingMode() == cmake::NORMAL_MODE) {
     std::ostringstream msg;
     if (cmSystemTools::GetErrorOccuredFlag()) {
@@ -1394,6 +1715,8 @@ void cmGlobalGenerator::Generate()
 
   this->ProcessEvaluationFiles();
 
+  this->GenerateGlobVerifyScript();
+
   // Generate project files
   for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i) {
     this->SetCurrentMakefile(this->LocalGenerators[i]->GetMakefile());
@@ -1658,7 +1981,44 @@ void cmGlobalGenerator::ClearGeneratorMembers()
   this->ProjectMap.clear();
   this->RuleHashes.clear();
   this->DirectoryContentMap.clear();
+  this->DirectorySnapshot.Clear();
+  this->FindStats = FindStatistics();
   this->BinaryDirectories.clear();
+  this->GlobVerifyScript.clear();
+  this->GlobVerifyStamp.clear();
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  this->GlobCache.ClearConfigureDepends();
+#endif
+}
+
+void cmGlobalGenerator::GenerateGlobVerifyScript()
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (!this->GlobCache.HasConfigureDepends() ||
+      this->LocalGenerators.empty()) {
+    return;
+  }
+
+  // The build runs the script before checking whether CMake must re-run.
+  // The stamp is a dependency of the build system that the script
+  // touches when a glob result changed.
+  std::string const dir =
+    this->CMakeInstance->GetHomeOutputDirectory() + "/CMakeFiles";
+  std::string const script = dir + "/VerifyGlobs.cmake";
+  std::string const stamp = dir + "/cmake.verify_globs";
+  if (!this->GlobCache.WriteVerifyScript(script, stamp)) {
+    this->GetCMakeInstance()->IssueMessage(
+      cmake::FATAL_ERROR, "Could not write glob verification script:\n  " +
+        script);
+    return;
+  }
+  if (!cmSystemTools::FileExists(stamp)) {
+    cmSystemTools::Touch(stamp, true);
+  }
+  this->LocalGenerators[0]->GetMakefile()->AddCMakeDependFile(stamp);
+  this->GlobVerifyScript = script;
+  this->GlobVerifyStamp = stamp;
+#endif
 }
 
 void cmGlobalGenerator::ComputeTargetObjectDirectory(
@@ -2747,28 +3107,56 @@ std::set<std::string> const& cmGlobalGenerator::GetDirectoryContent(
 {
   DirectoryContent& dc = this->DirectoryContentMap[dir];
   if (needDisk) {
-    long mt = cmSystemTools::ModifiedTime(dir);
-    if (mt != dc.LastDiskTime) {
-      // Reset to non-loaded directory content.
-      dc.All = dc.Generated;
-
-      // Load the directory content from disk.
-      cmsys::Directory d;
-      if (d.Load(dir)) {
-        unsigned long n = d.GetNumberOfFiles();
-        for (unsigned long i = 0; i < n; ++i) {
-          const char* f = d.GetFile(i);
-          if (strcmp(f, ".") != 0 && strcmp(f, "..") != 0) {
-            dc.All.insert(f);
-          }
-        }
-      }
-      dc.LastDiskTime = mt;
-    }
+    this->UpdateDirectoryContent(dc, this->DirectorySnapshot.Update(dir));
   }
   return dc.All;
 }
 
+std::set<std::string> const& cmGlobalGenerator::GetFindDirectoryContent(
+  std::string const& dir)
+{
+  DirectoryContent& dc = this->DirectoryContentMap[dir];
+  this->UpdateDirectoryContent(
+    dc, this->DirectorySnapshot.Get(dir, this->FindEpoch));
+  return dc.All;
+}
+
+bool cmGlobalGenerator::FindFileExists(std::string const& path, bool isFile)
+{
+  ++this->FindStats.Lookups;
+
+  // Leave relative paths and paths the file system may resolve through
+  // missing directories to the file system.
+  std::string const dir = cmSystemTools::GetFilenamePath(path);
+  std::string const name = cmSystemTools::GetFilenameName(path);
+  if (dir.empty() || name.empty() || path.find("..") != std::string::npos) {
+    ++this->FindStats.FileChecks;
+    return cmSystemTools::FileExists(path, isFile);
+  }
+
+  // The lookup ignores case for case-insensitive file systems, so the
+  // file system has the final word on files that are in the directory.
+  if (!this->DirectorySnapshot.HasName(dir, name, this->FindEpoch)) {
+    return false;
+  }
+  ++this->FindStats.FileChecks;
+  return cmSystemTools::FileExists(path, isFile);
+}
+
+void cmGlobalGenerator::UpdateDirectoryContent(
+  DirectoryContent& dc, cmDirectorySnapshot::Listing const& listing)
+{
+  if (dc.Loads == listing.Loads) {
+    return;
+  }
+  // Reset to non-loaded directory content.
+  dc.All = dc.Generated;
+  for (cmDirectorySnapshot::Entry const& e : listing.Entries) {
+    dc.All.insert(e.Name);
+  }
+  dc.Loads = listing.Loads;
+}
+
 void cmGlobalGenerator::AddRuleHash(const std::vector<std::string>& outputs,
                                     std::string const& content)
 {
@@ -3041,9 +3429,10 @@ void cmGlobalGenerator::CreateEvaluationSourceFiles(
 
 void cmGlobalGenerator::ProcessEvaluationFiles()
 {
+  std::map<std::string, std::string> inputFiles;
   std::vector<std::string> generatedFiles;
   for (cmLocalGenerator* localGen : this->LocalGenerators) {
-    localGen->ProcessEvaluationFiles(generatedFiles);
+    localGen->ProcessEvaluationFiles(generatedFiles, inputFiles);
   }
 }
 
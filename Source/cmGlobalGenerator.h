@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "cmCustomCommandLines.h"
+#include "cmDirectorySnapshot.h"
 #include "cmDuration.h"
 #include "cmExportSetMap.h"
 #include "cmStateSnapshot.h"
@@ -24,6 +25,9 @@
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 #include "cmFileLockPool.h"
+#include "cmFindPackageIndex.h"
+#include "cmGlobCache.h"
+#include "cmInstallState.h"
 #endif
 
 class cmExportBuildFileGenerator;
@@ -299,6 +303,24 @@ public:
   std::set<std::string> const& GetDirectoryContent(std::string const& dir,
                                                    bool needDisk = true);
 
+  /** Get the content of a directory for the find commands.  A directory
+      is checked for changes on disk only on its first use after
+      ExpireFindDirectoryContent.  */
+  std::set<std::string> const& GetFindDirectoryContent(
+    std::string const& dir);
+
+  /** Check whether a file exists for the find commands.  A file missing
+      from the content of its directory is rejected without asking the
+      file system.  */
+  bool FindFileExists(std::string const& path, bool isFile = false);
+
+  /** Note that files may have changed on disk.  Directories used by the
+      find commands afterwards are checked for changes again.  */
+  void ExpireFindDirectoryContent() { ++this->FindEpoch; }
+
+  /** Get the number of times find directory content expired so far.  */
+  unsigned long GetFindEpoch() const { return this->FindEpoch; }
+
   void IndexTarget(cmTarget* t);
   void IndexGeneratorTarget(cmGeneratorTarget* gt);
 
@@ -359,6 +381,10 @@ public:
 
   virtual bool IsIPOSupported() const { return false; }
 
+  /** Return whether separate targets of one generated build tree may be
+      built by concurrent invocations of the native build tool.  */
+  virtual bool SupportsConcurrentTargetBuilds() const { return false; }
+
   /** Return whether the generator can import external visual studio project
       using INCLUDE_EXTERNAL_MSPROJECT */
   virtual bool IsIncludeExternalMSProjectSupported() const { return false; }
@@ -380,6 +406,9 @@ public:
 
   void ProcessEvaluationFiles();
 
+  /** Write the script checking the CONFIGURE_DEPENDS globs, if any.  */
+  void GenerateGlobVerifyScript();
+
   std::map<std::string, cmExportBuildFileGenerator*>& GetBuildExportSets()
   {
     return this->BuildExportSets;
@@ -406,8 +435,23 @@ public:
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   cmFileLockPool& GetFileLockPool() { return FileLockPool; }
+  cmFindPackageIndex& GetFindPackageIndex() { return FindPackageIndex; }
+  cmGlobCache& GetGlobCache() { return GlobCache; }
+  cmInstallState& GetInstallState() { return InstallState; }
 #endif
 
+  /** Script run by the build to check the CONFIGURE_DEPENDS globs, and
+      the stamp file it writes when their results change.  Empty if no
+      glob was given CONFIGURE_DEPENDS.  */
+  std::string const& GetGlobVerifyScript() const
+  {
+    return this->GlobVerifyScript;
+  }
+  std::string const& GetGlobVerifyStamp() const
+  {
+    return this->GlobVerifyStamp;
+  }
+
   bool GetConfigureDoneCMP0026() const
   {
     return this->ConfigureDoneCMP0026AndCMP0024;
@@ -555,6 +599,16 @@ private:
   void CheckCompilerIdCompatibility(cmMakefile* mf,
                                     std::string const& lang) const;
 
+  // Share the results of compiler identification between build trees.
+  std::string GetCompilerInfoCacheFile(cmMakefile* mf,
+                                       std::string const& lang) const;
+  bool LoadCompilerInfo(std::string const& file,
+                        std::string const& compilerLangFile);
+  void StoreCompilerInfo(std::string const& file, cmMakefile* mf,
+                         std::string const& lang,
+                         std::string const& compilerLangFile,
+                         std::vector<std::string> const& cacheEntries) const;
+
   void ComputeBuildFileGenerators();
 
   cmExternalMakefileProjectGenerator* ExtraGenerator;
@@ -584,19 +638,36 @@ private:
   // Cache directory content and target files to be built.
   struct DirectoryContent
   {
-    long LastDiskTime;
+    // The number of times the directory was listed from disk when All
+    // was last updated.
+    unsigned long Loads;
     std::set<std::string> All;
     std::set<std::string> Generated;
     DirectoryContent()
-      : LastDiskTime(-1)
+      : Loads(0)
     {
     }
   };
   std::map<std::string, DirectoryContent> DirectoryContentMap;
+  cmDirectorySnapshot DirectorySnapshot;
+  void UpdateDirectoryContent(DirectoryContent& dc,
+                              cmDirectorySnapshot::Listing const& listing);
+
+  // Directory content lookups by the find commands, for --debug-output.
+  unsigned long FindEpoch;
+  struct FindStatistics
+  {
+    unsigned long Lookups = 0;
+    unsigned long FileChecks = 0;
+  };
+  FindStatistics FindStats;
 
   // Set of binary directories on disk.
   std::set<std::string> BinaryDirectories;
 
+  std::string GlobVerifyScript;
+  std::string GlobVerifyStamp;
+
   // track targets to issue CMP0042 warning for.
   std::set<std::string> CMP0042WarnTargets;
   // track targets to issue CMP0068 warning for.
@@ -608,6 +679,15 @@ private:
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   // Pool of file locks
   cmFileLockPool FileLockPool;
+
+  // Directory listings of find_package search prefixes
+  cmFindPackageIndex FindPackageIndex;
+
+  // Directory snapshots and CONFIGURE_DEPENDS globs of file(GLOB)
+  cmGlobCache GlobCache;
+
+  // Files read and written by the install script being run
+  cmInstallState InstallState;
 #endif
 
 protected:
@@ -1368,6 +1368,7 @@ void cmGlobalNinjaGenerator::WriteTargetRebuildManifest(std::ostream& os)
   std::sort(implicitDeps.begin(), implicitDeps.end());
   implicitDeps.erase(std::unique(implicitDeps.begin(), implicitDeps.end()),
                      implicitDeps.end());
+  cmNinjaDeps rerunDeps = implicitDeps;
 
   cmNinjaVars variables;
   // Use 'console' pool to get non buffered output of the CMake re-run call
@@ -1376,12 +1377,53 @@ void cmGlobalNinjaGenerator::WriteTargetRebuildManifest(std::ostream& os)
     variables["pool"] = "console";
   }
 
+  // Check the CONFIGURE_DEPENDS globs on every build.  The script
+  // touches the stamp, an input of the re-run, when a result changed.
+  std::string const& verifyScript = this->GetGlobVerifyScript();
+  if (!verifyScript.empty()) {
+    std::string verifyCmd =
+      lg->ConvertToOutputFormat(cmSystemTools::GetCMakeCommand(),
+                                cmOutputConverter::SHELL);
+    verifyCmd += " -P ";
+    verifyCmd +=
+      lg->ConvertToOutputFormat(verifyScript, cmOutputConverter::SHELL);
+    WriteRule(*this->RulesFileStream, "VERIFY_GLOBS", verifyCmd,
+              "Re-checking globbed directories...",
+              "Rule for re-checking globbed directories.",
+              /*depfile=*/"",
+              /*deptype=*/"",
+              /*rspfile=*/"",
+              /*rspcontent*/ "",
+              /*restat=*/"1",
+              /*generator=*/true);
+
+    std::string const verifyStamp =
+      this->ConvertToNinjaPath(this->GetGlobVerifyStamp());
+    std::string const verifyForce = this->NinjaOutputPath(
+      std::string(cmake::GetCMakeFilesDirectoryPostSlash()) +
+      "VerifyGlobs.cmake_force");
+    this->WritePhonyBuild(os, "Phony target to check the globs each build.",
+                          cmNinjaDeps(1, verifyForce), cmNinjaDeps());
+    this->WriteBuild(os, "Re-check the CONFIGURE_DEPENDS globs.",
+                     "VERIFY_GLOBS",
+                     /*outputs=*/cmNinjaDeps(1, verifyStamp),
+                     /*implicitOuts=*/cmNinjaDeps(),
+                     /*explicitDeps=*/cmNinjaDeps(),
+                     /*implicitDeps=*/cmNinjaDeps(1, verifyForce),
+                     /*orderOnlyDeps=*/cmNinjaDeps(), variables);
+
+    // The stamp has a rule so it is not a missing input.
+    implicitDeps.erase(
+      std::remove(implicitDeps.begin(), implicitDeps.end(), verifyStamp),
+      implicitDeps.end());
+  }
+
   std::string const ninjaBuildFile = this->NinjaOutputPath(NINJA_BUILD_FILE);
   this->WriteBuild(os, "Re-run CMake if any of its inputs changed.",
                    "RERUN_CMAKE",
                    /*outputs=*/cmNinjaDeps(1, ninjaBuildFile),
                    /*implicitOuts=*/cmNinjaDeps(),
-                   /*explicitDeps=*/cmNinjaDeps(), implicitDeps,
+                   /*explicitDeps=*/cmNinjaDeps(), rerunDeps,
                    /*orderOnlyDeps=*/cmNinjaDeps(), variables);
 
   this->WritePhonyBuild(os, "A missing CMake input file is not an error.",
@@ -151,6 +151,9 @@ public:
 
   bool IsIPOSupported() const override { return true; }
 
+  /** The "<target>/fast" rules do not share any state.  */
+  bool SupportsConcurrentTargetBuilds() const override { return true; }
+
   void ComputeTargetObjectDirectory(cmGeneratorTarget* gt) const override;
 
   std::string IncludeDirective;
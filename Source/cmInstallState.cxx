@@ -0,0 +1,246 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmInstallState.h"
+
+#include "cmsys/FStream.hxx"
+#include "cmsys/SystemTools.hxx"
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <stddef.h>
+#include <utility>
+
+#include "cmSystemTools.h"
+#include "cmWorkerPool.h"
+#include "cm_sys_stat.h"
+
+// Files are checked on the worker threads in batches of this size.
+static size_t const cmInstallStateBatch = 512;
+
+void cmInstallState::Stat(std::vector<Entry>& entries)
+{
+  auto check = [&entries](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      Entry& e = entries[i];
+#if !defined(_WIN32) || defined(__CYGWIN__)
+      struct stat st;
+      if (lstat(e.Path.c_str(), &st) != 0) {
+#else
+      cmsys::SystemTools::Stat_t st;
+      if (cmsys::SystemTools::Stat(e.Path, &st) != 0) {
+#endif
+        e.Size = -1;
+        e.Time = 0;
+        e.Mode = 0;
+        continue;
+      }
+      e.Size = static_cast<long long>(st.st_size);
+#if CMake_STAT_HAS_ST_MTIM
+      e.Time = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000 +
+        st.st_mtim.tv_nsec;
+#elif CMake_STAT_HAS_ST_MTIMESPEC
+      e.Time = static_cast<long long>(st.st_mtimespec.tv_sec) * 1000000000 +
+        st.st_mtimespec.tv_nsec;
+#else
+      e.Time = static_cast<long long>(st.st_mtime) * 1000000000;
+#endif
+      e.Mode = static_cast<unsigned long>(st.st_mode);
+    }
+  };
+
+  unsigned int const threads = cmWorkerPool::GetHardwareThreads();
+  if (threads < 2 || entries.size() <= cmInstallStateBatch) {
+    check(0, entries.size());
+    return;
+  }
+  cmWorkerPool pool(threads, threads);
+  for (size_t i = 0; i < entries.size(); i += cmInstallStateBatch) {
+    size_t const end = std::min(i + cmInstallStateBatch, entries.size());
+    pool.Post([&check, i, end]() { check(i, end); });
+  }
+  pool.Wait();
+}
+
+bool cmInstallState::Load(std::string const& file,
+                          std::string const& settings)
+{
+  this->Outputs.clear();
+  this->Vars.clear();
+
+  cmsys::ifstream fin(file.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  if (!fin || !std::getline(fin, line) || line != "CMakeInstallState 1" ||
+      !std::getline(fin, line) || line != "S " + settings) {
+    return false;
+  }
+
+  // Read the recorded variables and files.  Each file line holds the kind
+  // of the entry, its size, modification time and mode, and its path.
+  Variables variables;
+  std::vector<Entry> recorded;
+  std::vector<Output> outputs;
+  while (std::getline(fin, line)) {
+    if (line.compare(0, 2, "V ") == 0) {
+      std::string::size_type const pos = line.find(' ', 2);
+      if (pos == std::string::npos) {
+        return false;
+      }
+      variables.emplace_back(line.substr(2, pos - 2), line.substr(pos + 1));
+      continue;
+    }
+    std::istringstream in(line);
+    char kind = 0;
+    Entry e;
+    if (!(in >> kind >> e.Size >> e.Time >> e.Mode) || in.get() != ' ') {
+      return false;
+    }
+    std::getline(in, e.Path);
+    if (kind == 'U' || kind == 'Q') {
+      Output o;
+      o.Path = e.Path;
+      o.ReportUpToDate = kind == 'U';
+      outputs.push_back(std::move(o));
+    } else if (kind != 'I') {
+      return false;
+    }
+    recorded.push_back(std::move(e));
+  }
+
+  // Check that all files are still as recorded.
+  std::vector<Entry> current = recorded;
+  cmInstallState::Stat(current);
+  for (size_t i = 0; i < recorded.size(); ++i) {
+    Entry const& r = recorded[i];
+    Entry const& c = current[i];
+    if (r.Size != c.Size || r.Time != c.Time || r.Mode != c.Mode) {
+      return false;
+    }
+  }
+
+  this->Outputs = std::move(outputs);
+  this->Vars = std::move(variables);
+  return true;
+}
+
+void cmInstallState::Start(std::string const& file,
+                           std::string const& settings)
+{
+  this->File = file;
+  this->Settings = settings;
+  this->Inputs.clear();
+  this->InputSet.clear();
+  this->Outputs.clear();
+  this->Vars.clear();
+
+  // A state left by an earlier run no longer holds once files change.
+  cmSystemTools::RemoveFile(file);
+}
+
+void cmInstallState::AddInput(std::string const& path)
+{
+  if (this->IsRecording() && this->InputSet.insert(path).second) {
+    this->Inputs.push_back(path);
+  }
+}
+
+void cmInstallState::AddOutput(std::string const& path, bool reportUpToDate)
+{
+  if (this->IsRecording()) {
+    Output o;
+    o.Path = path;
+    o.ReportUpToDate = reportUpToDate;
+    this->Outputs.push_back(std::move(o));
+  }
+}
+
+bool cmInstallState::Finish(std::vector<std::string> const& listFiles,
+                            Variables const& variables)
+{
+  if (!this->IsRecording()) {
+    return false;
+  }
+  std::string const file = std::move(this->File);
+  this->File.clear();
+
+  for (std::string const& listFile : listFiles) {
+    this->AddInput(listFile);
+  }
+  std::vector<Entry> inputs(this->Inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i].Path = this->Inputs[i];
+  }
+  std::vector<Entry> outputs(this->Outputs.size());
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    outputs[i].Path = this->Outputs[i].Path;
+  }
+  cmInstallState::Stat(inputs);
+  cmInstallState::Stat(outputs);
+
+  bool const written = cmInstallState::Write(
+    file, this->Settings, inputs, outputs, this->Outputs, variables);
+  this->Inputs.clear();
+  this->InputSet.clear();
+  this->Outputs.clear();
+  return written;
+}
+
+bool cmInstallState::Write(std::string const& file,
+                           std::string const& settings,
+                           std::vector<Entry> const& inputs,
+                           std::vector<Entry> const& outputs,
+                           std::vector<Output> const& reports,
+                           Variables const& variables)
+{
+  // The format is line based.  Do not record what it cannot represent.
+  auto representable = [](std::string const& s) {
+    return s.find_first_of("\r\n") == std::string::npos;
+  };
+  if (!representable(settings)) {
+    return false;
+  }
+  for (auto const& v : variables) {
+    if (!representable(v.first) || v.first.find(' ') != std::string::npos ||
+        !representable(v.second)) {
+      return false;
+    }
+  }
+  for (Entry const& e : inputs) {
+    if (!representable(e.Path)) {
+      return false;
+    }
+  }
+  for (Entry const& e : outputs) {
+    if (!representable(e.Path)) {
+      return false;
+    }
+  }
+
+  cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(file));
+  std::string const tmp = file + ".tmp";
+  {
+    cmsys::ofstream fout(tmp.c_str(), std::ios::out | std::ios::binary);
+    if (!fout) {
+      return false;
+    }
+    fout << "CMakeInstallState 1\n";
+    fout << "S " << settings << "\n";
+    for (auto const& v : variables) {
+      fout << "V " << v.first << " " << v.second << "\n";
+    }
+    for (Entry const& e : inputs) {
+      fout << "I " << e.Size << " " << e.Time << " " << e.Mode << " "
+           << e.Path << "\n";
+    }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      Entry const& e = outputs[i];
+      fout << (reports[i].ReportUpToDate ? "U " : "Q ") << e.Size << " "
+           << e.Time << " " << e.Mode << " " << e.Path << "\n";
+    }
+    if (!fout) {
+      fout.close();
+      cmSystemTools::RemoveFile(tmp);
+      return false;
+    }
+  }
+  return cmSystemTools::RenameFile(tmp.c_str(), file.c_str());
+}
@@ -0,0 +1,79 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmInstallState_h
+#define cmInstallState_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/** \class cmInstallState
+ * \brief Record the files read and written by an install script
+ *
+ * The top-level install script of a project records every file it reads
+ * and every file it installs, together with the settings it ran with.
+ * When it runs again with the same settings and none of these files
+ * changed on disk, the recorded list of installed files is reported
+ * and the variables the rules set are restored instead of evaluating the
+ * install rules again.  Otherwise the install scripts of all directories
+ * run as usual; the state does not describe how to install the files.
+ */
+class cmInstallState
+{
+public:
+  struct Output
+  {
+    std::string Path;
+    bool ReportUpToDate;
+  };
+  typedef std::vector<std::pair<std::string, std::string>> Variables;
+
+  /** Load the state recorded in a file and check that it was recorded
+      with the given settings and that none of its files changed.  */
+  bool Load(std::string const& file, std::string const& settings);
+
+  /** Outputs and variables of the state loaded last.  */
+  std::vector<Output> const& GetOutputs() const { return this->Outputs; }
+  Variables const& GetVariables() const { return this->Vars; }
+
+  /** Start recording a state to be written to the given file.  */
+  void Start(std::string const& file, std::string const& settings);
+  bool IsRecording() const { return !this->File.empty(); }
+
+  /** Record a file or directory read or written by the install rules.  */
+  void AddInput(std::string const& path);
+  void AddOutput(std::string const& path, bool reportUpToDate);
+
+  /** Write the recorded state, adding the install scripts that were read
+      and the variables set by the install rules, and stop recording.  */
+  bool Finish(std::vector<std::string> const& listFiles,
+              Variables const& variables);
+
+private:
+  struct Entry
+  {
+    std::string Path;
+    long long Size;
+    long long Time;
+    unsigned long Mode;
+  };
+
+  static void Stat(std::vector<Entry>& entries);
+  static bool Write(std::string const& file, std::string const& settings,
+                    std::vector<Entry> const& inputs,
+                    std::vector<Entry> const& outputs,
+                    std::vector<Output> const& reports,
+                    Variables const& variables);
+
+  std::string File;
+  std::string Settings;
+  std::vector<std::string> Inputs;
+  std::unordered_set<std::string> InputSet;
+  std::vector<Output> Outputs;
+  Variables Vars;
+};
+
+#endif
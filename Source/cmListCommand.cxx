@@ -81,29 +81,53 @@ bool cmListCommand::GetListString(std::string& listString,
 bool cmListCommand::GetList(std::vector<std::string>& list,
                             const std::string& var)
 {
-  std::string listString;
-  if (!this->GetListString(listString, var)) {
+  std::vector<std::string> const* elements;
+  bool const found = this->GetListElements(elements, list, var);
+  if (elements != &list) {
+    list = *elements;
+  }
+  return found;
+}
+
+bool cmListCommand::GetListElements(std::vector<std::string> const*& elements,
+                                    std::vector<std::string>& storage,
+                                    const std::string& var)
+{
+  elements = &storage;
+  // get the old value
+  const char* value = this->Makefile->GetDefinition(var);
+  if (!value) {
     return false;
   }
   // if the size of the list
-  if (listString.empty()) {
+  if (!*value) {
     return true;
   }
-  // expand the variable into a list
-  cmSystemTools::ExpandListArgument(listString, list, true);
+  // expand the variable into a list, which normal variables cache
+  elements = this->Makefile->GetDefinitionList(var);
+  if (!elements) {
+    cmSystemTools::ExpandListArgument(value, storage, true);
+    elements = &storage;
+  }
   // if no empty elements then just return
-  if (std::find(list.begin(), list.end(), std::string()) == list.end()) {
+  cmPolicies::PolicyStatus const status =
+    this->Makefile->GetPolicyStatus(cmPolicies::CMP0007);
+  if (status == cmPolicies::NEW ||
+      std::find(elements->begin(), elements->end(), std::string()) ==
+        elements->end()) {
     return true;
   }
   // if we have empty elements we need to check policy CMP0007
-  switch (this->Makefile->GetPolicyStatus(cmPolicies::CMP0007)) {
+  std::string const listString = value;
+  switch (status) {
     case cmPolicies::WARN: {
       // Default is to warn and use old behavior
       // OLD behavior is to allow compatibility, so recall
       // ExpandListArgument without the true which will remove
       // empty values
-      list.clear();
-      cmSystemTools::ExpandListArgument(listString, list);
+      storage.clear();
+      cmSystemTools::ExpandListArgument(listString, storage);
+      elements = &storage;
       std::string warn = cmPolicies::GetPolicyWarning(cmPolicies::CMP0007);
       warn += " List has value = [";
       warn += listString;
@@ -115,8 +139,9 @@ bool cmListCommand::GetList(std::vector<std::string>& list,
       // OLD behavior is to allow compatibility, so recall
       // ExpandListArgument without the true which will remove
       // empty values
-      list.clear();
-      cmSystemTools::ExpandListArgument(listString, list);
+      storage.clear();
+      cmSystemTools::ExpandListArgument(listString, storage);
+      elements = &storage;
       return true;
     case cmPolicies::NEW:
       return true;
@@ -139,12 +164,13 @@ bool cmListCommand::HandleLengthCommand(std::vector<std::string> const& args)
 
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
-  std::vector<std::string> varArgsExpanded;
+  std::vector<std::string> storage;
+  std::vector<std::string> const* varArgsExpanded;
   // do not check the return value here
   // if the list var is not found varArgsExpanded will have size 0
   // and we will return 0
-  this->GetList(varArgsExpanded, listName);
-  size_t length = varArgsExpanded.size();
+  this->GetListElements(varArgsExpanded, storage, listName);
+  size_t length = varArgsExpanded->size();
   char buffer[1024];
   sprintf(buffer, "%d", static_cast<int>(length));
 
@@ -162,13 +188,14 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
   // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if (!this->GetList(varArgsExpanded, listName)) {
+  std::vector<std::string> storage;
+  std::vector<std::string> const* varArgsExpanded;
+  if (!this->GetListElements(varArgsExpanded, storage, listName)) {
     this->Makefile->AddDefinition(variableName, "NOTFOUND");
     return true;
   }
   // FIXME: Add policy to make non-existing lists an error like empty lists.
-  if (varArgsExpanded.empty()) {
+  if (varArgsExpanded->empty()) {
     this->SetError("GET given empty list");
     return false;
   }
@@ -176,7 +203,7 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
   std::string value;
   size_t cc;
   const char* sep = "";
-  size_t nitem = varArgsExpanded.size();
+  size_t nitem = varArgsExpanded->size();
   for (cc = 2; cc < args.size() - 1; cc++) {
     int item = atoi(args[cc].c_str());
     value += sep;
@@ -191,7 +218,7 @@ bool cmListCommand::HandleGetCommand(std::vector<std::string> const& args)
       this->SetError(str.str());
       return false;
     }
-    value += varArgsExpanded[item];
+    value += (*varArgsExpanded)[item];
   }
 
   this->Makefile->AddDefinition(variableName, value.c_str());
@@ -208,6 +235,13 @@ bool cmListCommand::HandleAppendCommand(std::vector<std::string> const& args)
   }
 
   const std::string& listName = args[1];
+  std::string const value = cmJoin(cmMakeRange(args).advance(2), ";");
+  // Append in place to normal variables instead of copying the list.
+  if (this->Makefile->GetDefinition(listName) &&
+      this->Makefile->AppendDefinition(listName, value)) {
+    return true;
+  }
+
   // expand the variable
   std::string listString;
   this->GetListString(listString, listName);
@@ -215,7 +249,7 @@ bool cmListCommand::HandleAppendCommand(std::vector<std::string> const& args)
   if (!listString.empty() && !args.empty()) {
     listString += ";";
   }
-  listString += cmJoin(cmMakeRange(args).advance(2), ";");
+  listString += value;
 
   this->Makefile->AddDefinition(listName, listString.c_str());
   return true;
@@ -231,17 +265,18 @@ bool cmListCommand::HandleFindCommand(std::vector<std::string> const& args)
   const std::string& listName = args[1];
   const std::string& variableName = args[args.size() - 1];
   // expand the variable
-  std::vector<std::string> varArgsExpanded;
-  if (!this->GetList(varArgsExpanded, listName)) {
+  std::vector<std::string> storage;
+  std::vector<std::string> const* varArgsExpanded;
+  if (!this->GetListElements(varArgsExpanded, storage, listName)) {
     this->Makefile->AddDefinition(variableName, "-1");
     return true;
   }
 
-  std::vector<std::string>::iterator it =
-    std::find(varArgsExpanded.begin(), varArgsExpanded.end(), args[2]);
-  if (it != varArgsExpanded.end()) {
+  std::vector<std::string>::const_iterator it =
+    std::find(varArgsExpanded->begin(), varArgsExpanded->end(), args[2]);
+  if (it != varArgsExpanded->end()) {
     std::ostringstream indexStream;
-    indexStream << std::distance(varArgsExpanded.begin(), it);
+    indexStream << std::distance(varArgsExpanded->begin(), it);
     this->Makefile->AddDefinition(variableName, indexStream.str().c_str());
     return true;
   }
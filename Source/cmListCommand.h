@@ -48,6 +48,11 @@ protected:
                    std::vector<std::string>& varArgsExpanded);
 
   bool GetList(std::vector<std::string>& list, const std::string& var);
+  // Like GetList, but avoids copying the elements a variable caches.
+  // Points the elements at the cache or at the given storage.
+  bool GetListElements(std::vector<std::string> const*& elements,
+                       std::vector<std::string>& storage,
+                       const std::string& var);
   bool GetListString(std::string& listString, const std::string& var);
 };
 
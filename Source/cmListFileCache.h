@@ -19,6 +19,7 @@
  * cmake list files.
  */
 
+class cmCommand;
 class cmMessenger;
 
 struct cmCommandContext
@@ -94,6 +95,22 @@ bool operator!=(cmListFileContext const& lhs, cmListFileContext const& rhs);
 struct cmListFileFunction : public cmCommandContext
 {
   std::vector<cmListFileArgument> Arguments;
+
+  // The command this call invokes, resolved by cmMakefile::ExecuteCommand
+  // and valid while the command generation of the state does not change.
+  struct Resolution
+  {
+    Resolution()
+      : Command(nullptr)
+      , Generation(0)
+      , ExpiresFindContent(false)
+    {
+    }
+    cmCommand* Command;
+    unsigned long Generation;
+    bool ExpiresFindContent;
+  };
+  mutable Resolution Resolved;
 };
 
 // Represent a backtrace (call stack).  Provide value semantics
@@ -66,6 +66,9 @@ public:
     return this->info.FinalPass != nullptr;
   }
 
+  // The plugin may do anything.
+  bool WritesFiles() const override { return true; }
+
   static const char* LastName;
   static void TrapsForSignals(int sig)
   {
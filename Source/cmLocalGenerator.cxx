@@ -29,6 +29,8 @@
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 #define CM_LG_ENCODE_OBJECT_NAMES
 #include "cmCryptoHash.h"
+#include "cm_jsoncpp_value.h"
+#include "cm_jsoncpp_writer.h"
 #endif
 
 #include "cmsys/RegularExpression.hxx"
@@ -267,12 +269,30 @@ void cmLocalGenerator::GenerateTestFiles()
     }
   }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Describe the tests in a manifest that ctest can load without
+  // executing the script.  Directories with custom test code or with
+  // tests that depend on the configuration requested at test time are
+  // left to the script.
+  Json::Value manifest(Json::objectValue);
+  manifest["version"] = 1;
+  Json::Value& manifestTests = manifest["tests"] = Json::arrayValue;
+  Json::Value& manifestSubdirs = manifest["subdirs"] = Json::arrayValue;
+  bool useManifest = !testIncludeFile && !testIncludeFiles;
+#endif
+
   // Ask each test generator to write its code.
   std::vector<cmTestGenerator*> const& testers =
     this->Makefile->GetTestGenerators();
   for (cmTestGenerator* tester : testers) {
     tester->Compute(this);
     tester->Generate(fout, config, configurationTypes);
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    if (useManifest) {
+      useManifest =
+        tester->GenerateManifest(manifestTests, config, configurationTypes);
+    }
+#endif
   }
   typedef std::vector<cmStateSnapshot> vec_t;
   vec_t const& children = this->Makefile->GetStateSnapshot().GetChildren();
@@ -281,6 +301,9 @@ void cmLocalGenerator::GenerateTestFiles()
     // TODO: Use add_subdirectory instead?
     std::string outP = i.GetDirectory().GetCurrentBinary();
     outP = this->ConvertToRelativePath(parentBinDir, outP);
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    manifestSubdirs.append(outP);
+#endif
     outP = cmOutputConverter::EscapeForCMake(outP);
     fout << "subdirs(" << outP << ")" << std::endl;
   }
@@ -291,18 +314,37 @@ void cmLocalGenerator::GenerateTestFiles()
   const char* labels = this->Makefile->GetProperty("LABELS");
 
   if (labels || directoryLabels) {
-    fout << "set_directory_properties(PROPERTIES LABELS ";
+    std::string allLabels;
     if (labels) {
-      fout << cmOutputConverter::EscapeForCMake(labels);
+      allLabels = labels;
     }
     if (labels && directoryLabels) {
-      fout << ";";
+      allLabels += ";";
     }
     if (directoryLabels) {
-      fout << cmOutputConverter::EscapeForCMake(directoryLabels);
+      allLabels += directoryLabels;
     }
-    fout << ")" << std::endl;
+    fout << "set_directory_properties(PROPERTIES LABELS "
+         << cmOutputConverter::EscapeForCMake(allLabels) << ")" << std::endl;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    manifest["labels"] = allLabels;
+#endif
   }
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // The manifest is always rewritten so that it is never older than
+  // the script it describes.
+  std::string manifestFile =
+    this->StateSnapshot.GetDirectory().GetCurrentBinary();
+  manifestFile += "/CTestTestfile.json";
+  if (useManifest) {
+    Json::FastWriter writer;
+    cmGeneratedFileStream mout(manifestFile.c_str());
+    mout << writer.write(manifest);
+  } else {
+    cmSystemTools::RemoveFile(manifestFile);
+  }
+#endif
 }
 
 void cmLocalGenerator::CreateEvaluationFileOutputs(std::string const& config)
@@ -315,12 +357,13 @@ void cmLocalGenerator::CreateEvaluationFileOutputs(std::string const& config)
 }
 
 void cmLocalGenerator::ProcessEvaluationFiles(
-  std::vector<std::string>& generatedFiles)
+  std::vector<std::string>& generatedFiles,
+  std::map<std::string, std::string>& inputFiles)
 {
   std::vector<cmGeneratorExpressionEvaluationFile*> ef =
     this->Makefile->GetEvaluationFiles();
   for (cmGeneratorExpressionEvaluationFile* geef : ef) {
-    geef->Generate(this);
+    geef->Generate(this, inputFiles);
     if (cmSystemTools::GetFatalErrorOccured()) {
       return;
     }
@@ -345,6 +388,27 @@ void cmLocalGenerator::ProcessEvaluationFiles(
   }
 }
 
+// Whether any install rule of the project runs code given by the user.
+static bool cmLocalGeneratorInstallRunsCode(cmGlobalGenerator* gg)
+{
+  for (cmLocalGenerator* lg : gg->GetLocalGenerators()) {
+    for (cmInstallGenerator* installer :
+         lg->GetMakefile()->GetInstallGenerators()) {
+      if (dynamic_cast<cmInstallScriptGenerator*>(installer)) {
+        return true;
+      }
+    }
+    for (cmGeneratorTarget* gt : lg->GetGeneratorTargets()) {
+      if (gt->GetType() != cmStateEnums::INTERFACE_LIBRARY &&
+          (gt->GetProperty("PRE_INSTALL_SCRIPT") ||
+           gt->GetProperty("POST_INSTALL_SCRIPT"))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void cmLocalGenerator::GenerateInstallRules()
 {
   // Compute the install prefix.
@@ -500,6 +564,30 @@ void cmLocalGenerator::GenerateInstallRules()
     /* clang-format on */
   }
 
+  // Skip all install rules if they ran before with the same settings and
+  // no file they read or wrote changed since.  Rules running user code
+  // may do something different each time.
+  bool const installState = toplevel_install &&
+    !cmLocalGeneratorInstallRunsCode(this->GlobalGenerator);
+  if (installState) {
+    /* clang-format off */
+    fout <<
+      "# Check whether the files installed last time are up to date.\n"
+      "file(INSTALL_STATE BEGIN\n"
+      "     \"" << homedir << "/CMakeFiles/InstallState\"\n"
+      "     CMAKE_INSTALL_UP_TO_DATE\n"
+      "     \"${CMAKE_INSTALL_PREFIX}\" \"${CMAKE_INSTALL_CONFIG_NAME}\"\n"
+      "     \"${CMAKE_INSTALL_COMPONENT}\" \"${CMAKE_INSTALL_LOCAL_ONLY}\"\n"
+      "     \"${CMAKE_INSTALL_DO_STRIP}\" \"${CMAKE_INSTALL_SO_NO_EXE}\"\n"
+      "     \"${CMAKE_CROSSCOMPILING}\"\n"
+      "     \"${CMAKE_INSTALL_DEFAULT_DIRECTORY_PERMISSIONS}\"\n"
+      "     \"${CMAKE_ERROR_ON_ABSOLUTE_INSTALL_DESTINATION}\"\n"
+      "     \"$ENV{DESTDIR}\")\n"
+      "if(NOT CMAKE_INSTALL_UP_TO_DATE)\n"
+      "\n";
+    /* clang-format on */
+  }
+
   // Ask each install generator to write its code.
   std::vector<cmInstallGenerator*> const& installers =
     this->Makefile->GetInstallGenerators();
@@ -528,6 +616,10 @@ void cmLocalGenerator::GenerateInstallRules()
     fout << "endif()\n\n";
   }
 
+  if (installState) {
+    fout << "endif()\n\n";
+  }
+
   // Record the install manifest.
   if (toplevel_install) {
     /* clang-format off */
@@ -545,6 +637,11 @@ void cmLocalGenerator::GenerateInstallRules()
       "     \"${CMAKE_INSTALL_MANIFEST_CONTENT}\")\n";
     /* clang-format on */
   }
+
+  // Record the files read and written for the next run.
+  if (installState) {
+    fout << "\nfile(INSTALL_STATE END)\n";
+  }
 }
 
 void cmLocalGenerator::AddGeneratorTarget(cmGeneratorTarget* gt)
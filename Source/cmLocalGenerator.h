@@ -351,7 +351,8 @@ public:
   void IssueMessage(cmake::MessageType t, std::string const& text) const;
 
   void CreateEvaluationFileOutputs(const std::string& config);
-  void ProcessEvaluationFiles(std::vector<std::string>& generatedFiles);
+  void ProcessEvaluationFiles(std::vector<std::string>& generatedFiles,
+                              std::map<std::string, std::string>& inputFiles);
 
   const char* GetRuleLauncher(cmGeneratorTarget* target,
                               const std::string& prop);
@@ -350,13 +350,15 @@ void cmLocalNinjaGenerator::AppendCustomCommandLines(
 
   std::string launcher = this->MakeCustomLauncher(ccg);
 
-  for (unsigned i = 0; i != ccg.GetNumberOfCommands(); ++i) {
+  for (unsigned i = 0, n = 1; i != ccg.GetNumberOfCommands(); i += n) {
+    // Run consecutive file operations of cmake in one process.
+    n = ccg.GetBatchSize(i);
     cmdLines.push_back(launcher +
                        this->ConvertToOutputFormat(ccg.GetCommand(i),
                                                    cmOutputConverter::SHELL));
 
     std::string& cmd = cmdLines.back();
-    ccg.AppendArguments(i, cmd);
+    ccg.AppendBatchArguments(i, n, cmd);
   }
 }
 
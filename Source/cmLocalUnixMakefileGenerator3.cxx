@@ -773,6 +773,18 @@ void cmLocalUnixMakefileGenerator3::WriteSpecialTargetsBottom(
 
     std::vector<std::string> no_depends;
     std::vector<std::string> commands;
+    // Check the CONFIGURE_DEPENDS globs first since a changed result
+    // touches a file the build system depends on.
+    std::string const& verifyScript =
+      this->GlobalGenerator->GetGlobVerifyScript();
+    if (!verifyScript.empty()) {
+      std::string verifyRule = "$(CMAKE_COMMAND) -P ";
+      verifyRule += this->ConvertToOutputFormat(
+        this->MaybeConvertToRelativePath(this->GetBinaryDirectory(),
+                                         verifyScript),
+        cmOutputConverter::SHELL);
+      commands.push_back(std::move(verifyRule));
+    }
     commands.push_back(std::move(runRule));
     if (!this->IsRootMakefile()) {
       this->CreateCDCommand(commands, this->GetBinaryDirectory(),
@@ -921,7 +933,10 @@ void cmLocalUnixMakefileGenerator3::AppendCustomCommand(
   // Add each command line to the set of commands.
   std::vector<std::string> commands1;
   std::string currentBinDir = this->GetCurrentBinaryDirectory();
-  for (unsigned int c = 0; c < ccg.GetNumberOfCommands(); ++c) {
+  for (unsigned int c = 0, n = 1; c < ccg.GetNumberOfCommands(); c += n) {
+    // Run consecutive file operations of cmake in one process.
+    n = ccg.GetBatchSize(c);
+
     // Build the command line in a single string.
     std::string cmd = ccg.GetCommand(c);
     if (!cmd.empty()) {
@@ -992,7 +1007,7 @@ void cmLocalUnixMakefileGenerator3::AppendCustomCommand(
       }
       cmd = launcher + shellCommand;
 
-      ccg.AppendArguments(c, cmd);
+      ccg.AppendBatchArguments(c, n, cmd);
       if (content) {
         // Rule content does not include the launcher.
         *content << (cmd.c_str() + launcher.size());
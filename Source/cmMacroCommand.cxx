@@ -2,6 +2,7 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmMacroCommand.h"
 
+#include <memory>
 #include <sstream>
 #include <stdio.h>
 #include <utility>
@@ -28,7 +29,8 @@ public:
   cmCommand* Clone() override
   {
     cmMacroHelperCommand* newC = new cmMacroHelperCommand;
-    // we must copy when we clone
+    // we must copy when we clone, but the body is shared so that calls
+    // keep the commands they resolved to
     newC->Args = this->Args;
     newC->Functions = this->Functions;
     newC->FilePath = this->FilePath;
@@ -50,7 +52,7 @@ public:
   }
 
   std::vector<std::string> Args;
-  std::vector<cmListFileFunction> Functions;
+  std::shared_ptr<std::vector<cmListFileFunction> const> Functions;
   cmPolicies::PolicyMap Policies;
   std::string FilePath;
 };
@@ -99,12 +101,13 @@ bool cmMacroHelperCommand::InvokeInitialPass(
   // Invoke all the functions that were collected in the block.
   cmListFileFunction newLFF;
   // for each function
-  for (cmListFileFunction const& func : this->Functions) {
+  for (cmListFileFunction const& func : *this->Functions) {
     // Replace the formal arguments and then invoke the command.
     newLFF.Arguments.clear();
     newLFF.Arguments.reserve(func.Arguments.size());
     newLFF.Name = func.Name;
     newLFF.Line = func.Line;
+    newLFF.Resolved = func.Resolved;
 
     // for each argument of the current function
     for (cmListFileArgument const& k : func.Arguments) {
@@ -135,8 +138,9 @@ bool cmMacroHelperCommand::InvokeInitialPass(
       newLFF.Arguments.push_back(std::move(arg));
     }
     cmExecutionStatus status;
-    if (!this->Makefile->ExecuteCommand(newLFF, status) ||
-        status.GetNestedError()) {
+    bool const executed = this->Makefile->ExecuteCommand(newLFF, status);
+    func.Resolved = newLFF.Resolved;
+    if (!executed || status.GetNestedError()) {
       // The error message should have already included the call stack
       // so we do not need to report an error here.
       macroScope.Quiet();
@@ -170,7 +174,9 @@ bool cmMacroFunctionBlocker::IsFunctionBlocked(const cmListFileFunction& lff,
       // create a new command and add it to cmake
       cmMacroHelperCommand* f = new cmMacroHelperCommand();
       f->Args = this->Args;
-      f->Functions = this->Functions;
+      f->Functions =
+        std::make_shared<std::vector<cmListFileFunction> const>(
+          std::move(this->Functions));
       f->FilePath = this->GetStartingContext().FilePath;
       mf.RecordPolicies(f->Policies);
       mf.GetState()->AddScriptedCommand(this->Args[0], f);
@@ -17,6 +17,7 @@
 #include "cmAlgorithms.h"
 #include "cmCommand.h"
 #include "cmCommandArgumentParserHelper.h"
+#include "cmCoreTryCompile.h" // IWYU pragma: keep
 #include "cmCustomCommand.h"
 #include "cmCustomCommandLines.h"
 #include "cmExecutionStatus.h"
@@ -28,6 +29,7 @@
 #include "cmGlobalGenerator.h"
 #include "cmInstallGenerator.h" // IWYU pragma: keep
 #include "cmListFileCache.h"
+#include "cmRegularExpression.h"
 #include "cmSourceFile.h"
 #include "cmSourceFileLocation.h"
 #include "cmState.h"
@@ -291,14 +293,24 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
     return result;
   }
 
-  std::string name = lff.Name;
+  std::string const& name = lff.Name;
 
   // Place this call on the call stack.
   cmMakefileCall stack_manager(this, lff, status);
   static_cast<void>(stack_manager);
 
-  // Lookup the command prototype.
-  if (cmCommand* proto = this->GetState()->GetCommand(name)) {
+  // Lookup the command prototype once per call until commands change.
+  cmListFileFunction::Resolution& resolved = lff.Resolved;
+  unsigned long const generation = this->GetState()->GetCommandGeneration();
+  if (resolved.Generation != generation) {
+    std::string const sName = cmSystemTools::LowerCase(name);
+    resolved.Command = this->GetState()->GetCommand(sName);
+    resolved.ExpiresFindContent =
+      resolved.Command && resolved.Command->WritesFiles();
+    resolved.Generation = generation;
+  }
+  bool const expiresFindContent = resolved.ExpiresFindContent;
+  if (cmCommand* proto = resolved.Command) {
     // Clone the prototype.
     std::unique_ptr<cmCommand> pcmd(proto->Clone());
     pcmd->SetMakefile(this);
@@ -326,6 +338,9 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
         // use the command
         this->FinalPassCommands.push_back(pcmd.release());
       }
+      if (expiresFindContent) {
+        this->GetGlobalGenerator()->ExpireFindDirectoryContent();
+      }
     }
   } else {
     if (!cmSystemTools::GetFatalErrorOccured()) {
@@ -1486,6 +1501,12 @@ void cmMakefile::Configure()
   }
 
   this->ReadListFile(listFile, currentStart);
+  if (this->TryCompileBatch) {
+    this->IssueMessage(cmake::FATAL_ERROR,
+                       "try_compile_batch(BEGIN) has no matching "
+                       "try_compile_batch(END) in this directory.");
+    this->TryCompileBatch.reset();
+  }
   if (cmSystemTools::GetFatalErrorOccured()) {
     scope.Quiet();
   }
@@ -1666,6 +1687,28 @@ void cmMakefile::AddDefinition(const std::string& name, const char* value)
 #endif
 }
 
+bool cmMakefile::AppendDefinition(const std::string& name,
+                                  const std::string& value)
+{
+  // The old value is used by the new one.
+  if (!this->StateSnapshot.GetDefinition(name)) {
+    return false;
+  }
+  if (this->VariableInitialized(name)) {
+    this->LogUnused("changing definition", name);
+  }
+  this->StateSnapshot.AppendDefinition(name, value);
+
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  cmVariableWatch* vv = this->GetVariableWatch();
+  if (vv) {
+    vv->VariableAccessed(name, cmVariableWatch::VARIABLE_MODIFIED_ACCESS,
+                         this->StateSnapshot.GetDefinition(name), this);
+  }
+#endif
+  return true;
+}
+
 void cmMakefile::AddCacheDefinition(const std::string& name, const char* value,
                                     const char* doc,
                                     cmStateEnums::CacheEntryType type,
@@ -2365,6 +2408,12 @@ const char* cmMakefile::GetDefinition(const std::string& name) const
   return def;
 }
 
+std::vector<std::string> const* cmMakefile::GetDefinitionList(
+  const std::string& name) const
+{
+  return this->StateSnapshot.GetDefinitionList(name);
+}
+
 const char* cmMakefile::GetSafeDefinition(const std::string& def) const
 {
   const char* ret = this->GetDefinition(def);
@@ -3232,6 +3281,31 @@ int cmMakefile::TryCompile(const std::string& srcdir,
                            std::string& output)
 {
   this->IsSourceFileTryCompile = fast;
+  int ret = this->ConfigureTryCompile(srcdir, bindir, cmakeArgs);
+  if (ret < 0) {
+    ret = 1;
+  } else if (ret == 1) {
+    this->IssueMessage(cmake::FATAL_ERROR,
+                       "Failed to configure test project build system.");
+    cmSystemTools::SetFatalErrorOccured();
+  } else if (ret == 2) {
+    this->IssueMessage(cmake::FATAL_ERROR,
+                       "Failed to generate test project build system.");
+    cmSystemTools::SetFatalErrorOccured();
+  } else {
+    // finally call the generator to actually build the resulting project
+    ret = this->GetGlobalGenerator()->TryCompile(
+      srcdir, bindir, projectName, targetName, fast, output, this);
+  }
+
+  this->IsSourceFileTryCompile = false;
+  return ret;
+}
+
+int cmMakefile::ConfigureTryCompile(const std::string& srcdir,
+                                    const std::string& bindir,
+                                    const std::vector<std::string>* cmakeArgs)
+{
   // does the binary directory exist ? If not create it...
   if (!cmSystemTools::FileIsDirectory(bindir)) {
     cmSystemTools::MakeDirectory(bindir);
@@ -3253,8 +3327,7 @@ int cmMakefile::TryCompile(const std::string& srcdir,
                          this->GetGlobalGenerator()->GetName() +
                          "' could not be created.");
     cmSystemTools::SetFatalErrorOccured();
-    this->IsSourceFileTryCompile = false;
-    return 1;
+    return -1;
   }
   cm.SetGlobalGenerator(gg);
 
@@ -3314,27 +3387,13 @@ int cmMakefile::TryCompile(const std::string& srcdir,
                      cmStateEnums::INTERNAL);
   }
   if (cm.Configure() != 0) {
-    this->IssueMessage(cmake::FATAL_ERROR,
-                       "Failed to configure test project build system.");
-    cmSystemTools::SetFatalErrorOccured();
-    this->IsSourceFileTryCompile = false;
     return 1;
   }
 
   if (cm.Generate() != 0) {
-    this->IssueMessage(cmake::FATAL_ERROR,
-                       "Failed to generate test project build system.");
-    cmSystemTools::SetFatalErrorOccured();
-    this->IsSourceFileTryCompile = false;
-    return 1;
+    return 2;
   }
-
-  // finally call the generator to actually build the resulting project
-  int ret = this->GetGlobalGenerator()->TryCompile(
-    srcdir, bindir, projectName, targetName, fast, output, this);
-
-  this->IsSourceFileTryCompile = false;
-  return ret;
+  return 0;
 }
 
 bool cmMakefile::GetIsSourceFileTryCompile() const
@@ -3342,6 +3401,26 @@ bool cmMakefile::GetIsSourceFileTryCompile() const
   return this->IsSourceFileTryCompile;
 }
 
+void cmMakefile::SetIsSourceFileTryCompile(bool fast)
+{
+  this->IsSourceFileTryCompile = fast;
+}
+
+cmTryCompileBatch* cmMakefile::GetTryCompileBatch() const
+{
+  return this->TryCompileBatch.get();
+}
+
+void cmMakefile::SetTryCompileBatch(std::unique_ptr<cmTryCompileBatch> batch)
+{
+  this->TryCompileBatch = std::move(batch);
+}
+
+std::unique_ptr<cmTryCompileBatch> cmMakefile::ReleaseTryCompileBatch()
+{
+  return std::move(this->TryCompileBatch);
+}
+
 cmake* cmMakefile::GetCMakeInstance() const
 {
   return this->GlobalGenerator->GetCMakeInstance();
@@ -3996,7 +4075,7 @@ void cmMakefile::ClearMatches()
   this->MarkVariableAsUsed(nMatchesVariable);
 }
 
-void cmMakefile::StoreMatches(cmsys::RegularExpression& re)
+void cmMakefile::StoreMatches(cmRegularExpression& re)
 {
   char highest = 0;
   for (int i = 0; i < 10; i++) {
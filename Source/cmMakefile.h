@@ -41,11 +41,13 @@ class cmGeneratorExpressionEvaluationFile;
 class cmGlobalGenerator;
 class cmInstallGenerator;
 class cmMessenger;
+class cmRegularExpression;
 class cmSourceFile;
 class cmState;
 class cmTest;
 class cmTestGenerator;
 class cmVariableWatch;
+struct cmTryCompileBatch;
 
 /** \class cmMakefile
  * \brief Process the input CMakeLists.txt file.
@@ -105,7 +107,25 @@ public:
                  bool fast, const std::vector<std::string>* cmakeArgs,
                  std::string& output);
 
+  /**
+   * Configure and generate a try_compile project without building it.
+   * Returns 0 on success, 1 if the configure step failed, or 2 if the
+   * generate step failed.  Reporting these is up to the caller.  Returns
+   * -1 after reporting that the generator could not be created.
+   */
+  int ConfigureTryCompile(const std::string& srcdir, const std::string& bindir,
+                          const std::vector<std::string>* cmakeArgs);
+
   bool GetIsSourceFileTryCompile() const;
+  void SetIsSourceFileTryCompile(bool fast);
+
+  /**
+   * The try_compile calls deferred by try_compile_batch(BEGIN) in this
+   * directory, if a batch is open.
+   */
+  cmTryCompileBatch* GetTryCompileBatch() const;
+  void SetTryCompileBatch(std::unique_ptr<cmTryCompileBatch> batch);
+  std::unique_ptr<cmTryCompileBatch> ReleaseTryCompileBatch();
 
   /**
    * Help enforce global target name uniqueness.
@@ -242,6 +262,13 @@ public:
    * can be used in CMake to refer to lists, directories, etc.
    */
   void AddDefinition(const std::string& name, const char* value);
+  /**
+   * Append a list to a variable definition, separated by a semicolon if
+   * the variable is not empty.  This takes time proportional to the size
+   * of the appended list only.  Returns false and does nothing if the
+   * variable is not set, or set only in the cache.
+   */
+  bool AppendDefinition(const std::string& name, const std::string& value);
   ///! Add a definition to this makefile and the global cmake cache.
   void AddCacheDefinition(const std::string& name, const char* value,
                           const char* doc, cmStateEnums::CacheEntryType type,
@@ -420,6 +447,14 @@ public:
   const char* GetSafeDefinition(const std::string&) const;
   const char* GetRequiredDefinition(const std::string& name) const;
   bool IsDefinitionSet(const std::string&) const;
+  /**
+   * Given a variable name, return its value split as a list, keeping
+   * empty elements.  The split is cached until the variable changes.
+   * Returns null if the variable is not set or set only in the cache.
+   * Unlike GetDefinition, this does not notify variable watches.
+   */
+  std::vector<std::string> const* GetDefinitionList(
+    const std::string& name) const;
   /**
    * Get the list of all variables in the current space. If argument
    * cacheonly is specified and is greater than 0, then only cache
@@ -810,7 +845,7 @@ public:
   bool IsLoopBlock() const;
 
   void ClearMatches();
-  void StoreMatches(cmsys::RegularExpression& re);
+  void StoreMatches(cmRegularExpression& re);
 
   cmStateSnapshot GetStateSnapshot() const;
 
@@ -1000,6 +1035,7 @@ private:
   bool CheckCMP0000;
   bool IsSourceFileTryCompile;
   mutable bool SuppressWatches;
+  std::unique_ptr<cmTryCompileBatch> TryCompileBatch;
 };
 
 #endif
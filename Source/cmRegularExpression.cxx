@@ -0,0 +1,534 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmRegularExpression.h"
+
+#include "cmsys/RegularExpression.hxx"
+#include <algorithm>
+#include <bitset>
+#include <string.h>
+#include <unordered_map>
+#include <utility>
+
+struct cmRegularExpression::Program
+{
+  enum OpCode
+  {
+    Char,  // Match character C.
+    Any,   // Match any character.
+    Class, // Match a character of Classes[X].
+    Bol,   // Match at the beginning of the string.
+    Eol,   // Match at the end of the string.
+    Split, // Continue at X, or with lower priority at Y.
+    Jmp,   // Continue at X.
+    Save,  // Record the current offset in capture slot X.
+    Match  // Report a match.
+  };
+
+  struct Inst
+  {
+    OpCode Op;
+    unsigned char C;
+    int X;
+    int Y;
+  };
+
+  std::vector<Inst> Code;
+  std::vector<std::bitset<256>> Classes;
+  int NumCaptures = 2;
+  bool Anchored = false;
+  int FirstChar = -1;
+};
+
+namespace {
+
+typedef cmRegularExpression::Program Program;
+
+// A parsed expression.  The grammar and the meaning of each construct
+// follow the compiler of cmsys::RegularExpression.
+struct Node
+{
+  enum NodeKind
+  {
+    Empty,
+    Char,
+    Any,
+    Class,
+    Bol,
+    Eol,
+    Group,
+    Concat,
+    Alt,
+    Star,
+    Plus,
+    Quest
+  };
+
+  explicit Node(NodeKind kind)
+    : Kind(kind)
+  {
+  }
+
+  NodeKind Kind;
+  unsigned char C = 0;
+  int Index = 0;
+  std::vector<std::unique_ptr<Node>> Children;
+};
+
+class Parser
+{
+public:
+  Parser(const char* pattern, Program& prog)
+    : P(pattern)
+    , Prog(prog)
+  {
+  }
+
+  // The pattern has been validated by cmsys::RegularExpression.
+  std::unique_ptr<Node> Parse() { return this->Reg(false); }
+  int GetNumberOfGroups() const { return this->NPar; }
+
+private:
+  const char* P;
+  Program& Prog;
+  int NPar = 1;
+
+  std::unique_ptr<Node> Reg(bool paren);
+  std::unique_ptr<Node> Branch();
+  std::unique_ptr<Node> Piece();
+  std::unique_ptr<Node> Atom();
+};
+
+std::unique_ptr<Node> Parser::Reg(bool paren)
+{
+  std::unique_ptr<Node> alt(new Node(Node::Alt));
+  alt->Children.push_back(this->Branch());
+  while (*this->P == '|') {
+    ++this->P;
+    alt->Children.push_back(this->Branch());
+  }
+  if (paren && *this->P == ')') {
+    ++this->P;
+  }
+  if (alt->Children.size() == 1) {
+    return std::move(alt->Children.front());
+  }
+  return alt;
+}
+
+std::unique_ptr<Node> Parser::Branch()
+{
+  std::unique_ptr<Node> concat(new Node(Node::Concat));
+  while (*this->P != '\0' && *this->P != '|' && *this->P != ')') {
+    concat->Children.push_back(this->Piece());
+  }
+  if (concat->Children.empty()) {
+    return std::unique_ptr<Node>(new Node(Node::Empty));
+  }
+  if (concat->Children.size() == 1) {
+    return std::move(concat->Children.front());
+  }
+  return concat;
+}
+
+std::unique_ptr<Node> Parser::Piece()
+{
+  std::unique_ptr<Node> atom = this->Atom();
+  Node::NodeKind kind;
+  switch (*this->P) {
+    case '*':
+      kind = Node::Star;
+      break;
+    case '+':
+      kind = Node::Plus;
+      break;
+    case '?':
+      kind = Node::Quest;
+      break;
+    default:
+      return atom;
+  }
+  ++this->P;
+  std::unique_ptr<Node> piece(new Node(kind));
+  piece->Children.push_back(std::move(atom));
+  return piece;
+}
+
+std::unique_ptr<Node> Parser::Atom()
+{
+  char const c = *this->P++;
+  switch (c) {
+    case '^':
+      return std::unique_ptr<Node>(new Node(Node::Bol));
+    case '$':
+      return std::unique_ptr<Node>(new Node(Node::Eol));
+    case '.':
+      return std::unique_ptr<Node>(new Node(Node::Any));
+    case '(': {
+      std::unique_ptr<Node> group(new Node(Node::Group));
+      group->Index = this->NPar++;
+      group->Children.push_back(this->Reg(true));
+      return group;
+    }
+    case '[': {
+      std::bitset<256> set;
+      bool const negate = *this->P == '^';
+      if (negate) {
+        ++this->P;
+      }
+      if (*this->P == ']' || *this->P == '-') {
+        set.set(static_cast<unsigned char>(*this->P++));
+      }
+      while (*this->P != '\0' && *this->P != ']') {
+        if (*this->P == '-') {
+          ++this->P;
+          if (*this->P == ']' || *this->P == '\0') {
+            set.set('-');
+          } else {
+            // A range starts after the character before the dash, which
+            // is already in the set.
+            int first = static_cast<unsigned char>(this->P[-2]) + 1;
+            int const last = static_cast<unsigned char>(*this->P);
+            for (; first <= last; ++first) {
+              set.set(static_cast<size_t>(first));
+            }
+            ++this->P;
+          }
+        } else {
+          set.set(static_cast<unsigned char>(*this->P++));
+        }
+      }
+      if (*this->P == ']') {
+        ++this->P;
+      }
+      if (negate) {
+        set.flip();
+      }
+      set.reset(0);
+      std::unique_ptr<Node> node(new Node(Node::Class));
+      node->Index = static_cast<int>(this->Prog.Classes.size());
+      this->Prog.Classes.push_back(set);
+      return node;
+    }
+    case '\\': {
+      std::unique_ptr<Node> node(new Node(Node::Char));
+      node->C = static_cast<unsigned char>(*this->P++);
+      return node;
+    }
+    default: {
+      std::unique_ptr<Node> node(new Node(Node::Char));
+      node->C = static_cast<unsigned char>(c);
+      return node;
+    }
+  }
+}
+
+class Emitter
+{
+public:
+  explicit Emitter(Program& prog)
+    : Code(prog.Code)
+  {
+  }
+
+  void Emit(Node const& node);
+
+private:
+  std::vector<Program::Inst>& Code;
+
+  int Add(Program::OpCode op, int x = 0, int y = 0, unsigned char c = 0)
+  {
+    Program::Inst inst;
+    inst.Op = op;
+    inst.C = c;
+    inst.X = x;
+    inst.Y = y;
+    this->Code.push_back(inst);
+    return static_cast<int>(this->Code.size()) - 1;
+  }
+  int Next() const { return static_cast<int>(this->Code.size()); }
+};
+
+void Emitter::Emit(Node const& node)
+{
+  switch (node.Kind) {
+    case Node::Empty:
+      break;
+    case Node::Char:
+      this->Add(Program::Char, 0, 0, node.C);
+      break;
+    case Node::Any:
+      this->Add(Program::Any);
+      break;
+    case Node::Class:
+      this->Add(Program::Class, node.Index);
+      break;
+    case Node::Bol:
+      this->Add(Program::Bol);
+      break;
+    case Node::Eol:
+      this->Add(Program::Eol);
+      break;
+    case Node::Group:
+      this->Add(Program::Save, 2 * node.Index);
+      this->Emit(*node.Children.front());
+      this->Add(Program::Save, 2 * node.Index + 1);
+      break;
+    case Node::Concat:
+      for (auto const& child : node.Children) {
+        this->Emit(*child);
+      }
+      break;
+    case Node::Alt: {
+      // Alternatives are tried in order.
+      std::vector<int> jumps;
+      for (size_t i = 0; i + 1 < node.Children.size(); ++i) {
+        int const split = this->Add(Program::Split, this->Next() + 1);
+        this->Emit(*node.Children[i]);
+        jumps.push_back(this->Add(Program::Jmp));
+        this->Code[split].Y = this->Next();
+      }
+      this->Emit(*node.Children.back());
+      for (int j : jumps) {
+        this->Code[j].X = this->Next();
+      }
+    } break;
+    case Node::Star: {
+      int const split = this->Add(Program::Split, this->Next() + 1);
+      this->Emit(*node.Children.front());
+      this->Add(Program::Jmp, split);
+      this->Code[split].Y = this->Next();
+    } break;
+    case Node::Plus: {
+      int const begin = this->Next();
+      this->Emit(*node.Children.front());
+      this->Add(Program::Split, begin, this->Next() + 1);
+    } break;
+    case Node::Quest: {
+      int const split = this->Add(Program::Split, this->Next() + 1);
+      this->Emit(*node.Children.front());
+      this->Code[split].Y = this->Next();
+    } break;
+  }
+}
+
+typedef std::unordered_map<std::string, std::shared_ptr<Program const>>
+  ProgramCache;
+
+ProgramCache& GetProgramCache()
+{
+  static ProgramCache cache;
+  return cache;
+}
+
+// Bound the memory held by patterns built from changing input.
+size_t const MaxCacheSize = 4096;
+}
+
+cmRegularExpression::cmRegularExpression()
+  : SearchString(nullptr)
+{
+  std::fill(this->Offsets, this->Offsets + 2 * NSUBEXP, std::string::npos);
+}
+
+cmRegularExpression::~cmRegularExpression()
+{
+}
+
+bool cmRegularExpression::compile(std::string const& pattern)
+{
+  ProgramCache& cache = GetProgramCache();
+  ProgramCache::const_iterator it = cache.find(pattern);
+  if (it != cache.end()) {
+    this->Prog = it->second;
+    return true;
+  }
+
+  // Let cmsys::RegularExpression decide which patterns are valid and
+  // report the errors.
+  cmsys::RegularExpression check;
+  if (!check.compile(pattern)) {
+    this->Prog.reset();
+    return false;
+  }
+
+  std::shared_ptr<Program> prog = std::make_shared<Program>();
+  Parser parser(pattern.c_str(), *prog);
+  std::unique_ptr<Node> root = parser.Parse();
+  prog->NumCaptures = 2 * parser.GetNumberOfGroups();
+  Emitter emitter(*prog);
+  prog->Code.push_back(Program::Inst{ Program::Save, 0, 0, 0 });
+  emitter.Emit(*root);
+  prog->Code.push_back(Program::Inst{ Program::Save, 0, 1, 0 });
+  prog->Code.push_back(Program::Inst{ Program::Match, 0, 0, 0 });
+
+  // A match can only start at the beginning of the string, or with a
+  // known character.
+  Program::Inst const& first = prog->Code[1];
+  prog->Anchored = first.Op == Program::Bol;
+  if (first.Op == Program::Char) {
+    prog->FirstChar = first.C;
+  }
+
+  if (cache.size() >= MaxCacheSize) {
+    cache.clear();
+  }
+  cache[pattern] = prog;
+  this->Prog = prog;
+  return true;
+}
+
+size_t cmRegularExpression::GetCacheSize()
+{
+  return GetProgramCache().size();
+}
+
+std::string cmRegularExpression::match(int n) const
+{
+  std::string::size_type const b = this->start(n);
+  std::string::size_type const e = this->end(n);
+  if (b == std::string::npos || e == std::string::npos) {
+    return std::string();
+  }
+  return std::string(this->SearchString + b, e - b);
+}
+
+void cmRegularExpression::AddThread(ThreadList& list, int pc, const char* sp)
+{
+  Program const& prog = *this->Prog;
+  size_t const ncap = static_cast<size_t>(prog.NumCaptures);
+
+  // Follow the instructions that do not consume input, trying higher
+  // priority paths first.  Entries with a negative program counter
+  // restore a capture slot modified by a path that has been explored.
+  this->Stack.clear();
+  this->Stack.emplace_back(pc, 0);
+  while (!this->Stack.empty()) {
+    std::pair<int, std::string::size_type> const entry = this->Stack.back();
+    this->Stack.pop_back();
+    if (entry.first < 0) {
+      this->Captures[static_cast<size_t>(-entry.first - 1)] = entry.second;
+      continue;
+    }
+    pc = entry.first;
+    for (;;) {
+      size_t const upc = static_cast<size_t>(pc);
+      int const slot = list.Sparse[upc];
+      if (slot < static_cast<int>(list.Dense.size()) &&
+          list.Dense[static_cast<size_t>(slot)] == pc) {
+        break; // A thread with higher priority is already here.
+      }
+      list.Sparse[upc] = static_cast<int>(list.Dense.size());
+      list.Dense.push_back(pc);
+
+      Program::Inst const& inst = prog.Code[upc];
+      if (inst.Op == Program::Jmp) {
+        pc = inst.X;
+      } else if (inst.Op == Program::Split) {
+        this->Stack.emplace_back(inst.Y, 0);
+        pc = inst.X;
+      } else if (inst.Op == Program::Save) {
+        size_t const x = static_cast<size_t>(inst.X);
+        this->Stack.emplace_back(-inst.X - 1, this->Captures[x]);
+        this->Captures[x] =
+          static_cast<std::string::size_type>(sp - this->SearchString);
+        ++pc;
+      } else if (inst.Op == Program::Bol) {
+        if (sp != this->SearchString) {
+          break;
+        }
+        ++pc;
+      } else if (inst.Op == Program::Eol) {
+        if (*sp != '\0') {
+          break;
+        }
+        ++pc;
+      } else {
+        std::copy(this->Captures.begin(), this->Captures.end(),
+                  list.Captures.begin() +
+                    static_cast<std::ptrdiff_t>(upc * ncap));
+        break;
+      }
+    }
+  }
+}
+
+bool cmRegularExpression::find(const char* str)
+{
+  std::fill(this->Offsets, this->Offsets + 2 * NSUBEXP, std::string::npos);
+  this->SearchString = str;
+  if (!this->Prog) {
+    return false;
+  }
+  Program const& prog = *this->Prog;
+  size_t const size = prog.Code.size();
+  size_t const ncap = static_cast<size_t>(prog.NumCaptures);
+  for (ThreadList& list : this->Lists) {
+    list.Sparse.resize(size);
+    list.Dense.clear();
+    list.Dense.reserve(size);
+    list.Captures.resize(size * ncap);
+  }
+  this->Captures.resize(ncap);
+
+  // Run all threads in lock step over the input.  Threads are kept in
+  // priority order, so the first one to match is the one a backtracking
+  // matcher would have found, and threads after it can be dropped.
+  ThreadList* clist = &this->Lists[0];
+  ThreadList* nlist = &this->Lists[1];
+  bool matched = false;
+  for (const char* sp = str;; ++sp) {
+    if (!matched && (sp == str || !prog.Anchored)) {
+      if (clist->Dense.empty() && prog.FirstChar >= 0) {
+        sp = strchr(sp, prog.FirstChar);
+        if (!sp) {
+          break;
+        }
+      }
+      std::fill(this->Captures.begin(), this->Captures.end(),
+                std::string::npos);
+      this->AddThread(*clist, 0, sp);
+    }
+    if (clist->Dense.empty()) {
+      break;
+    }
+
+    char const c = *sp;
+    nlist->Dense.clear();
+    for (int pc : clist->Dense) {
+      size_t const upc = static_cast<size_t>(pc);
+      Program::Inst const& inst = prog.Code[upc];
+      bool advance;
+      if (inst.Op == Program::Char) {
+        advance = c == static_cast<char>(inst.C);
+      } else if (inst.Op == Program::Any) {
+        advance = c != '\0';
+      } else if (inst.Op == Program::Class) {
+        advance = prog.Classes[static_cast<size_t>(inst.X)].test(
+          static_cast<unsigned char>(c));
+      } else if (inst.Op == Program::Match) {
+        std::copy(clist->Captures.begin() +
+                    static_cast<std::ptrdiff_t>(upc * ncap),
+                  clist->Captures.begin() +
+                    static_cast<std::ptrdiff_t>((upc + 1) * ncap),
+                  this->Offsets);
+        matched = true;
+        break;
+      } else {
+        continue;
+      }
+      if (advance) {
+        std::copy(clist->Captures.begin() +
+                    static_cast<std::ptrdiff_t>(upc * ncap),
+                  clist->Captures.begin() +
+                    static_cast<std::ptrdiff_t>((upc + 1) * ncap),
+                  this->Captures.begin());
+        this->AddThread(*nlist, pc + 1, sp + 1);
+      }
+    }
+    std::swap(clist, nlist);
+    if (c == '\0') {
+      break;
+    }
+  }
+  return matched;
+}
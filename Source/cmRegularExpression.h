@@ -0,0 +1,83 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmRegularExpression_h
+#define cmRegularExpression_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/** \class cmRegularExpression
+ * \brief Regular expressions of the CMake language
+ *
+ * cmRegularExpression accepts exactly the syntax of
+ * cmsys::RegularExpression and finds the same matches and subexpressions,
+ * but runs in time linear in the length of the input: it simulates all
+ * ways of matching the expression at once instead of backtracking.
+ *
+ * Compiled expressions are cached by pattern, so compiling a pattern
+ * again is cheap.  The cache is not synchronized; use this class from
+ * the thread that runs CMake code only.
+ */
+class cmRegularExpression
+{
+public:
+  enum
+  {
+    NSUBEXP = 10
+  };
+
+  cmRegularExpression();
+  ~cmRegularExpression();
+
+  /** Compile the given pattern.  Returns false if cmsys::RegularExpression
+      would reject it.  */
+  bool compile(std::string const& pattern);
+
+  /** Find the leftmost match in the given string.  The string must stay
+      alive as long as the match is used.  */
+  bool find(const char* str);
+  bool find(std::string const& str) { return this->find(str.c_str()); }
+
+  /** Get the offset of the start or end of the match, or of its nth
+      subexpression, in the string last given to find().  Subexpressions
+      that did not participate in the match give std::string::npos.  */
+  std::string::size_type start(int n = 0) const
+  {
+    return this->Offsets[2 * n];
+  }
+  std::string::size_type end(int n = 0) const
+  {
+    return this->Offsets[2 * n + 1];
+  }
+
+  /** Get the text of the nth subexpression of the match.  */
+  std::string match(int n) const;
+
+  struct Program;
+
+  /** Get the number of compiled patterns in the cache.  */
+  static size_t GetCacheSize();
+
+private:
+  std::shared_ptr<Program const> Prog;
+  const char* SearchString;
+  std::string::size_type Offsets[2 * NSUBEXP];
+
+  // Scratch space of find() kept between calls.
+  struct ThreadList
+  {
+    std::vector<int> Sparse;
+    std::vector<int> Dense;
+    std::vector<std::string::size_type> Captures;
+  };
+  ThreadList Lists[2];
+  std::vector<std::string::size_type> Captures;
+  std::vector<std::pair<int, std::string::size_type>> Stack;
+
+  void AddThread(ThreadList& list, int pc, const char* sp);
+};
+
+#endif
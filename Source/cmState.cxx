@@ -32,6 +32,7 @@ cmState::cmState()
   , FastbuildMake(false)
 {
   this->CacheManager = new cmCacheManager;
+  this->NewCommandGeneration();
 }
 
 cmState::~cmState()
@@ -384,6 +385,7 @@ void cmState::AddBuiltinCommand(std::string const& name, cmCommand* command)
   assert(name == cmSystemTools::LowerCase(name));
   assert(this->BuiltinCommands.find(name) == this->BuiltinCommands.end());
   this->BuiltinCommands.insert(std::make_pair(name, command));
+  this->NewCommandGeneration();
 }
 
 void cmState::AddDisallowedCommand(std::string const& name, cmCommand* command,
@@ -423,6 +425,7 @@ void cmState::AddScriptedCommand(std::string const& name, cmCommand* command)
     this->ScriptedCommands.erase(pos);
   }
   this->ScriptedCommands.insert(std::make_pair(sName, command));
+  this->NewCommandGeneration();
 }
 
 cmCommand* cmState::GetCommand(std::string const& name) const
@@ -461,6 +464,16 @@ void cmState::RemoveUserDefinedCommands()
 {
   cmDeleteAll(this->ScriptedCommands);
   this->ScriptedCommands.clear();
+  this->NewCommandGeneration();
+}
+
+void cmState::NewCommandGeneration()
+{
+  // Calls cache the commands they resolve to by generation, and a call
+  // may be executed by more than one state, so no two states may share
+  // a generation.
+  static unsigned long nextGeneration = 0;
+  this->CommandGeneration = ++nextGeneration;
 }
 
 void cmState::SetGlobalProperty(const std::string& prop, const char* value)
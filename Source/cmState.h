@@ -124,6 +124,12 @@ public:
   void SetIsGeneratorMultiConfig(bool b);
 
   cmCommand* GetCommand(std::string const& name) const;
+  /** Get a number that changes whenever a command is added or removed.
+      It is unique among all states in the process.  */
+  unsigned long GetCommandGeneration() const
+  {
+    return this->CommandGeneration;
+  }
   void AddBuiltinCommand(std::string const& name, cmCommand* command);
   void AddDisallowedCommand(std::string const& name, cmCommand* command,
                             cmPolicies::PolicyID policy, const char* message);
@@ -171,6 +177,8 @@ private:
   std::vector<std::string> EnabledLanguages;
   std::map<std::string, cmCommand*> BuiltinCommands;
   std::map<std::string, cmCommand*> ScriptedCommands;
+  unsigned long CommandGeneration;
+  void NewCommandGeneration();
   cmPropertyMap GlobalProperties;
   cmCacheManager* CacheManager;
 
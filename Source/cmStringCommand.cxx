@@ -2,7 +2,6 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmStringCommand.h"
 
-#include "cmsys/RegularExpression.hxx"
 #include <ctype.h>
 #include <memory> // IWYU pragma: keep
 #include <sstream>
@@ -13,6 +12,7 @@
 #include "cmCryptoHash.h"
 #include "cmGeneratorExpression.h"
 #include "cmMakefile.h"
+#include "cmRegularExpression.h"
 #include "cmSystemTools.h"
 #include "cmTimestamp.h"
 #include "cmUuid.h"
@@ -255,8 +255,8 @@ bool cmStringCommand::RegexMatch(std::vector<std::string> const& args)
 
   this->Makefile->ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  cmRegularExpression re;
+  if (!re.compile(regex)) {
     std::string e =
       "sub-command REGEX, mode MATCH failed to compile regex \"" + regex +
       "\".";
@@ -296,8 +296,8 @@ bool cmStringCommand::RegexMatchAll(std::vector<std::string> const& args)
 
   this->Makefile->ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  cmRegularExpression re;
+  if (!re.compile(regex)) {
     std::string e =
       "sub-command REGEX, mode MATCHALL failed to compile regex \"" + regex +
       "\".";
@@ -379,8 +379,8 @@ bool cmStringCommand::RegexReplace(std::vector<std::string> const& args)
 
   this->Makefile->ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  cmRegularExpression re;
+  if (!re.compile(regex)) {
     std::string e =
       "sub-command REGEX, mode REPLACE failed to compile regex \"" + regex +
       "\".";
@@ -11,13 +11,18 @@
 #include "cmArchiveWrite.h"
 #include "cmLocale.h"
 #include "cm_libarchive.h"
+#include "cm_zstd.h"
 #ifndef __LA_INT64_T
 #define __LA_INT64_T la_int64_t
 #endif
+#ifndef __LA_SSIZE_T
+#define __LA_SSIZE_T la_ssize_t
+#endif
 #endif
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 #include "cmCryptoHash.h"
+#include "cmWorkerPool.h"
 #endif
 
 #if defined(CMAKE_USE_ELF_PARSER)
@@ -39,6 +44,7 @@
 #include <ctype.h>
 #include <errno.h>
 #include <iostream>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <stdio.h>
@@ -74,6 +80,16 @@
 #include <malloc.h> /* for malloc/free on QNX */
 #endif
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
 static bool cm_isspace(char c)
 {
   return ((c & 0x80) == 0) && isspace(c);
@@ -120,6 +136,86 @@ static int cm_archive_read_open_file(struct archive* a, const char* file,
   return archive_read_open_filename(a, file, block_size);
 #endif
 }
+
+// Decompress a zstd file for libarchive, which does not know the format.
+class cm_archive_zstd_reader
+{
+public:
+  ~cm_archive_zstd_reader() { ZSTD_freeDCtx(this->Context); }
+
+  // Return a reader if the file starts with a zstd frame.
+  static std::unique_ptr<cm_archive_zstd_reader> Open(const char* file)
+  {
+    std::unique_ptr<cm_archive_zstd_reader> reader(
+      new cm_archive_zstd_reader);
+    reader->File.open(file, std::ios::in | std::ios::binary);
+    unsigned char magic[4] = { 0, 0, 0, 0 };
+    if (!reader->File.read(reinterpret_cast<char*>(magic), sizeof(magic)) ||
+        magic[0] != 0x28 || magic[1] != 0xB5 || magic[2] != 0x2F ||
+        magic[3] != 0xFD) {
+      reader.reset();
+      return reader;
+    }
+    reader->File.seekg(0);
+    return reader;
+  }
+
+  // archive_read_callback
+  static __LA_SSIZE_T Read(struct archive* a, void* cd, const void** buffer)
+  {
+    cm_archive_zstd_reader* self = static_cast<cm_archive_zstd_reader*>(cd);
+    ZSTD_outBuffer out = { &self->Out[0], self->Out.size(), 0 };
+    while (out.pos == 0) {
+      if (self->InBuffer.pos == self->InBuffer.size && !self->Eof) {
+        self->File.read(&self->In[0],
+                        static_cast<std::streamsize>(self->In.size()));
+        if (self->File.gcount() > 0) {
+          self->InBuffer.size = static_cast<size_t>(self->File.gcount());
+          self->InBuffer.pos = 0;
+        } else if (self->File.bad()) {
+          archive_set_error(a, -1, "Error reading zstd data");
+          return -1;
+        } else {
+          self->Eof = true;
+        }
+      }
+      size_t const r =
+        ZSTD_decompressStream(self->Context, &out, &self->InBuffer);
+      if (ZSTD_isError(r)) {
+        archive_set_error(a, -1, "%s", ZSTD_getErrorName(r));
+        return -1;
+      }
+      if (out.pos == 0 && self->Eof) {
+        if (r != 0) {
+          archive_set_error(a, -1, "Truncated zstd data");
+          return -1;
+        }
+        return 0;
+      }
+    }
+    *buffer = out.dst;
+    return static_cast<__LA_SSIZE_T>(out.pos);
+  }
+
+private:
+  cm_archive_zstd_reader()
+    : Context(ZSTD_createDCtx())
+    , In(ZSTD_DStreamInSize())
+    , Out(ZSTD_DStreamOutSize())
+    , Eof(false)
+  {
+    this->InBuffer.src = &this->In[0];
+    this->InBuffer.size = 0;
+    this->InBuffer.pos = 0;
+  }
+
+  cmsys::ifstream File;
+  ZSTD_DCtx* Context;
+  std::vector<char> In;
+  std::vector<char> Out;
+  ZSTD_inBuffer InBuffer;
+  bool Eof;
+};
 #endif
 
 #ifdef _WIN32
@@ -919,6 +1015,103 @@ bool cmSystemTools::CopyFileIfDifferent(const char* source,
   return Superclass::CopyFileIfDifferent(source, destination);
 }
 
+#if defined(__linux__)
+static bool cmSystemToolsCopyFileData(int in, int out, off_t size)
+{
+  // Files that report no size, like those in /proc, may still have
+  // content that only read() returns.
+  off_t copied = 0;
+  if (size > 0) {
+    if (ioctl(out, FICLONE, in) == 0) {
+      return true;
+    }
+#if defined(__NR_copy_file_range)
+    for (;;) {
+      ssize_t const n = syscall(__NR_copy_file_range, in, nullptr, out,
+                                nullptr, size_t(1) << 30, 0u);
+      if (n <= 0) {
+        if (n == 0 && copied >= size) {
+          return true;
+        }
+        break;
+      }
+      copied += n;
+    }
+#endif
+    // Continue where the above stopped.
+    for (;;) {
+      ssize_t const n = sendfile(out, in, nullptr, size_t(1) << 30);
+      if (n <= 0) {
+        if (n == 0 && copied >= size) {
+          return true;
+        }
+        break;
+      }
+      copied += n;
+    }
+  }
+  char buffer[65536];
+  for (;;) {
+    ssize_t const n = read(in, buffer, sizeof(buffer));
+    if (n == 0) {
+      return true;
+    }
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    for (ssize_t done = 0; done < n;) {
+      ssize_t const w = write(out, buffer + done, size_t(n - done));
+      if (w < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      done += w;
+    }
+  }
+}
+#endif
+
+bool cmSystemTools::CloneFile(std::string const& source,
+                              std::string const& destination)
+{
+#if defined(__linux__)
+  // Leave anything but copying a regular file to a file path to the
+  // generic implementation.
+  struct stat st;
+  if (stat(source.c_str(), &st) != 0 || !S_ISREG(st.st_mode) ||
+      cmSystemTools::FileIsDirectory(destination) ||
+      cmSystemTools::SameFile(source, destination)) {
+    return Superclass::CopyFileAlways(source, destination);
+  }
+  int const in = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+  if (in < 0) {
+    return false;
+  }
+  cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(destination));
+  // Remove the destination so that read-only files can be replaced.
+  unlink(destination.c_str());
+  int const out = open(destination.c_str(),
+                       O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (out < 0) {
+    close(in);
+    return false;
+  }
+  bool ok = cmSystemToolsCopyFileData(in, out, st.st_size);
+  ok = (close(out) == 0) && ok;
+  close(in);
+  return ok &&
+    cmSystemTools::SetPermissions(destination,
+                                  static_cast<mode_t>(st.st_mode & 07777));
+#else
+  return Superclass::CopyFileAlways(source, destination);
+#endif
+}
+
 #ifdef _WIN32
 cmSystemTools::WindowsFileRetry cmSystemTools::GetWindowsFileRetry()
 {
@@ -1045,6 +1238,32 @@ bool cmSystemTools::RenameFile(const char* oldname, const char* newname)
 #endif
 }
 
+bool cmSystemTools::WriteFileAtomically(std::string const& file,
+                                        std::string const& content)
+{
+  cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(file));
+  char suffix[32];
+  sprintf(suffix, ".tmp%08x", cmSystemTools::RandomSeed());
+  std::string const tmpFile = file + suffix;
+  {
+    cmsys::ofstream fout(tmpFile.c_str(), std::ios::out | std::ios::binary);
+    if (!fout) {
+      return false;
+    }
+    fout.write(content.data(), static_cast<std::streamsize>(content.size()));
+    fout.close();
+    if (!fout) {
+      cmSystemTools::RemoveFile(tmpFile);
+      return false;
+    }
+  }
+  if (!cmSystemTools::RenameFile(tmpFile.c_str(), file.c_str())) {
+    cmSystemTools::RemoveFile(tmpFile);
+    return false;
+  }
+  return true;
+}
+
 std::string cmSystemTools::ComputeFileHash(const std::string& source,
                                            cmCryptoHash::Algo algo)
 {
@@ -1059,6 +1278,31 @@ std::string cmSystemTools::ComputeFileHash(const std::string& source,
 #endif
 }
 
+std::vector<std::string> cmSystemTools::ComputeFileHashes(
+  std::vector<std::string> const& files, cmCryptoHash::Algo algo)
+{
+  std::vector<std::string> hashes(files.size());
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  unsigned int const threads = cmWorkerPool::GetHardwareThreads();
+  if (threads > 1 && files.size() > 1) {
+    // Each job writes only its own element of the result.
+    cmWorkerPool pool(threads, threads);
+    for (size_t i = 0; i < files.size(); ++i) {
+      pool.Post([&files, &hashes, algo, i]() {
+        cmCryptoHash hash(algo);
+        hashes[i] = hash.HashFile(files[i]);
+      });
+    }
+    pool.Wait();
+    return hashes;
+  }
+#endif
+  for (size_t i = 0; i < files.size(); ++i) {
+    hashes[i] = cmSystemTools::ComputeFileHash(files[i], algo);
+  }
+  return hashes;
+}
+
 std::string cmSystemTools::ComputeStringMD5(const std::string& input)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
@@ -1542,7 +1786,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
                               const std::vector<std::string>& files,
                               cmTarCompression compressType, bool verbose,
                               std::string const& mtime,
-                              std::string const& format)
+                              std::string const& format, int threads)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   std::string cwd = cmSystemTools::GetCurrentWorkingDirectory();
@@ -1566,12 +1810,16 @@ bool cmSystemTools::CreateTar(const char* outFileName,
     case TarCompressXZ:
       compress = cmArchiveWrite::CompressXZ;
       break;
+    case TarCompressZstd:
+      compress = cmArchiveWrite::CompressZstd;
+      break;
     case TarCompressNone:
       compress = cmArchiveWrite::CompressNone;
       break;
   }
 
-  cmArchiveWrite a(fout, compress, format.empty() ? "paxr" : format);
+  cmArchiveWrite a(fout, compress, format.empty() ? "paxr" : format,
+                   threads);
 
   a.SetMTime(mtime);
   a.SetVerbose(verbose);
@@ -1593,6 +1841,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
   (void)outFileName;
   (void)files;
   (void)verbose;
+  (void)threads;
   return false;
 #endif
 }
@@ -1740,7 +1989,12 @@ bool extract_tar(const char* outFileName, bool verbose, bool extract)
   archive_read_support_filter_all(a);
   archive_read_support_format_all(a);
   struct archive_entry* entry;
-  int r = cm_archive_read_open_file(a, outFileName, 10240);
+  std::unique_ptr<cm_archive_zstd_reader> zstd =
+    cm_archive_zstd_reader::Open(outFileName);
+  int r = zstd
+    ? archive_read_open(a, zstd.get(), nullptr, &cm_archive_zstd_reader::Read,
+                        nullptr)
+    : cm_archive_read_open_file(a, outFileName, 10240);
   if (r) {
     cmSystemTools::Error("Problem with archive_read_open_file(): ",
                          archive_error_string(a));
@@ -2393,6 +2647,157 @@ struct cmSystemToolsRPathInfo
   std::string Name;
   std::string Value;
 };
+
+// The changes to a file that remove its RPATH and RUNPATH entries.
+struct cmSystemToolsRemoveRPathEdit
+{
+  int ZeroCount = 0;
+  unsigned long ZeroPosition[2] = { 0, 0 };
+  unsigned long ZeroSize[2] = { 0, 0 };
+  unsigned long BytesBegin = 0;
+  std::vector<char> Bytes;
+};
+
+static bool cmSystemToolsPlanRemoveRPath(cmELF& elf,
+                                         cmSystemToolsRemoveRPathEdit& edit,
+                                         std::string* emsg)
+{
+  // Get the RPATH and RUNPATH entries from it and sort them by index
+  // in the dynamic section header.
+  int se_count = 0;
+  cmELF::StringEntry const* se[2] = { nullptr, nullptr };
+  if (cmELF::StringEntry const* se_rpath = elf.GetRPath()) {
+    se[se_count++] = se_rpath;
+  }
+  if (cmELF::StringEntry const* se_runpath = elf.GetRunPath()) {
+    se[se_count++] = se_runpath;
+  }
+  if (se_count == 0) {
+    // There is no RPATH or RUNPATH anyway.
+    return true;
+  }
+  if (se_count == 2 && se[1]->IndexInSection < se[0]->IndexInSection) {
+    std::swap(se[0], se[1]);
+  }
+
+  // Obtain a copy of the dynamic entries
+  cmELF::DynamicEntryList dentries = elf.GetDynamicEntries();
+  if (dentries.empty()) {
+    // This should happen only for invalid ELF files where a DT_NULL
+    // appears before the end of the table.
+    if (emsg) {
+      *emsg = "DYNAMIC section contains a DT_NULL before the end.";
+    }
+    return false;
+  }
+
+  // Save information about the string entries to be zeroed.
+  edit.ZeroCount = se_count;
+  for (int i = 0; i < se_count; ++i) {
+    edit.ZeroPosition[i] = se[i]->Position;
+    edit.ZeroSize[i] = se[i]->Size;
+  }
+
+  // Get size of one DYNAMIC entry
+  unsigned long const sizeof_dentry =
+    elf.GetDynamicEntryPosition(1) - elf.GetDynamicEntryPosition(0);
+
+  // Adjust the entry list as necessary to remove the run path
+  unsigned long entriesErased = 0;
+  for (cmELF::DynamicEntryList::iterator it = dentries.begin();
+       it != dentries.end();) {
+    if (it->first == cmELF::TagRPath || it->first == cmELF::TagRunPath) {
+      it = dentries.erase(it);
+      entriesErased++;
+      continue;
+    }
+    if (cmELF::TagMipsRldMapRel != 0 &&
+        it->first == cmELF::TagMipsRldMapRel) {
+      // Background: debuggers need to know the "linker map" which contains
+      // the addresses each dynamic object is loaded at. Most arches use
+      // the DT_DEBUG tag which the dynamic linker writes to (directly) and
+      // contain the location of the linker map, however on MIPS the
+      // .dynamic section is always read-only so this is not possible. MIPS
+      // objects instead contain a DT_MIPS_RLD_MAP tag which contains the
+      // address where the dyanmic linker will write to (an indirect
+      // version of DT_DEBUG). Since this doesn't work when using PIE, a
+      // relative equivalent was created - DT_MIPS_RLD_MAP_REL. Since this
+      // version contains a relative offset, moving it changes the
+      // calculated address. This may cause the dyanmic linker to write
+      // into memory it should not be changing.
+      //
+      // To fix this, we adjust the value of DT_MIPS_RLD_MAP_REL here. If
+      // we move it up by n bytes, we add n bytes to the value of this tag.
+      it->second += entriesErased * sizeof_dentry;
+    }
+
+    it++;
+  }
+
+  // Encode new entries list
+  edit.Bytes = elf.EncodeDynamicEntries(dentries);
+  edit.BytesBegin = elf.GetDynamicEntryPosition(0);
+  return true;
+}
+
+static bool cmSystemToolsApplyRemoveRPath(
+  std::string const& file, cmSystemToolsRemoveRPathEdit const& edit,
+  std::string* emsg, bool* removed)
+{
+  if (edit.ZeroCount == 0) {
+    // There is no RPATH or RUNPATH anyway.
+    return true;
+  }
+
+  // Open the file for update.
+  cmsys::ofstream f(file.c_str(),
+                    std::ios::in | std::ios::out | std::ios::binary);
+  if (!f) {
+    if (emsg) {
+      *emsg = "Error opening file for update.";
+    }
+    return false;
+  }
+
+  // Write the new DYNAMIC table header.
+  if (!f.seekp(edit.BytesBegin)) {
+    if (emsg) {
+      *emsg = "Error seeking to DYNAMIC table header for RPATH.";
+    }
+    return false;
+  }
+  if (!f.write(&edit.Bytes[0], edit.Bytes.size())) {
+    if (emsg) {
+      *emsg = "Error replacing DYNAMIC table header.";
+    }
+    return false;
+  }
+
+  // Fill the RPATH and RUNPATH strings with zero bytes.
+  for (int i = 0; i < edit.ZeroCount; ++i) {
+    if (!f.seekp(edit.ZeroPosition[i])) {
+      if (emsg) {
+        *emsg = "Error seeking to RPATH position.";
+      }
+      return false;
+    }
+    for (unsigned long j = 0; j < edit.ZeroSize[i]; ++j) {
+      f << '\0';
+    }
+    if (!f) {
+      if (emsg) {
+        *emsg = "Error writing the empty rpath string to the file.";
+      }
+      return false;
+    }
+  }
+
+  // Everything was updated successfully.
+  if (removed) {
+    *removed = true;
+  }
+  return true;
+}
 #endif
 
 #if defined(CMAKE_USE_ELF_PARSER)
@@ -2407,6 +2812,7 @@ bool cmSystemTools::ChangeRPath(std::string const& file,
   int rp_count = 0;
   bool remove_rpath = true;
   cmSystemToolsRPathInfo rp[2];
+  cmSystemToolsRemoveRPathEdit remove_edit;
   {
     // Parse the ELF binary.
     cmELF elf(file.c_str());
@@ -2507,6 +2913,13 @@ bool cmSystemTools::ChangeRPath(std::string const& file,
       // This entry is ready for update.
       ++rp_count;
     }
+
+    // If the resulting rpath is empty, just remove the entire entry
+    // instead.  Plan that from the file already parsed.
+    if (rp_count > 0 && remove_rpath &&
+        !cmSystemToolsPlanRemoveRPath(elf, remove_edit, emsg)) {
+      return false;
+    }
   }
 
   // If no runtime path needs to be changed, we are done.
@@ -2514,9 +2927,8 @@ bool cmSystemTools::ChangeRPath(std::string const& file,
     return true;
   }
 
-  // If the resulting rpath is empty, just remove the entire entry instead.
   if (remove_rpath) {
-    return cmSystemTools::RemoveRPath(file, emsg, changed);
+    return cmSystemToolsApplyRemoveRPath(file, remove_edit, emsg, changed);
   }
 
   {
@@ -2716,140 +3128,15 @@ bool cmSystemTools::RemoveRPath(std::string const& file, std::string* emsg,
   if (removed) {
     *removed = false;
   }
-  int zeroCount = 0;
-  unsigned long zeroPosition[2] = { 0, 0 };
-  unsigned long zeroSize[2] = { 0, 0 };
-  unsigned long bytesBegin = 0;
-  std::vector<char> bytes;
+  cmSystemToolsRemoveRPathEdit edit;
   {
     // Parse the ELF binary.
     cmELF elf(file.c_str());
-
-    // Get the RPATH and RUNPATH entries from it and sort them by index
-    // in the dynamic section header.
-    int se_count = 0;
-    cmELF::StringEntry const* se[2] = { nullptr, nullptr };
-    if (cmELF::StringEntry const* se_rpath = elf.GetRPath()) {
-      se[se_count++] = se_rpath;
-    }
-    if (cmELF::StringEntry const* se_runpath = elf.GetRunPath()) {
-      se[se_count++] = se_runpath;
-    }
-    if (se_count == 0) {
-      // There is no RPATH or RUNPATH anyway.
-      return true;
-    }
-    if (se_count == 2 && se[1]->IndexInSection < se[0]->IndexInSection) {
-      std::swap(se[0], se[1]);
-    }
-
-    // Obtain a copy of the dynamic entries
-    cmELF::DynamicEntryList dentries = elf.GetDynamicEntries();
-    if (dentries.empty()) {
-      // This should happen only for invalid ELF files where a DT_NULL
-      // appears before the end of the table.
-      if (emsg) {
-        *emsg = "DYNAMIC section contains a DT_NULL before the end.";
-      }
+    if (!cmSystemToolsPlanRemoveRPath(elf, edit, emsg)) {
       return false;
     }
-
-    // Save information about the string entries to be zeroed.
-    zeroCount = se_count;
-    for (int i = 0; i < se_count; ++i) {
-      zeroPosition[i] = se[i]->Position;
-      zeroSize[i] = se[i]->Size;
-    }
-
-    // Get size of one DYNAMIC entry
-    unsigned long const sizeof_dentry =
-      elf.GetDynamicEntryPosition(1) - elf.GetDynamicEntryPosition(0);
-
-    // Adjust the entry list as necessary to remove the run path
-    unsigned long entriesErased = 0;
-    for (cmELF::DynamicEntryList::iterator it = dentries.begin();
-         it != dentries.end();) {
-      if (it->first == cmELF::TagRPath || it->first == cmELF::TagRunPath) {
-        it = dentries.erase(it);
-        entriesErased++;
-        continue;
-      }
-      if (cmELF::TagMipsRldMapRel != 0 &&
-          it->first == cmELF::TagMipsRldMapRel) {
-        // Background: debuggers need to know the "linker map" which contains
-        // the addresses each dynamic object is loaded at. Most arches use
-        // the DT_DEBUG tag which the dynamic linker writes to (directly) and
-        // contain the location of the linker map, however on MIPS the
-        // .dynamic section is always read-only so this is not possible. MIPS
-        // objects instead contain a DT_MIPS_RLD_MAP tag which contains the
-        // address where the dyanmic linker will write to (an indirect
-        // version of DT_DEBUG). Since this doesn't work when using PIE, a
-        // relative equivalent was created - DT_MIPS_RLD_MAP_REL. Since this
-        // version contains a relative offset, moving it changes the
-        // calculated address. This may cause the dyanmic linker to write
-        // into memory it should not be changing.
-        //
-        // To fix this, we adjust the value of DT_MIPS_RLD_MAP_REL here. If
-        // we move it up by n bytes, we add n bytes to the value of this tag.
-        it->second += entriesErased * sizeof_dentry;
-      }
-
-      it++;
-    }
-
-    // Encode new entries list
-    bytes = elf.EncodeDynamicEntries(dentries);
-    bytesBegin = elf.GetDynamicEntryPosition(0);
   }
-
-  // Open the file for update.
-  cmsys::ofstream f(file.c_str(),
-                    std::ios::in | std::ios::out | std::ios::binary);
-  if (!f) {
-    if (emsg) {
-      *emsg = "Error opening file for update.";
-    }
-    return false;
-  }
-
-  // Write the new DYNAMIC table header.
-  if (!f.seekp(bytesBegin)) {
-    if (emsg) {
-      *emsg = "Error seeking to DYNAMIC table header for RPATH.";
-    }
-    return false;
-  }
-  if (!f.write(&bytes[0], bytes.size())) {
-    if (emsg) {
-      *emsg = "Error replacing DYNAMIC table header.";
-    }
-    return false;
-  }
-
-  // Fill the RPATH and RUNPATH strings with zero bytes.
-  for (int i = 0; i < zeroCount; ++i) {
-    if (!f.seekp(zeroPosition[i])) {
-      if (emsg) {
-        *emsg = "Error seeking to RPATH position.";
-      }
-      return false;
-    }
-    for (unsigned long j = 0; j < zeroSize[i]; ++j) {
-      f << '\0';
-    }
-    if (!f) {
-      if (emsg) {
-        *emsg = "Error writing the empty rpath string to the file.";
-      }
-      return false;
-    }
-  }
-
-  // Everything was updated successfully.
-  if (removed) {
-    *removed = true;
-  }
-  return true;
+  return cmSystemToolsApplyRemoveRPath(file, edit, emsg, removed);
 }
 #else
 bool cmSystemTools::RemoveRPath(std::string const& /*file*/,
@@ -177,14 +177,32 @@ public:
   static bool cmCopyFile(const char* source, const char* destination);
   static bool CopyFileIfDifferent(const char* source, const char* destination);
 
+  /** Copy a file like cmCopyFile, but let the operating system copy the
+      content where it can, by sharing the storage of the source (reflink)
+      or without passing the data through a user-space buffer.  */
+  static bool CloneFile(std::string const& source,
+                        std::string const& destination);
+
   /** Rename a file or directory within a single disk volume (atomic
       if possible).  */
   static bool RenameFile(const char* oldname, const char* newname);
 
+  /** Replace the content of a file by writing a temporary file next to
+      it and renaming it over the original, so that other processes
+      never see an incomplete file.  Missing parent directories are
+      created.  Returns false and leaves the file untouched on failure.  */
+  static bool WriteFileAtomically(std::string const& file,
+                                  std::string const& content);
+
   ///! Compute the hash of a file
   static std::string ComputeFileHash(const std::string& source,
                                      cmCryptoHash::Algo algo);
 
+  /** Compute the hashes of several files, concurrently where possible.
+      The hash of a file that cannot be read is empty.  */
+  static std::vector<std::string> ComputeFileHashes(
+    std::vector<std::string> const& files, cmCryptoHash::Algo algo);
+
   /** Compute the md5sum of a string.  */
   static std::string ComputeStringMD5(const std::string& input);
 
@@ -415,6 +433,7 @@ public:
     TarCompressGZip,
     TarCompressBZip2,
     TarCompressXZ,
+    TarCompressZstd,
     TarCompressNone
   };
   static bool ListTar(const char* outFileName, bool verbose);
@@ -422,7 +441,8 @@ public:
                         const std::vector<std::string>& files,
                         cmTarCompression compressType, bool verbose,
                         std::string const& mtime = std::string(),
-                        std::string const& format = std::string());
+                        std::string const& format = std::string(),
+                        int threads = -1);
   static bool ExtractTar(const char* inFileName, bool verbose);
   // This should be called first thing in main
   // it will keep child processes from inheriting the
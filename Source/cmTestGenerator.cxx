@@ -3,18 +3,29 @@
 #include "cmTestGenerator.h"
 
 #include <ostream>
+#include <set>
 #include <utility>
+#include <vector>
 
+#include "cmAlgorithms.h"
 #include "cmGeneratorExpression.h"
 #include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
 #include "cmLocalGenerator.h"
+#include "cmMakefile.h"
 #include "cmOutputConverter.h"
 #include "cmProperty.h"
 #include "cmPropertyMap.h"
+#include "cmSourceFile.h"
 #include "cmStateTypes.h"
 #include "cmSystemTools.h"
+#include "cmTargetDepend.h"
 #include "cmTest.h"
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#include "cm_jsoncpp_value.h"
+#endif
+
 cmTestGenerator::cmTestGenerator(
   cmTest* test, std::vector<std::string> const& configurations)
   : cmScriptGenerator("CTEST_CONFIGURATION_TYPE", configurations)
@@ -76,12 +87,55 @@ void cmTestGenerator::GenerateScriptForConfig(std::ostream& os,
   // Start the test command.
   os << indent << "add_test(" << this->Test->GetName() << " ";
 
+  // Generate the command line with full escapes.
+  std::vector<std::string> command;
+  this->ComputeCommand(config, command);
+  const char* sep = "";
+  for (std::string const& arg : command) {
+    os << sep << cmOutputConverter::EscapeForCMake(arg);
+    sep = " ";
+  }
+
+  // Finish the test command.
+  os << ")\n";
+
+  // Output properties for the test.
+  cmPropertyMap& pm = this->Test->GetProperties();
+  if (!pm.empty()) {
+    os << indent << "set_tests_properties(" << this->Test->GetName()
+       << " PROPERTIES ";
+    for (auto const& i : pm) {
+      os << " " << i.first << " "
+         << cmOutputConverter::EscapeForCMake(
+              ge.Parse(i.second.GetValue())->Evaluate(this->LG, config));
+    }
+    os << ")" << std::endl;
+  }
+
+  // Record the files the test executable is built from so that
+  // "ctest --changed-since" can select the test.
+  std::set<std::string> files;
+  this->ComputeChangeDepends(config, files);
+  if (!files.empty()) {
+    os << indent << "set_tests_properties(" << this->Test->GetName()
+       << " PROPERTIES CHANGE_DEPENDS "
+       << cmOutputConverter::EscapeForCMake(cmJoin(files, ";")) << ")"
+       << std::endl;
+  }
+}
+
+void cmTestGenerator::ComputeCommand(const std::string& config,
+                                     std::vector<std::string>& command)
+{
+  // Set up generator expression evaluation context.
+  cmGeneratorExpression ge(this->Test->GetBacktrace());
+
   // Get the test command line to be executed.
-  std::vector<std::string> const& command = this->Test->GetCommand();
+  std::vector<std::string> const& args = this->Test->GetCommand();
 
   // Check whether the command executable is a target whose name is to
   // be translated.
-  std::string exe = command[0];
+  std::string exe = args[0];
   cmGeneratorTarget* target = this->LG->FindGeneratorTargetToUse(exe);
   if (target && target->GetType() == cmStateEnums::EXECUTABLE) {
     // Use the target file on disk.
@@ -94,12 +148,9 @@ void cmTestGenerator::GenerateScriptForConfig(std::ostream& os,
       cmSystemTools::ExpandListArgument(emulator, emulatorWithArgs);
       std::string emulatorExe(emulatorWithArgs[0]);
       cmSystemTools::ConvertToUnixSlashes(emulatorExe);
-      os << cmOutputConverter::EscapeForCMake(emulatorExe) << " ";
-      for (std::vector<std::string>::const_iterator ei =
-             emulatorWithArgs.begin() + 1;
-           ei != emulatorWithArgs.end(); ++ei) {
-        os << cmOutputConverter::EscapeForCMake(*ei) << " ";
-      }
+      command.push_back(emulatorExe);
+      command.insert(command.end(), emulatorWithArgs.begin() + 1,
+                     emulatorWithArgs.end());
     }
   } else {
     // Use the command name given.
@@ -107,30 +158,126 @@ void cmTestGenerator::GenerateScriptForConfig(std::ostream& os,
     cmSystemTools::ConvertToUnixSlashes(exe);
   }
 
-  // Generate the command line with full escapes.
-  os << cmOutputConverter::EscapeForCMake(exe);
-  for (std::vector<std::string>::const_iterator ci = command.begin() + 1;
-       ci != command.end(); ++ci) {
-    os << " " << cmOutputConverter::EscapeForCMake(
-                   ge.Parse(*ci)->Evaluate(this->LG, config));
+  command.push_back(exe);
+  for (std::vector<std::string>::const_iterator ci = args.begin() + 1;
+       ci != args.end(); ++ci) {
+    command.push_back(ge.Parse(*ci)->Evaluate(this->LG, config));
   }
+}
 
-  // Finish the test command.
-  os << ")\n";
+void cmTestGenerator::ComputeChangeDepends(const std::string& config,
+                                           std::set<std::string>& files)
+{
+  if (!this->LG->GetMakefile()->IsOn("CMAKE_TEST_CHANGE_DEPENDS")) {
+    return;
+  }
+  cmGeneratorTarget* target =
+    this->LG->FindGeneratorTargetToUse(this->Test->GetCommand()[0]);
+  if (!target || target->GetType() != cmStateEnums::EXECUTABLE) {
+    return;
+  }
 
-  // Output properties for the test.
+  // Walk the target and everything it depends on in the build graph.
+  cmGlobalGenerator* gg = this->LG->GetGlobalGenerator();
+  std::set<cmGeneratorTarget const*> emitted;
+  std::vector<cmGeneratorTarget const*> queue(1, target);
+  while (!queue.empty()) {
+    cmGeneratorTarget const* gt = queue.back();
+    queue.pop_back();
+    if (!emitted.insert(gt).second) {
+      continue;
+    }
+    if (gt->GetType() == cmStateEnums::INTERFACE_LIBRARY) {
+      continue;
+    }
+    std::vector<cmSourceFile*> sources;
+    gt->GetSourceFiles(sources, config);
+    for (cmSourceFile* sf : sources) {
+      std::string path = sf->GetFullPath();
+      if (!path.empty()) {
+        cmSystemTools::ConvertToUnixSlashes(path);
+        files.insert(path);
+      }
+    }
+    for (cmTargetDepend const& dep : gg->GetTargetDirectDepends(gt)) {
+      queue.push_back(dep);
+    }
+  }
+}
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+bool cmTestGenerator::GenerateManifest(
+  Json::Value& tests, const std::string& config,
+  std::vector<std::string> const& configurationTypes)
+{
+  // Tests that depend on the configuration requested at test time
+  // are only available through the script.
+  if (!this->Configurations.empty() ||
+      (this->ActionsPerConfig && !configurationTypes.empty())) {
+    return false;
+  }
+
+  // The test name is written to the script without quoting.
+  std::string const& name = this->Test->GetName();
+  if (name.find_first_of(" \t\n\"#$();\\") != std::string::npos) {
+    return false;
+  }
+
+  // Old-style arguments are re-parsed from double quotes by the
+  // script, so only plain arguments have a literal value.
+  if (!this->ActionsPerConfig) {
+    for (std::string const& arg : this->Test->GetCommand()) {
+      if (arg.find_first_of("\\$") != std::string::npos) {
+        return false;
+      }
+    }
+  }
+
+  Json::Value& test = tests.append(Json::objectValue);
+  test["name"] = name;
+  Json::Value& command = test["command"] = Json::arrayValue;
+  Json::Value& properties = test["properties"] = Json::arrayValue;
   cmPropertyMap& pm = this->Test->GetProperties();
-  if (!pm.empty()) {
-    os << indent << "set_tests_properties(" << this->Test->GetName()
-       << " PROPERTIES ";
+
+  if (this->ActionsPerConfig) {
+    cmGeneratorExpression ge(this->Test->GetBacktrace());
+
+    std::vector<std::string> args;
+    this->ComputeCommand(config, args);
+    for (std::string const& arg : args) {
+      command.append(arg);
+    }
     for (auto const& i : pm) {
-      os << " " << i.first << " "
-         << cmOutputConverter::EscapeForCMake(
-              ge.Parse(i.second.GetValue())->Evaluate(this->LG, config));
+      Json::Value& property = properties.append(Json::arrayValue);
+      property.append(i.first);
+      property.append(
+        ge.Parse(i.second.GetValue())->Evaluate(this->LG, config));
+    }
+    std::set<std::string> files;
+    this->ComputeChangeDepends(config, files);
+    if (!files.empty()) {
+      Json::Value& property = properties.append(Json::arrayValue);
+      property.append("CHANGE_DEPENDS");
+      property.append(cmJoin(files, ";"));
+    }
+  } else {
+    std::vector<std::string> const& args = this->Test->GetCommand();
+    std::string exe = args[0];
+    cmSystemTools::ConvertToUnixSlashes(exe);
+    command.append(exe);
+    for (std::vector<std::string>::const_iterator argit = args.begin() + 1;
+         argit != args.end(); ++argit) {
+      command.append(*argit);
+    }
+    for (auto const& i : pm) {
+      Json::Value& property = properties.append(Json::arrayValue);
+      property.append(i.first);
+      property.append(i.second.GetValue());
     }
-    os << ")" << std::endl;
   }
+  return true;
 }
+#endif
 
 void cmTestGenerator::GenerateScriptNoConfig(std::ostream& os, Indent indent)
 {
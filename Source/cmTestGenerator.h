@@ -8,12 +8,17 @@
 #include "cmScriptGenerator.h"
 
 #include <iosfwd>
+#include <set>
 #include <string>
 #include <vector>
 
 class cmLocalGenerator;
 class cmTest;
 
+namespace Json {
+class Value;
+}
+
 /** \class cmTestGenerator
  * \brief Support class for generating install scripts.
  *
@@ -35,6 +40,14 @@ public:
 
   cmTest* GetTest() const;
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  /** Append the test to a manifest that ctest can load without executing
+      the test script.  Returns false if the test can only be described
+      by the script.  */
+  bool GenerateManifest(Json::Value& tests, const std::string& config,
+                        std::vector<std::string> const& configurationTypes);
+#endif
+
 protected:
   void GenerateScriptConfigs(std::ostream& os, Indent indent) override;
   void GenerateScriptActions(std::ostream& os, Indent indent) override;
@@ -44,6 +57,15 @@ protected:
   bool NeedsScriptNoConfig() const override;
   void GenerateOldStyle(std::ostream& os, Indent indent);
 
+  /** Compute the command line of the test for the given configuration.  */
+  void ComputeCommand(const std::string& config,
+                      std::vector<std::string>& command);
+
+  /** Collect the source files of a test executable and of all targets
+      it depends on, if CMAKE_TEST_CHANGE_DEPENDS is enabled.  */
+  void ComputeChangeDepends(const std::string& config,
+                            std::set<std::string>& files);
+
   cmLocalGenerator* LG;
   cmTest* Test;
   bool TestGenerated;
@@ -0,0 +1,224 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmTryCompileBatchCommand.h"
+
+#include "cmsys/FStream.hxx"
+#include <memory> // IWYU pragma: keep
+#include <stddef.h>
+#include <thread>
+#include <utility>
+
+#include "cmGlobalGenerator.h"
+#include "cmMakefile.h"
+#include "cmStateTypes.h"
+#include "cmSystemTools.h"
+#include "cmVersion.h"
+#include "cmake.h"
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+#include "cmUVProcessPool.h"
+#endif
+
+class cmExecutionStatus;
+
+// cmTryCompileBatchCommand
+bool cmTryCompileBatchCommand::InitialPass(std::vector<std::string> const& args,
+                                           cmExecutionStatus&)
+{
+  if (args.size() != 1 || (args[0] != "BEGIN" && args[0] != "END")) {
+    this->SetError("must be called with exactly one of BEGIN or END.");
+    return false;
+  }
+
+  if (this->Makefile->GetCMakeInstance()->GetWorkingMode() ==
+      cmake::FIND_PACKAGE_MODE) {
+    this->Makefile->IssueMessage(
+      cmake::FATAL_ERROR,
+      "The TRY_COMPILE_BATCH() command is not supported in "
+      "--find-package mode.");
+    return false;
+  }
+
+  bool const debug = this->Makefile->GetCMakeInstance()->GetDebugTryCompile();
+
+  if (args[0] == "BEGIN") {
+    if (this->Makefile->GetTryCompileBatch()) {
+      this->SetError("given BEGIN while a batch is already open.");
+      return false;
+    }
+    std::unique_ptr<cmTryCompileBatch> batch(new cmTryCompileBatch);
+    batch->Directory = this->Makefile->GetCurrentBinaryDirectory();
+    batch->Directory += cmake::GetCMakeFilesDirectory();
+    batch->Directory += "/CMakeTmpBatch";
+    if (!debug) {
+      this->CleanupFiles(batch->Directory);
+    }
+    cmSystemTools::MakeDirectory(batch->Directory);
+    this->Makefile->SetTryCompileBatch(std::move(batch));
+    this->Makefile->AddDefinition("CMAKE_TRY_COMPILE_BATCH", "1");
+    return true;
+  }
+
+  std::unique_ptr<cmTryCompileBatch> batch =
+    this->Makefile->ReleaseTryCompileBatch();
+  if (!batch) {
+    this->SetError("given END without a matching BEGIN.");
+    return false;
+  }
+  this->Makefile->RemoveDefinition("CMAKE_TRY_COMPILE_BATCH");
+
+  if (!batch->Entries.empty()) {
+    this->RunBatch(*batch);
+  }
+  if (!debug) {
+    this->CleanupFiles(batch->Directory);
+  }
+  return true;
+}
+
+void cmTryCompileBatchCommand::RunBatch(cmTryCompileBatch& batch)
+{
+  size_t const count = batch.Entries.size();
+  std::vector<int> results(count, 1);
+  std::vector<std::string> outputs(count);
+  std::vector<bool> configured(count, true);
+
+  // Entries forwarding the same variables from this project as the
+  // first one can share its cache.  The rest, or all of them if the
+  // shared project does not configure, are built one at a time.
+  std::vector<cmTryCompileBatch::Entry const*> shared;
+  std::vector<cmTryCompileBatch::Entry const*> separate;
+  for (cmTryCompileBatch::Entry const& entry : batch.Entries) {
+    if (entry.ForwardedFlags == batch.Entries.front().ForwardedFlags) {
+      shared.push_back(&entry);
+    } else {
+      separate.push_back(&entry);
+    }
+  }
+  if (!this->BuildBatch(batch, shared, results, outputs)) {
+    separate.insert(separate.begin(), shared.begin(), shared.end());
+  }
+
+  for (cmTryCompileBatch::Entry const* entry : separate) {
+    size_t const i = static_cast<size_t>(entry - batch.Entries.data());
+    bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+    cmSystemTools::ResetErrorOccuredFlag();
+    outputs[i].clear();
+    results[i] = this->Makefile->TryCompile(
+      entry->BinaryDirectory, entry->BinaryDirectory, "CMAKE_TRY_COMPILE",
+      entry->TargetName, true, &entry->CMakeFlags, outputs[i]);
+    configured[i] = !cmSystemTools::GetErrorOccuredFlag();
+    if (erroroc) {
+      cmSystemTools::SetErrorOccured();
+    }
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    cmTryCompileBatch::Entry const& entry = batch.Entries[i];
+    this->Makefile->AddCacheDefinition(
+      entry.ResultVariable, (results[i] == 0 ? "TRUE" : "FALSE"),
+      "Result of TRY_COMPILE", cmStateEnums::INTERNAL);
+    if (!entry.OutputVariable.empty()) {
+      this->Makefile->AddDefinition(entry.OutputVariable,
+                                    outputs[i].c_str());
+    }
+    if (!entry.ResultCacheFile.empty() && configured[i]) {
+      this->StoreCachedResult(entry.ResultCacheFile, results[i], outputs[i]);
+    }
+  }
+}
+
+bool cmTryCompileBatchCommand::BuildBatch(
+  cmTryCompileBatch& batch,
+  std::vector<cmTryCompileBatch::Entry const*> const& entries,
+  std::vector<int>& results, std::vector<std::string>& outputs)
+{
+  if (entries.empty()) {
+    return true;
+  }
+
+  // Each entry is already a complete project, so the batch project only
+  // needs to add them as subdirectories.
+  {
+    std::string const listFile = batch.Directory + "/CMakeLists.txt";
+    cmsys::ofstream fout(listFile.c_str());
+    if (!fout) {
+      return false;
+    }
+    fout << "cmake_minimum_required(VERSION " << cmVersion::GetMajorVersion()
+         << "." << cmVersion::GetMinorVersion() << "."
+         << cmVersion::GetPatchVersion() << "."
+         << cmVersion::GetTweakVersion() << ")\n";
+    fout << "project(CMAKE_TRY_COMPILE_BATCH NONE)\n";
+    fout << "set(CMAKE_SUPPRESS_REGENERATION 1)\n";
+    for (cmTryCompileBatch::Entry const* entry : entries) {
+      fout << "add_subdirectory(" << entry->TargetName << ")\n";
+    }
+  }
+
+  std::string const bindir = batch.Directory + "/build";
+  std::vector<std::string> cmakeFlags(1, "CMAKE_FLAGS"); // fake argv[0]
+  cmakeFlags.insert(cmakeFlags.end(), entries.front()->ForwardedFlags.begin(),
+                    entries.front()->ForwardedFlags.end());
+
+  bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+  cmSystemTools::ResetErrorOccuredFlag();
+  this->Makefile->SetIsSourceFileTryCompile(true);
+  if (this->Makefile->ConfigureTryCompile(batch.Directory, bindir,
+                                          &cmakeFlags) != 0) {
+    this->Makefile->SetIsSourceFileTryCompile(false);
+    if (erroroc) {
+      cmSystemTools::SetErrorOccured();
+    }
+    return false;
+  }
+
+  cmGlobalGenerator* gg = this->Makefile->GetGlobalGenerator();
+  std::string const config =
+    this->Makefile->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if (gg->SupportsConcurrentTargetBuilds() && entries.size() > 1) {
+    size_t const jobs = std::thread::hardware_concurrency();
+    cmUVProcessPool pool(jobs, jobs);
+    pool.Run(entries.size(),
+             [&](size_t i, cmUVProcessPool::Process& process) {
+               gg->GenerateBuildCommand(process.Arguments, "",
+                                        "CMAKE_TRY_COMPILE_BATCH", bindir,
+                                        entries[i]->TargetName, config, true,
+                                        false);
+               process.WorkingDirectory = bindir;
+             },
+             [&](size_t i, cmUVProcessPool::Process const& process) {
+               size_t const n =
+                 static_cast<size_t>(entries[i] - batch.Entries.data());
+               std::string& output = outputs[n];
+               output = "Change Dir: " + bindir + "\n";
+               output += "\nRun Build Command:";
+               output += cmSystemTools::PrintSingleCommand(process.Arguments);
+               output += "\n";
+               output += process.Output;
+               output += process.Errors;
+               bool const ok = process.Started && process.Signal == 0 &&
+                 process.ExitValue == 0;
+               // Match cmGlobalGenerator::Build for compilers that do not
+               // fail on #error.
+               results[n] =
+                 (ok && output.find("#error") == std::string::npos) ? 0 : 1;
+             });
+  } else
+#endif
+  {
+    for (cmTryCompileBatch::Entry const* entry : entries) {
+      size_t const n = static_cast<size_t>(entry - batch.Entries.data());
+      results[n] =
+        gg->TryCompile(batch.Directory, bindir, "CMAKE_TRY_COMPILE_BATCH",
+                       entry->TargetName, true, outputs[n], this->Makefile);
+    }
+  }
+
+  this->Makefile->SetIsSourceFileTryCompile(false);
+  if (erroroc) {
+    cmSystemTools::SetErrorOccured();
+  }
+  return true;
+}
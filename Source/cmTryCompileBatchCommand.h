@@ -0,0 +1,49 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmTryCompileBatchCommand_h
+#define cmTryCompileBatchCommand_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <vector>
+
+#include "cmCoreTryCompile.h"
+
+class cmCommand;
+class cmExecutionStatus;
+
+/** \class cmTryCompileBatchCommand
+ * \brief Defer try_compile calls and build them together
+ *
+ * try_compile_batch(BEGIN) makes later source file try_compile calls in
+ * the same directory record their test project.  try_compile_batch(END)
+ * configures all recorded projects at once, builds them concurrently
+ * when the generator allows it, and sets their results.
+ */
+class cmTryCompileBatchCommand : public cmCoreTryCompile
+{
+public:
+  /**
+   * This is a virtual constructor for the command.
+   */
+  cmCommand* Clone() override { return new cmTryCompileBatchCommand; }
+
+  /**
+   * This is called when the command is first encountered in
+   * the CMakeLists.txt file.
+   */
+  bool InitialPass(std::vector<std::string> const& args,
+                   cmExecutionStatus& status) override;
+
+  bool WritesFiles() const override { return true; }
+
+private:
+  void RunBatch(cmTryCompileBatch& batch);
+  bool BuildBatch(cmTryCompileBatch& batch,
+                  std::vector<cmTryCompileBatch::Entry const*> const& entries,
+                  std::vector<int>& results,
+                  std::vector<std::string>& outputs);
+};
+
+#endif
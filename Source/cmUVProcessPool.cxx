@@ -0,0 +1,202 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmUVProcessPool.h"
+
+#include "cmProcessOutput.h"
+#include "cmUVHandlePtr.h"
+#include "cmUVSignalHackRAII.h" // IWYU pragma: keep
+
+#include <algorithm>
+#include <signal.h>
+#include <utility>
+
+struct cmUVProcessPool::Job
+{
+  cmUVProcessPool* Pool;
+  size_t Index;
+  Process Proc;
+  std::vector<const char*> Argv;
+  std::string RawOutput;
+  std::string RawErrors;
+  std::vector<char> Buffer;
+  cm::uv_process_ptr Handle;
+  cm::uv_pipe_ptr OutPipe;
+  cm::uv_pipe_ptr ErrPipe;
+  bool Exited = false;
+
+  static void OnAllocate(uv_handle_t* handle, size_t /*suggested*/,
+                         uv_buf_t* buf)
+  {
+    Job* job = static_cast<Job*>(handle->data);
+    if (job->Buffer.empty()) {
+      job->Buffer.resize(65536);
+    }
+    *buf = uv_buf_init(job->Buffer.data(),
+                       static_cast<unsigned int>(job->Buffer.size()));
+  }
+
+  static void OnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf)
+  {
+    Job* job = static_cast<Job*>(stream->data);
+    bool const isOut =
+      stream == reinterpret_cast<uv_stream_t*>(job->OutPipe.get());
+    if (nread > 0) {
+      (isOut ? job->RawOutput : job->RawErrors)
+        .append(buf->base, static_cast<size_t>(nread));
+      return;
+    }
+    if (nread == 0) {
+      return;
+    }
+    // The process will provide no more data on this pipe.
+    if (isOut) {
+      job->OutPipe.reset();
+    } else {
+      job->ErrPipe.reset();
+    }
+    job->TryFinish();
+  }
+
+  static void OnExit(uv_process_t* process, int64_t exitStatus,
+                     int termSignal)
+  {
+    Job* job = static_cast<Job*>(process->data);
+    job->Proc.ExitValue = static_cast<int>(exitStatus);
+    job->Proc.Signal = termSignal;
+    job->Exited = true;
+    job->TryFinish();
+  }
+
+  void TryFinish()
+  {
+    // Output may still arrive after the process exits.
+    if (this->Exited && !this->OutPipe.get() && !this->ErrPipe.get()) {
+      this->Handle.reset();
+      this->Pool->JobFinished(this);
+    }
+  }
+};
+
+cmUVProcessPool::cmUVProcessPool(size_t jobs, size_t window)
+  : Jobs(std::max<size_t>(jobs, 1))
+  , Window(std::max(window, this->Jobs))
+{
+}
+
+cmUVProcessPool::~cmUVProcessPool()
+{
+}
+
+void cmUVProcessPool::Run(size_t count, SetupFunction setup,
+                          FinishFunction finish)
+{
+  this->Count = count;
+  this->NextStart = 0;
+  this->NextReport = 0;
+  this->Setup = std::move(setup);
+  this->Finish = std::move(finish);
+
+#ifdef CMAKE_UV_SIGNAL_HACK
+  cmUVSignalHackRAII hackRAII;
+#endif
+
+  uv_loop_init(&this->Loop);
+  this->Pump();
+  uv_run(&this->Loop, UV_RUN_DEFAULT);
+  uv_loop_close(&this->Loop);
+}
+
+void cmUVProcessPool::Pump()
+{
+  for (;;) {
+    // Report finished commands in order.
+    auto it = this->Finished.find(this->NextReport);
+    while (it != this->Finished.end()) {
+      this->Finish(it->first, it->second->Proc);
+      this->Finished.erase(it);
+      it = this->Finished.find(++this->NextReport);
+    }
+
+    if (this->Running.size() >= this->Jobs ||
+        this->NextStart >= this->Count ||
+        this->NextStart >= this->NextReport + this->Window) {
+      break;
+    }
+    this->StartJob(this->NextStart++);
+  }
+}
+
+void cmUVProcessPool::StartJob(size_t index)
+{
+  std::unique_ptr<Job> job(new Job);
+  job->Pool = this;
+  job->Index = index;
+  this->Setup(index, job->Proc);
+  for (std::string const& arg : job->Proc.Arguments) {
+    job->Argv.push_back(arg.c_str());
+  }
+  job->Argv.push_back(nullptr);
+
+  job->OutPipe.init(this->Loop, 0, job.get());
+  job->ErrPipe.init(this->Loop, 0, job.get());
+
+  uv_stdio_container_t stdio[3];
+  stdio[0].flags = UV_IGNORE;
+  stdio[0].data.stream = nullptr;
+  stdio[1].flags =
+    static_cast<uv_stdio_flags>(UV_CREATE_PIPE | UV_WRITABLE_PIPE);
+  stdio[1].data.stream = job->OutPipe;
+  stdio[2].flags =
+    static_cast<uv_stdio_flags>(UV_CREATE_PIPE | UV_WRITABLE_PIPE);
+  stdio[2].data.stream = job->ErrPipe;
+
+  uv_process_options_t options = uv_process_options_t();
+  options.file = job->Argv[0];
+  options.args = const_cast<char**>(job->Argv.data());
+  if (!job->Proc.WorkingDirectory.empty()) {
+    options.cwd = job->Proc.WorkingDirectory.c_str();
+  }
+  options.flags = UV_PROCESS_WINDOWS_HIDE;
+  options.stdio_count = 3;
+  options.stdio = stdio;
+  options.exit_cb = &Job::OnExit;
+
+  int status = job->Argv[0] ? job->Handle.spawn(this->Loop, options, job.get())
+                            : UV_EINVAL;
+  if (status == 0) {
+    status = uv_read_start(job->OutPipe, &Job::OnAllocate, &Job::OnRead);
+  }
+  if (status == 0) {
+    status = uv_read_start(job->ErrPipe, &Job::OnAllocate, &Job::OnRead);
+  }
+  if (status != 0) {
+    if (job->Handle.get()) {
+      uv_process_kill(job->Handle, SIGKILL);
+    }
+    job->Handle.reset();
+    job->OutPipe.reset();
+    job->ErrPipe.reset();
+    job->Proc.Errors = uv_strerror(status);
+    this->Finished[index] = std::move(job);
+    return;
+  }
+  job->Proc.Started = true;
+  this->Running[job.get()] = std::move(job);
+}
+
+void cmUVProcessPool::JobFinished(Job* job)
+{
+  auto it = this->Running.find(job);
+  std::unique_ptr<Job> finished = std::move(it->second);
+  this->Running.erase(it);
+
+  cmProcessOutput conv;
+  conv.DecodeText(finished->RawOutput, finished->Proc.Output);
+  conv.DecodeText(finished->RawErrors, finished->Proc.Errors);
+  finished->RawOutput.clear();
+  finished->RawErrors.clear();
+
+  size_t const index = finished->Index;
+  this->Finished[index] = std::move(finished);
+  this->Pump();
+}
@@ -0,0 +1,75 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmUVProcessPool_h
+#define cmUVProcessPool_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include "cm_uv.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/** \class cmUVProcessPool
+ * \brief Run a sequence of commands concurrently on a libuv loop
+ *
+ * At most Jobs commands run at once.  Finished commands are reported in
+ * the order they were requested, and a command is not started before all
+ * commands more than Window positions ahead of it have been reported.
+ * Callers can therefore give each of Window slots its own resources,
+ * such as an output directory, and reuse them safely.
+ */
+class cmUVProcessPool
+{
+public:
+  /** A command run by the pool and its outcome.  */
+  struct Process
+  {
+    std::vector<std::string> Arguments;
+    std::string WorkingDirectory;
+
+    bool Started = false;
+    std::string Output;
+    std::string Errors;
+    int ExitValue = 0;
+    int Signal = 0;
+  };
+
+  typedef std::function<void(size_t, Process&)> SetupFunction;
+  typedef std::function<void(size_t, Process const&)> FinishFunction;
+
+  cmUVProcessPool(size_t jobs, size_t window);
+  ~cmUVProcessPool();
+
+  cmUVProcessPool(cmUVProcessPool const&) = delete;
+  cmUVProcessPool& operator=(cmUVProcessPool const&) = delete;
+
+  /** Run commands 0 through count-1.  The setup function fills in the
+      command line of each command before it starts, and the finish
+      function receives its outcome.  Returns when all have finished.  */
+  void Run(size_t count, SetupFunction setup, FinishFunction finish);
+
+private:
+  struct Job;
+
+  void Pump();
+  void StartJob(size_t index);
+  void JobFinished(Job* job);
+
+  size_t const Jobs;
+  size_t const Window;
+  size_t Count = 0;
+  size_t NextStart = 0;
+  size_t NextReport = 0;
+  SetupFunction Setup;
+  FinishFunction Finish;
+  uv_loop_t Loop;
+  std::map<Job*, std::unique_ptr<Job>> Running;
+  std::map<size_t, std::unique_ptr<Job>> Finished;
+};
+
+#endif
@@ -19,6 +19,8 @@ public:
   bool InitialPass(std::vector<std::string> const& args,
                    cmExecutionStatus& status) override;
 
+  bool WritesFiles() const override { return true; }
+
 protected:
   void CopyAndFullPathMesaHeader(const char* source, const char* outdir);
 };
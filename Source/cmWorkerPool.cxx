@@ -0,0 +1,94 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmWorkerPool.h"
+
+#include <utility>
+
+#include "cmSystemTools.h"
+
+cmWorkerPool::cmWorkerPool(unsigned int threads, size_t queueLimit)
+  : QueueLimit(queueLimit > 0 ? queueLimit : 1)
+  , Running(0)
+  , Stopping(false)
+{
+  if (threads < 1) {
+    threads = 1;
+  }
+  this->Threads.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i) {
+    this->Threads.emplace_back(&cmWorkerPool::Work, this);
+  }
+}
+
+cmWorkerPool::~cmWorkerPool()
+{
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    this->Stopping = true;
+  }
+  this->JobPosted.notify_all();
+  for (std::thread& t : this->Threads) {
+    t.join();
+  }
+}
+
+void cmWorkerPool::Post(Job job)
+{
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    while (this->Queue.size() >= this->QueueLimit) {
+      this->JobTaken.wait(lock);
+    }
+    this->Queue.push_back(std::move(job));
+  }
+  this->JobPosted.notify_one();
+}
+
+void cmWorkerPool::Wait()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  while (!this->Queue.empty() || this->Running > 0) {
+    this->JobsDone.wait(lock);
+  }
+}
+
+unsigned int cmWorkerPool::GetHardwareThreads()
+{
+  // Tests set the number of threads to cover the concurrent code paths
+  // on any machine.
+  std::string override;
+  unsigned long count = 0;
+  if (cmSystemTools::GetEnv("CMAKE_WORKER_THREADS", override) &&
+      cmSystemTools::StringToULong(override.c_str(), &count) && count > 0) {
+    return static_cast<unsigned int>(count);
+  }
+  unsigned int const threads = std::thread::hardware_concurrency();
+  return threads > 0 ? threads : 1;
+}
+
+void cmWorkerPool::Work()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  for (;;) {
+    // Finish the queued jobs even when stopping.
+    while (this->Queue.empty() && !this->Stopping) {
+      this->JobPosted.wait(lock);
+    }
+    if (this->Queue.empty()) {
+      return;
+    }
+    Job job = std::move(this->Queue.front());
+    this->Queue.pop_front();
+    ++this->Running;
+    lock.unlock();
+    this->JobTaken.notify_one();
+
+    job();
+
+    lock.lock();
+    --this->Running;
+    if (this->Queue.empty() && this->Running == 0) {
+      this->JobsDone.notify_all();
+    }
+  }
+}
@@ -0,0 +1,60 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmWorkerPool_h
+#define cmWorkerPool_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stddef.h>
+#include <thread>
+#include <vector>
+
+/** \class cmWorkerPool
+ * \brief Run jobs on a fixed set of threads
+ *
+ * Jobs run in no particular order and must not throw.  They must not
+ * use objects that are not thread-safe, such as a cmMakefile; callers
+ * collect results in the jobs and act on them after Wait() returns.
+ * Post() blocks while QueueLimit jobs wait for a thread, so callers
+ * producing many jobs use bounded memory.
+ */
+class cmWorkerPool
+{
+public:
+  typedef std::function<void()> Job;
+
+  cmWorkerPool(unsigned int threads, size_t queueLimit);
+  ~cmWorkerPool();
+
+  cmWorkerPool(cmWorkerPool const&) = delete;
+  cmWorkerPool& operator=(cmWorkerPool const&) = delete;
+
+  /** Queue a job to run on one of the threads.  */
+  void Post(Job job);
+
+  /** Wait until all jobs posted so far have finished.  */
+  void Wait();
+
+  /** Get the number of threads the hardware runs at once, at least 1.
+      The CMAKE_WORKER_THREADS environment variable overrides it.  */
+  static unsigned int GetHardwareThreads();
+
+private:
+  void Work();
+
+  std::mutex Mutex;
+  std::condition_variable JobPosted;
+  std::condition_variable JobTaken;
+  std::condition_variable JobsDone;
+  std::deque<Job> Queue;
+  size_t QueueLimit;
+  size_t Running;
+  bool Stopping;
+  std::vector<std::thread> Threads;
+};
+
+#endif
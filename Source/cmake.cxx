@@ -496,6 +496,9 @@ void cmake::ReadListFile(const std::vector<std::string>& args,
     if (!mf.ReadListFile(path)) {
       cmSystemTools::Error("Error processing file: ", path);
     }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    gg->GetGlobCache().Save();
+#endif
     this->SetHomeDirectory(homeDir);
     this->SetHomeOutputDirectory(homeOutputDir);
   }
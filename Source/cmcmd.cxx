@@ -72,6 +72,10 @@ void CMakeCommandUsage(const char* program)
   errorStream
     << "Usage: " << program << " -E <command> [arguments...]\n"
     << "Available commands: \n"
+    << "  batch <file>|-            - run the file operations listed in a "
+       "file or on stdin\n"
+    << "  batch -- cmd [args...] [-- cmd [args...]]...\n"
+    << "                            - run several file operations\n"
     << "  capabilities              - Report capabilities built into cmake "
        "in JSON format\n"
     << "  chdir dir cmd [args...]   - run command in a given directory\n"
@@ -698,6 +702,11 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       return 0;
     }
 
+    // Run several file operations in one process
+    if (args[1] == "batch" && (args.size() == 3 || args[2] == "--")) {
+      return cmcmd::ExecuteBatch(args);
+    }
+
     // capabilities
     if (args[1] == "capabilities") {
       if (args.size() > 2) {
@@ -1021,6 +1030,8 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       std::vector<std::string> files;
       std::string mtime;
       std::string format;
+      int threads = -1;
+      bool zstd = false;
       bool doing_options = true;
       for (std::string::size_type cc = 4; cc < args.size(); cc++) {
         std::string const& arg = args[cc];
@@ -1029,11 +1040,23 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
             doing_options = false;
           } else if (cmHasLiteralPrefix(arg, "--mtime=")) {
             mtime = arg.substr(8);
+          } else if (arg == "--zstd") {
+            zstd = true;
           } else if (cmHasLiteralPrefix(arg, "--files-from=")) {
             std::string const& files_from = arg.substr(13);
             if (!cmTarFilesFrom(files_from, files)) {
               return 1;
             }
+          } else if (cmHasLiteralPrefix(arg, "--threads=")) {
+            std::string const& value = arg.substr(10);
+            unsigned long n;
+            if (!cmSystemTools::StringToULong(value.c_str(), &n) ||
+                n > 1024) {
+              cmSystemTools::Error("Invalid -E tar --threads= argument: ",
+                                   value.c_str());
+              return 1;
+            }
+            threads = static_cast<int>(n);
           } else if (cmHasLiteralPrefix(arg, "--format=")) {
             format = arg.substr(9);
             bool isKnown =
@@ -1069,6 +1092,10 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
         compress = cmSystemTools::TarCompressGZip;
         ++nCompress;
       }
+      if (zstd) {
+        compress = cmSystemTools::TarCompressZstd;
+        ++nCompress;
+      }
       if ((format == "7zip" || format == "zip") && nCompress > 0) {
         cmSystemTools::Error("Can not use compression flags with format: ",
                              format.c_str());
@@ -1076,7 +1103,8 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       }
       if (nCompress > 1) {
         cmSystemTools::Error("Can only compress a tar file one way; "
-                             "at most one flag of z, j, or J may be used");
+                             "at most one flag of z, j, J, or --zstd "
+                             "may be used");
         return 1;
       }
       if (flags.find_first_of('v') != std::string::npos) {
@@ -1090,7 +1118,7 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
         }
       } else if (flags.find_first_of('c') != std::string::npos) {
         if (!cmSystemTools::CreateTar(outFile.c_str(), files, compress,
-                                      verbose, mtime, format)) {
+                                      verbose, mtime, format, threads)) {
           cmSystemTools::Error("Problem creating tar: ", outFile.c_str());
           return 1;
         }
@@ -1214,14 +1242,27 @@ int cmcmd::HashSumFile(std::vector<std::string>& args, cmCryptoHash::Algo algo)
   }
   int retval = 0;
 
+  // Hash the files concurrently and report them in order.
+  std::vector<std::string> files;
+  std::vector<bool> isDirectory;
+  for (std::string::size_type cc = 2; cc < args.size(); cc++) {
+    isDirectory.push_back(cmSystemTools::FileIsDirectory(args[cc]));
+    if (!isDirectory.back()) {
+      files.push_back(args[cc]);
+    }
+  }
+  std::vector<std::string> const hashes =
+    cmSystemTools::ComputeFileHashes(files, algo);
+
+  std::vector<std::string>::const_iterator hi = hashes.begin();
   for (std::string::size_type cc = 2; cc < args.size(); cc++) {
     const char* filename = args[cc].c_str();
     // Cannot compute sum of a directory
-    if (cmSystemTools::FileIsDirectory(filename)) {
+    if (isDirectory[cc - 2]) {
       std::cerr << "Error: " << filename << " is a directory" << std::endl;
       retval++;
     } else {
-      std::string value = cmSystemTools::ComputeFileHash(filename, algo);
+      std::string const& value = *hi++;
       if (value.empty()) {
         // To mimic "md5sum/shasum" behavior in a shell:
         std::cerr << filename << ": No such file or directory" << std::endl;
@@ -1234,6 +1275,85 @@ int cmcmd::HashSumFile(std::vector<std::string>& args, cmCryptoHash::Algo algo)
   return retval;
 }
 
+// The commands "cmake -E batch" runs.  They work on files and neither
+// exit the process nor run other processes.
+static bool cmcmdIsBatchCommand(std::string const& name)
+{
+  static const char* const batchCommands[] = {
+    "compare_files",    "copy",           "copy_directory",
+    "copy_if_different", "create_symlink", "echo",
+    "echo_append",      "make_directory", "remove",
+    "remove_directory", "rename",         "touch",
+    "touch_nocreate"
+  };
+
+  return std::find(cm::cbegin(batchCommands), cm::cend(batchCommands),
+                   name) != cm::cend(batchCommands);
+}
+
+int cmcmd::ExecuteBatch(std::vector<std::string> const& args)
+{
+  std::vector<std::vector<std::string>> commands;
+  if (args[2] == "--") {
+    // The commands are given on the command line separated by "--".
+    for (std::string::size_type cc = 2; cc < args.size(); cc++) {
+      if (args[cc] == "--") {
+        commands.emplace_back();
+      } else {
+        commands.back().push_back(args[cc]);
+      }
+    }
+  } else {
+    // The commands are given one per line in a file or on stdin.
+    cmsys::ifstream fin;
+    std::istream* in = &std::cin;
+    if (args[2] != "-") {
+      fin.open(args[2].c_str());
+      if (!fin) {
+        std::cerr << "Error: cannot read batch file \"" << args[2]
+                  << "\".\n";
+        return 1;
+      }
+      in = &fin;
+    }
+    std::string line;
+    while (cmSystemTools::GetLineFromStream(*in, line)) {
+      std::string::size_type pos = line.find_first_not_of(" \t");
+      if (pos == std::string::npos || line[pos] == '#') {
+        continue;
+      }
+      commands.emplace_back();
+      cmSystemTools::ParseUnixCommandLine(line.c_str(), commands.back());
+    }
+  }
+
+  // Check all commands before running any of them.
+  for (std::vector<std::string> const& command : commands) {
+    if (!command.empty() && !cmcmdIsBatchCommand(command[0])) {
+      std::cerr << "Error: batch cannot run command \"" << command[0]
+                << "\".\n";
+      return 1;
+    }
+  }
+
+  // Stop at the first command that fails, as a shell running the
+  // commands joined by "&&" would.
+  for (std::vector<std::string> const& command : commands) {
+    if (command.empty()) {
+      continue;
+    }
+    std::vector<std::string> commandArgs;
+    commandArgs.reserve(command.size() + 1);
+    commandArgs.push_back(args[0]);
+    commandArgs.insert(commandArgs.end(), command.begin(), command.end());
+    int const result = cmcmd::ExecuteCMakeCommand(commandArgs);
+    if (result != 0) {
+      return result;
+    }
+  }
+  return 0;
+}
+
 int cmcmd::SymlinkLibrary(std::vector<std::string>& args)
 {
   int result = 0;
@@ -77,8 +77,13 @@ static const char* cmDocumentationOptions[][2] = {
     "Run a specific number of tests by number." },
   { "-U, --union", "Take the Union of -I and -R" },
   { "--rerun-failed", "Run only the tests that failed previously" },
+  { "--changed-since <file>", "Run only the tests affected by the changed "
+                              "files listed in <file>" },
   { "--repeat-until-fail <n>", "Require each test to run <n> "
                                "times without failing in order to pass" },
+  { "--repeat-until-pass <n>", "Allow each test to run up to <n> "
+                               "times in order to pass" },
+  { "--stop-on-failure", "Stop running the tests after one has failed" },
   { "--max-width <width>", "Set the max width for a test name to output" },
   { "--interactive-debug-mode [0|1]", "Set the interactive mode to 0 or 1." },
   { "--no-label-summary", "Disable timing summary information for labels." },
@@ -0,0 +1,212 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include "cmRegularExpression.h"
+
+#include "cmsys/RegularExpression.hxx"
+#include <iostream>
+#include <string>
+
+// Patterns as they appear in Modules/ after argument processing.
+static const char* const Patterns[] = {
+  "^[0-9]+$",
+  "[0-9]+",
+  " +",
+  "^([0-9]+)\\.([0-9]+)\\.([0-9]+)$",
+  "[\r\n]",
+  "/([^/]+)\\.framework$",
+  "^(.*)/[^/]+$",
+  "^(.+)(\\.[^.]+)$",
+  "\\.0+([0-9])",
+  ".*([0-9]+).*",
+  "([][+.*?()^$])",
+  "(.+-)?llvm-$",
+  "^.*/[a-zA-Z]+([0-9]+)\\-([a-z]+)\\-(.+\\.png)$",
+  "^([0-9]+\\.[0-9]+)",
+  "^(-l|-framework )?(.*)",
+  "^[ \t]*#define[ \t]+([A-Za-z_]+)[ \t]+\"?([^\"]*)\"?",
+  "([^;]*);?(.*)",
+  "(a|ab)(c|bcd)(d*)",
+  "((a)|b)+",
+  "(a*)+b|c",
+  "x*",
+  "^$",
+  "a|b|",
+  "()",
+  "[-a]",
+  "[]a]+",
+  "[^]a]",
+  "[a-c-e]+",
+  "^^a",
+  "a$$",
+  "(^a|b$)+",
+  "\\(\\)\\|",
+  "[",
+  "a**",
+  "(a",
+  "a)",
+  "*a",
+  "a\\",
+  "[b-a]",
+  "(a|)*",
+  "((((((((((a))))))))))",
+  "(((((((((a)))))))))",
+};
+
+static const char* const Inputs[] = {
+  "",
+  "a",
+  "ab",
+  "abcd",
+  "abcbcd",
+  "aaab",
+  "1.2.3",
+  "10.20.30.40",
+  "01.2",
+  "/usr/lib/Foo.framework",
+  "/usr/lib/libfoo.so.1",
+  "x86_64-linux-gnu-llvm-",
+  "a;b;c",
+  "  #define VERSION \"1.2\"",
+  "share/icons/hicolor/32x32-apps-foo.png",
+  "-framework Cocoa",
+  "line1\r\nline2",
+  "]]a-b-c-d-e",
+  "(a+b)*c?[d]^$",
+  "b\nb",
+};
+
+#define cmFailed(m)                                                           \
+  do {                                                                        \
+    std::cout << "FAILED: " << m << "\n";                                     \
+    failed = 1;                                                               \
+  } while (false)
+
+static bool Compare(std::string const& pattern, std::string const& input,
+                    bool& compiled)
+{
+  cmsys::RegularExpression expected;
+  cmRegularExpression actual;
+  compiled = expected.compile(pattern);
+  if (actual.compile(pattern) != compiled) {
+    return false;
+  }
+  if (!compiled) {
+    return true;
+  }
+  bool const found = expected.find(input.c_str());
+  if (actual.find(input) != found) {
+    return false;
+  }
+  if (!found) {
+    return true;
+  }
+  for (int n = 0; n < cmRegularExpression::NSUBEXP; ++n) {
+    std::string const m = expected.match(n);
+    if (actual.match(n) != m) {
+      return false;
+    }
+    if (!m.empty() &&
+        (actual.start(n) != expected.start(n) ||
+         actual.end(n) != expected.end(n))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static size_t Random(unsigned int& seed, size_t n)
+{
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 16) % n;
+}
+
+// Generate a random expression that compiles: repeat only operands that
+// cannot match the empty string, and use at most 9 groups.  Set "width"
+// if the expression cannot match the empty string.
+static std::string RandomPattern(unsigned int& seed, int depth, int& groups,
+                                 bool& width)
+{
+  static const char* const atoms[] = { "a", "b", ".", "^", "$", "[ab]",
+                                       "[^a]", "[]-]", "[a-b]", "\\-" };
+  std::string pattern;
+  width = false;
+  for (size_t n = 1 + Random(seed, 3); n > 0; --n) {
+    std::string atom;
+    bool atomWidth;
+    if (depth > 0 && groups < 9 && Random(seed, 3) == 0) {
+      ++groups;
+      atom = "(" + RandomPattern(seed, depth - 1, groups, atomWidth) + ")";
+    } else {
+      atom = atoms[Random(seed, sizeof(atoms) / sizeof(atoms[0]))];
+      atomWidth = atom != "^" && atom != "$";
+    }
+    if (atomWidth) {
+      char const op = "\0\0*+?"[Random(seed, 5)];
+      if (op != '\0') {
+        atom += op;
+      }
+      atomWidth = op != '*' && op != '?';
+    }
+    pattern += atom;
+    width = width || atomWidth;
+  }
+  if (depth > 0 && Random(seed, 4) == 0) {
+    bool branchWidth;
+    pattern += "|" + RandomPattern(seed, depth - 1, groups, branchWidth);
+    width = width && branchWidth;
+  }
+  return pattern;
+}
+
+int testRegularExpression(int /*unused*/, char* /*unused*/ [])
+{
+  int failed = 0;
+
+  // Compile each invalid pattern only once: cmsys prints a message
+  // every time.
+  for (const char* pattern : Patterns) {
+    for (const char* input : Inputs) {
+      bool compiled;
+      if (!Compare(pattern, input, compiled)) {
+        cmFailed("pattern \"" << pattern << "\" on \"" << input << "\"");
+      }
+      if (!compiled) {
+        break;
+      }
+    }
+  }
+
+  // Compare random expressions, which exercise nesting, alternation and
+  // repetition far more than real patterns do.
+  unsigned int seed = 1;
+  for (int i = 0; i < 10000; ++i) {
+    int groups = 0;
+    bool width;
+    std::string const pattern = RandomPattern(seed, 3, groups, width);
+    std::string input;
+    for (size_t n = Random(seed, 10); n > 0; --n) {
+      input += "ab-]"[Random(seed, 4)];
+    }
+    bool compiled;
+    if (!Compare(pattern, input, compiled) || !compiled) {
+      cmFailed("pattern \"" << pattern << "\" on \"" << input << "\"");
+    }
+  }
+
+  // A pattern that makes a backtracking matcher take exponential time.
+  {
+    cmRegularExpression re;
+    std::string const input(5000, 'a');
+    if (!re.compile("^(a|aa)+$") || !re.find(input) || re.end() != 5000 ||
+        re.find(input + "b")) {
+      cmFailed("linear time matching");
+    }
+  }
+
+  if (cmRegularExpression::GetCacheSize() == 0) {
+    cmFailed("compiled patterns are not cached");
+  }
+
+  return failed;
+}
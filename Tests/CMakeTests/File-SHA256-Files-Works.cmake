@@ -0,0 +1,11 @@
+file(SHA256 sha256 FILES
+  ${CMAKE_CURRENT_LIST_DIR}/File-HASH-Input.txt
+  ${CMAKE_CURRENT_LIST_DIR}/File-MD5-Works.cmake
+  ${CMAKE_CURRENT_LIST_DIR}/File-HASH-Input.txt
+  )
+file(SHA256 ${CMAKE_CURRENT_LIST_DIR}/File-MD5-Works.cmake expect)
+if(NOT sha256 MATCHES "^([0-9a-f]+);${expect};([0-9a-f]+)$"
+   OR NOT CMAKE_MATCH_1 STREQUAL CMAKE_MATCH_2)
+  message(FATAL_ERROR "Unexpected hashes: ${sha256}")
+endif()
+message("${CMAKE_MATCH_1}")
@@ -0,0 +1,25 @@
+set(dir ${CMAKE_CURRENT_BINARY_DIR}/File-SHA256-HashTree)
+file(REMOVE_RECURSE ${dir})
+file(WRITE ${dir}/b.txt "b")
+file(WRITE ${dir}/a/c.txt "c")
+file(WRITE ${dir}/a/a.txt "a")
+file(MAKE_DIRECTORY ${dir}/empty)
+
+set(lines "")
+foreach(name a/a.txt a/c.txt b.txt)
+  file(SHA256 ${dir}/${name} hash)
+  string(APPEND lines "${hash}  ${name}\n")
+endforeach()
+string(SHA256 expect "${lines}")
+
+file(SHA256 tree HASH_TREE ${dir})
+if(NOT tree STREQUAL expect)
+  message(FATAL_ERROR "HASH_TREE gave\n  ${tree}\nbut expected was\n  ${expect}")
+endif()
+
+file(WRITE ${dir}/a/c.txt "changed")
+file(SHA256 changed HASH_TREE ${dir})
+if(changed STREQUAL tree)
+  message(FATAL_ERROR "HASH_TREE did not change with the content of a file")
+endif()
+message("HASH_TREE ok")
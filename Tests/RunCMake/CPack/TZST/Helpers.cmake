@@ -0,0 +1,3 @@
+set(cpack_archive_extension_ "tar.zst")
+
+include("${CMAKE_CURRENT_LIST_DIR}/../ArchiveCommon/common_helpers.cmake")
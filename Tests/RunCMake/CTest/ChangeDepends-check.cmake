@@ -0,0 +1,11 @@
+set(f "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake")
+if(NOT EXISTS "${f}")
+  set(RunCMake_TEST_FAILED "File does not exist:\n  ${f}")
+  return()
+endif()
+file(READ ${f} content)
+if(NOT content MATCHES "set_tests_properties\\(exe PROPERTIES CHANGE_DEPENDS \"[^\"]*/lib\\.c;[^\"]*/main\\.c\"\\)")
+  set(RunCMake_TEST_FAILED "File:\n  ${f}\ndoes not list the exe dependencies:\n  ${content}")
+elseif(content MATCHES "set_tests_properties\\(cmd ")
+  set(RunCMake_TEST_FAILED "File:\n  ${f}\nlists dependencies for a non-target test:\n  ${content}")
+endif()
@@ -0,0 +1,8 @@
+enable_language(C)
+enable_testing()
+set(CMAKE_TEST_CHANGE_DEPENDS ON)
+add_library(lib STATIC lib.c)
+add_executable(exe main.c)
+target_link_libraries(exe lib)
+add_test(NAME exe COMMAND exe)
+add_test(NAME cmd COMMAND ${CMAKE_COMMAND} -E echo cmd)
@@ -0,0 +1,9 @@
+set(f "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake")
+if(NOT EXISTS "${f}")
+  set(RunCMake_TEST_FAILED "File does not exist:\n  ${f}")
+  return()
+endif()
+file(READ ${f} content)
+if(content MATCHES "CHANGE_DEPENDS")
+  set(RunCMake_TEST_FAILED "File:\n  ${f}\nlists dependencies without CMAKE_TEST_CHANGE_DEPENDS:\n  ${content}")
+endif()
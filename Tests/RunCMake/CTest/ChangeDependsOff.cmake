@@ -0,0 +1,4 @@
+enable_language(C)
+enable_testing()
+add_executable(exe main.c)
+add_test(NAME exe COMMAND exe)
@@ -5,3 +5,5 @@ run_cmake(BeforeProject)
 unset(RunCMake_TEST_OPTIONS)
 
 run_cmake(NotOn)
+run_cmake(ChangeDepends)
+run_cmake(ChangeDependsOff)
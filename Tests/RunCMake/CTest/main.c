@@ -0,0 +1,5 @@
+extern int lib(void);
+int main(void)
+{
+  return lib();
+}
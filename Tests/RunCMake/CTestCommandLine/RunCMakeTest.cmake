@@ -28,6 +28,41 @@ function(run_repeat_until_fail_tests)
 endfunction()
 run_repeat_until_fail_tests()
 
+run_cmake_command(repeat-until-pass-bad
+  ${CMAKE_CTEST_COMMAND} --repeat-until-fail 2 --repeat-until-pass 2
+  )
+
+function(run_repeat_until_pass_tests)
+  # Use a single build tree for a few tests without cleaning.
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/repeat-until-pass-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+
+  run_cmake(repeat-until-pass-cmake)
+  run_cmake_command(repeat-until-pass-ctest
+    ${CMAKE_CTEST_COMMAND} -C Debug --repeat-until-pass 3
+    )
+endfunction()
+run_repeat_until_pass_tests()
+
+function(run_StopOnFailure name)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/${name})
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(Sleep \"${CMAKE_COMMAND}\" -E sleep 60)
+set_tests_properties(Sleep PROPERTIES COST 2)
+add_test(Failing \"${CMAKE_COMMAND}\" -E no_such_command)
+set_tests_properties(Failing PROPERTIES COST 1)
+add_test(NotStarted \"${CMAKE_COMMAND}\" -E echo \"NotStarted\")
+")
+  run_cmake_command(${name} ${CMAKE_CTEST_COMMAND} --stop-on-failure ${ARGN})
+endfunction()
+run_StopOnFailure(stop-on-failure -E Sleep)
+run_StopOnFailure(stop-on-failure-kill -j2)
+
 function(run_BadCTestTestfile)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/BadCTestTestfile)
   set(RunCMake_TEST_NO_CLEAN 1)
@@ -141,3 +176,43 @@ function(run_TestOutputSize)
     )
 endfunction()
 run_TestOutputSize()
+
+function(run_ChangedSince)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ChangedSince)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/data.txt" "")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+add_test(Affected \"${CMAKE_COMMAND}\" -E echo \"Affected\")
+set_tests_properties(Affected PROPERTIES CHANGE_DEPENDS \"/src/a.c;/src/b.c\")
+add_test(NotAffected \"${CMAKE_COMMAND}\" -E echo \"NotAffected\")
+set_tests_properties(NotAffected PROPERTIES CHANGE_DEPENDS \"/src/c.c;/src/ab.c\")
+add_test(DataAffected \"${CMAKE_COMMAND}\" -E echo \"DataAffected\")
+set_tests_properties(DataAffected PROPERTIES REQUIRED_FILES \"${RunCMake_TEST_BINARY_DIR}/data.txt\")
+add_test(NoDepends \"${CMAKE_COMMAND}\" -E echo \"NoDepends\")
+")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/changed.txt" "src/b.c\ndata.txt\n")
+  run_cmake_command(ChangedSince ${CMAKE_CTEST_COMMAND} --changed-since changed.txt)
+endfunction()
+run_ChangedSince()
+
+function(run_TestManifest name)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/${name}-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+
+  run_cmake(${name}-cmake)
+  if(name STREQUAL "TestManifest")
+    run_cmake_command(${name}-ctest ${CMAKE_CTEST_COMMAND} -V -N)
+    # The script must give the same tests and labels.
+    file(REMOVE
+      "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.json"
+      "${RunCMake_TEST_BINARY_DIR}/TestManifest/CTestTestfile.json"
+      )
+    run_cmake_command(${name}-ctest-script ${CMAKE_CTEST_COMMAND} -V -N)
+  endif()
+endfunction()
+run_TestManifest(TestManifest)
+run_TestManifest(TestManifestScript)
@@ -0,0 +1,3 @@
+if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.json")
+  set(RunCMake_TEST_FAILED "Test manifest not generated:\n  ${RunCMake_TEST_BINARY_DIR}/CTestTestfile.json")
+endif()
@@ -0,0 +1,5 @@
+enable_testing()
+add_test(NAME Manifest COMMAND ${CMAKE_COMMAND} -E echo "a;b")
+set_tests_properties(Manifest PROPERTIES LABELS "Label1")
+set_property(DIRECTORY PROPERTY LABELS "DirLabel")
+add_subdirectory(TestManifest)
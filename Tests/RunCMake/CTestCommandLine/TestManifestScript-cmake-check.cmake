@@ -0,0 +1,3 @@
+if(EXISTS "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.json")
+  set(RunCMake_TEST_FAILED "Test manifest generated for configuration-specific test:\n  ${RunCMake_TEST_BINARY_DIR}/CTestTestfile.json")
+endif()
@@ -0,0 +1,2 @@
+enable_testing()
+add_test(NAME ConfigSpecific COMMAND ${CMAKE_COMMAND} -E echo "a;b" CONFIGURATIONS Debug)
@@ -0,0 +1,35 @@
+enable_language(C)
+enable_language(CXX)
+include(CheckBatch)
+include(CheckIncludeFile)
+include(CheckIncludeFileCXX)
+include(CheckSymbolExists)
+include(CheckCSourceCompiles)
+include(CheckCXXSourceCompiles)
+
+check_batch_begin()
+check_include_file(stddef.h HAVE_STDDEF_H)
+check_include_file(does_not_exist_batch.h HAVE_DOES_NOT_EXIST_BATCH_H)
+check_include_file_cxx(cstddef HAVE_CSTDDEF)
+check_symbol_exists(offsetof stddef.h HAVE_OFFSETOF)
+check_c_source_compiles("int main(void) { return 0; }" C_SOURCE_COMPILES)
+check_c_source_compiles("int main(void) { return 0; }" C_SOURCE_FAIL_REGEX
+  FAIL_REGEX "Change Dir")
+check_cxx_source_compiles("int main() { return undeclared; }"
+  CXX_SOURCE_DOES_NOT_COMPILE)
+if(DEFINED HAVE_STDDEF_H)
+  message(FATAL_ERROR "HAVE_STDDEF_H set before check_batch_end()")
+endif()
+check_batch_end()
+
+foreach(var HAVE_STDDEF_H HAVE_CSTDDEF HAVE_OFFSETOF C_SOURCE_COMPILES)
+  if(NOT "${${var}}" STREQUAL "1")
+    message(FATAL_ERROR "${var} is '${${var}}', not '1'")
+  endif()
+endforeach()
+foreach(var HAVE_DOES_NOT_EXIST_BATCH_H C_SOURCE_FAIL_REGEX
+            CXX_SOURCE_DOES_NOT_COMPILE)
+  if(NOT DEFINED ${var} OR NOT "${${var}}" STREQUAL "")
+    message(FATAL_ERROR "${var} is '${${var}}', not ''")
+  endif()
+endforeach()
@@ -0,0 +1,3 @@
+if(EXISTS "${RunCMake_BINARY_DIR}/batch_output/bad.txt")
+  set(RunCMake_TEST_FAILED "Batch ran commands before the bad one.\n")
+endif()
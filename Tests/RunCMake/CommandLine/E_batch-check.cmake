@@ -0,0 +1,5 @@
+foreach(f d/f.txt d/g.txt)
+  if(NOT EXISTS "${RunCMake_BINARY_DIR}/batch_output/${f}")
+    string(APPEND RunCMake_TEST_FAILED "Missing\n  ${f}\n")
+  endif()
+endforeach()
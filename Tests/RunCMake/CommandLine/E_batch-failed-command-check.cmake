@@ -0,0 +1,3 @@
+if(EXISTS "${RunCMake_BINARY_DIR}/batch_output/failed.txt")
+  set(RunCMake_TEST_FAILED "Batch ran commands after the failed one.\n")
+endif()
@@ -0,0 +1,3 @@
+if(NOT EXISTS "${RunCMake_BINARY_DIR}/batch_output/from file/f.txt")
+  set(RunCMake_TEST_FAILED "Missing\n  from file/f.txt\n")
+endif()
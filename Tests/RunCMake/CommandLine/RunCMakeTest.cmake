@@ -165,6 +165,26 @@ run_cmake_command(E_make_directory-three-directories-and-file
 unset(out)
 unset(outfile)
 
+set(out ${RunCMake_BINARY_DIR}/batch_output)
+file(REMOVE_RECURSE "${out}")
+file(WRITE ${out}/commands.txt "# Comment
+make_directory \"${out}/from file\"
+
+touch \"${out}/from file/f.txt\"
+")
+run_cmake_command(E_batch
+  ${CMAKE_COMMAND} -E batch -- make_directory ${out}/d
+                            -- touch ${out}/d/f.txt
+                            -- copy_if_different ${out}/d/f.txt ${out}/d/g.txt)
+run_cmake_command(E_batch-file ${CMAKE_COMMAND} -E batch ${out}/commands.txt)
+run_cmake_command(E_batch-no-file ${CMAKE_COMMAND} -E batch ${out}/missing.txt)
+run_cmake_command(E_batch-bad-command
+  ${CMAKE_COMMAND} -E batch -- touch ${out}/bad.txt -- env)
+run_cmake_command(E_batch-failed-command
+  ${CMAKE_COMMAND} -E batch -- compare_files ${out}/commands.txt ${out}/d/f.txt
+                            -- touch ${out}/failed.txt)
+unset(out)
+
 
 run_cmake_command(E_env-no-command0 ${CMAKE_COMMAND} -E env)
 run_cmake_command(E_env-no-command1 ${CMAKE_COMMAND} -E env TEST_ENV=1)
@@ -15,14 +15,20 @@ external_command_test(end-opt1   tar cvf bad.tar -- --bad)
 external_command_test(end-opt2   tar cvf bad.tar --)
 external_command_test(mtime      tar cvf bad.tar "--mtime=1970-01-01 00:00:00 UTC")
 external_command_test(bad-format tar cvf bad.tar "--format=bad-format")
+external_command_test(bad-threads tar cvzf bad.tar "--threads=bad")
 external_command_test(zip-bz2    tar cvjf bad.tar "--format=zip")
 external_command_test(7zip-gz    tar cvzf bad.tar "--format=7zip")
+external_command_test(zstd-gz    tar cvzf bad.tar --zstd)
 
 run_cmake(7zip)
 run_cmake(gnutar)
 run_cmake(gnutar-gz)
+run_cmake(gnutar-gz-threads)
+run_cmake(gnutar-zstd-threads)
 run_cmake(pax)
 run_cmake(pax-xz)
+run_cmake(pax-xz-threads)
+run_cmake(pax-zstd)
 run_cmake(paxr)
 run_cmake(paxr-bz2)
 run_cmake(zip)
@@ -0,0 +1,32 @@
+# Add a file large enough to span several compressed blocks.
+set(content "0123456789abcdef")
+foreach(i RANGE 16)
+  string(APPEND content "${content}")
+endforeach()
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/compress_dir/d1/large.txt "${content}")
+
+set(OUTPUT_NAME "test.tar.gz")
+
+set(COMPRESSION_FLAGS cvzf)
+set(COMPRESSION_OPTIONS --format=gnutar --threads=3)
+
+set(DECOMPRESSION_FLAGS xvzf)
+
+include(${CMAKE_CURRENT_LIST_DIR}/roundtrip.cmake)
+
+check_magic("1f8b" LIMIT 2 HEX)
+
+file(MD5 ${FULL_OUTPUT_NAME} threads3_md5)
+file(REMOVE ${FULL_OUTPUT_NAME})
+run_tar(${CMAKE_CURRENT_BINARY_DIR} cvzf ${FULL_OUTPUT_NAME} --format=gnutar
+  --threads=1 ${COMPRESS_DIR})
+file(MD5 ${FULL_OUTPUT_NAME} threads1_md5)
+if(NOT threads1_md5 STREQUAL threads3_md5)
+  message(FATAL_ERROR "Archives created with 1 and 3 threads differ")
+endif()
+
+file(MD5 ${FULL_COMPRESS_DIR}/d1/large.txt input_md5)
+file(MD5 ${FULL_DECOMPRESS_DIR}/${COMPRESS_DIR}/d1/large.txt output_md5)
+if(NOT input_md5 STREQUAL output_md5)
+  message(FATAL_ERROR "Large file did not survive the round trip")
+endif()
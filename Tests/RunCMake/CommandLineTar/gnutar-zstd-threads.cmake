@@ -0,0 +1,19 @@
+set(OUTPUT_NAME "test.tar.zst")
+
+set(COMPRESSION_FLAGS cvf)
+set(COMPRESSION_OPTIONS --format=gnutar --zstd --threads=3)
+
+set(DECOMPRESSION_FLAGS xvf)
+
+include(${CMAKE_CURRENT_LIST_DIR}/roundtrip.cmake)
+
+check_magic("28b52ffd" LIMIT 4 HEX)
+
+file(MD5 ${FULL_OUTPUT_NAME} threads3_md5)
+file(REMOVE ${FULL_OUTPUT_NAME})
+run_tar(${CMAKE_CURRENT_BINARY_DIR} cvf ${FULL_OUTPUT_NAME} --format=gnutar
+  --zstd --threads=1 ${COMPRESS_DIR})
+file(MD5 ${FULL_OUTPUT_NAME} threads1_md5)
+if(NOT threads1_md5 STREQUAL threads3_md5)
+  message(FATAL_ERROR "Archives created with 1 and 3 threads differ")
+endif()
@@ -0,0 +1,13 @@
+foreach(pair "stage0;stale" "stage2;chained" "stage3;chained")
+  list(GET pair 0 name)
+  list(GET pair 1 expect)
+  set(f "${RunCMake_TEST_BINARY_DIR}/${name}.txt")
+  if(EXISTS "${f}")
+    file(READ "${f}" content)
+    if(NOT content MATCHES "^${expect}[\r\n]*$")
+      string(APPEND RunCMake_TEST_FAILED "File\n  ${f}\ndoes not have expected content:\n  ${content}\n")
+    endif()
+  else()
+    string(APPEND RunCMake_TEST_FAILED "Missing\n  ${f}\n")
+  endif()
+endforeach()
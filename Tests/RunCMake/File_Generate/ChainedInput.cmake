@@ -0,0 +1,7 @@
+cmake_policy(SET CMP0070 NEW)
+set(stage1 "${CMAKE_CURRENT_BINARY_DIR}/stage1.txt")
+file(WRITE "${stage1}" "stale\n")
+file(GENERATE OUTPUT stage0.txt INPUT "${stage1}")
+file(GENERATE OUTPUT stage1.txt CONTENT "$<1:$><1:chained>\n")
+file(GENERATE OUTPUT stage2.txt INPUT "${stage1}")
+file(GENERATE OUTPUT stage3.txt INPUT "${CMAKE_CURRENT_BINARY_DIR}/stage2.txt")
@@ -3,6 +3,8 @@ include(RunCMake)
 run_cmake(CMP0070-NEW)
 run_cmake(CMP0070-OLD)
 run_cmake(CMP0070-WARN)
+run_cmake(SharedInput)
+run_cmake(ChainedInput)
 
 run_cmake(CommandConflict)
 if(RunCMake_GENERATOR_IS_MULTI_CONFIG)
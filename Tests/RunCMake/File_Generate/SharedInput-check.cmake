@@ -0,0 +1,15 @@
+foreach(i RANGE 1 20)
+  foreach(pair "input-${i};relative-input-NEW" "content-${i};shared-content-${i}")
+    list(GET pair 0 name)
+    list(GET pair 1 expect)
+    set(f "${RunCMake_TEST_BINARY_DIR}/shared-${name}.txt")
+    if(EXISTS "${f}")
+      file(READ "${f}" content)
+      if(NOT content MATCHES "^${expect}[\r\n]*$")
+        string(APPEND RunCMake_TEST_FAILED "File\n  ${f}\ndoes not have expected content.\n")
+      endif()
+    else()
+      string(APPEND RunCMake_TEST_FAILED "Missing\n  ${f}\n")
+    endif()
+  endforeach()
+endforeach()
@@ -0,0 +1,5 @@
+cmake_policy(SET CMP0070 NEW)
+foreach(i RANGE 1 20)
+  file(GENERATE OUTPUT shared-input-${i}.txt INPUT relative-input-NEW.txt)
+  file(GENERATE OUTPUT shared-content-${i}.txt CONTENT "shared-content-${i}\n")
+endforeach()
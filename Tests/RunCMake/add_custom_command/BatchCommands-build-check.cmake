@@ -0,0 +1,28 @@
+foreach(f
+    "out/sub/copy with space.txt"
+    out/stamp.txt
+    out/first.txt
+    out/chained.txt
+    )
+  if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/${f}")
+    string(APPEND RunCMake_TEST_FAILED "Missing\n  ${f}\n")
+  endif()
+endforeach()
+
+if(RunCMake_GENERATOR MATCHES "Make|Ninja")
+  file(GLOB_RECURSE build_files
+    "${RunCMake_TEST_BINARY_DIR}/build.ninja"
+    "${RunCMake_TEST_BINARY_DIR}/build.make"
+    )
+  set(batched 0)
+  foreach(f IN LISTS build_files)
+    file(STRINGS "${f}" lines REGEX "-E batch -- make_directory")
+    if(lines)
+      set(batched 1)
+    endif()
+  endforeach()
+  if(NOT batched)
+    string(APPEND RunCMake_TEST_FAILED
+      "Consecutive cmake -E commands were not run as one batch.\n")
+  endif()
+endif()
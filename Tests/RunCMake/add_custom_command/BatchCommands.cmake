@@ -0,0 +1,15 @@
+add_custom_command(
+  OUTPUT out/stamp.txt
+  COMMAND ${CMAKE_COMMAND} -E make_directory out/sub
+  COMMAND ${CMAKE_COMMAND} -E copy_if_different
+          ${CMAKE_CURRENT_LIST_FILE} "out/sub/copy with space.txt"
+  COMMAND ${CMAKE_COMMAND} -E touch out/stamp.txt
+  VERBATIM
+  )
+add_custom_command(
+  OUTPUT out/chained.txt
+  COMMAND ${CMAKE_COMMAND} -E make_directory out
+  COMMAND ${CMAKE_COMMAND} -E touch out/first.txt
+          && ${CMAKE_COMMAND} -E touch out/chained.txt
+  )
+add_custom_target(batch ALL DEPENDS out/stamp.txt out/chained.txt)
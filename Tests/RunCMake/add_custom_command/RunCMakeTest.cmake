@@ -14,3 +14,13 @@ run_cmake(TargetNotInDir)
 if(${RunCMake_GENERATOR} MATCHES "Visual Studio ([^89]|[89][0-9])")
   run_cmake(RemoveEmptyCommands)
 endif()
+
+function(run_BatchCommands)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/BatchCommands-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  run_cmake(BatchCommands)
+  run_cmake_command(BatchCommands-build ${CMAKE_COMMAND} --build .)
+endfunction()
+run_BatchCommands()
@@ -0,0 +1,25 @@
+# The merged results must be those of the serial run, apart from times.
+set(serial_dir "${RunCMake_BINARY_DIR}/CoverageGcovSerial-build")
+foreach(xml Coverage.xml CoverageLog-0.xml)
+  file(GLOB serial_file "${serial_dir}/Testing/*/${xml}")
+  file(GLOB parallel_file "${RunCMake_TEST_BINARY_DIR}/Testing/*/${xml}")
+  if(NOT serial_file OR NOT parallel_file)
+    set(RunCMake_TEST_FAILED "${xml} not found")
+    return()
+  endif()
+  foreach(run serial parallel)
+    file(READ "${${run}_file}" ${run})
+    string(REGEX REPLACE "CoverageGcov(Serial|Parallel)" "" ${run}
+      "${${run}}")
+    string(REGEX REPLACE "<(Start|End)(Date)?Time>[^<]*" "" ${run}
+      "${${run}}")
+  endforeach()
+  if(NOT parallel STREQUAL serial)
+    set(RunCMake_TEST_FAILED
+      "${xml} differs from the serial run:\n${parallel_file}")
+    return()
+  endif()
+endforeach()
+if(NOT parallel MATCHES [[<Line Number="2" Count="4">  if \(x &lt; 0\) {</Line>]])
+  set(RunCMake_TEST_FAILED "common.h counts of all objects not merged")
+endif()
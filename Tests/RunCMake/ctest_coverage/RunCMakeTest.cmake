@@ -8,3 +8,22 @@ function(run_ctest_coverage CASE_NAME)
 endfunction()
 
 run_ctest_coverage(CoverageQuiet QUIET)
+
+# Collect gcov results serially and on several processes at once.  The
+# objects share a header, so the parallel runs have to merge its counts.
+function(run_CoverageGcov CASE_NAME)
+  set(CASE_CMAKELISTS_SUFFIX_CODE [[
+enable_language(C)
+set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} --coverage")
+add_executable(main main.c a.c b.c c.c d.c)
+add_test(NAME main COMMAND main)
+]])
+  file(COPY ${RunCMake_SOURCE_DIR}/gcov/
+    DESTINATION ${RunCMake_BINARY_DIR}/${CASE_NAME})
+  run_ctest(${CASE_NAME} ${ARGN})
+endfunction()
+if(CMAKE_C_COMPILER_ID STREQUAL "GNU" AND COVERAGE_COMMAND MATCHES "gcov")
+  unset(ENV{CTEST_PARALLEL_LEVEL})
+  run_CoverageGcov(CoverageGcovSerial -j1)
+  run_CoverageGcov(CoverageGcovParallel -j4)
+endif()
@@ -0,0 +1,6 @@
+#include "common.h"
+
+int a(void)
+{
+  return clamp(-1);
+}
@@ -0,0 +1,6 @@
+#include "common.h"
+
+int b(void)
+{
+  return clamp(5) + clamp(7);
+}
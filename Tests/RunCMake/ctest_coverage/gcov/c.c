@@ -0,0 +1,6 @@
+#include "common.h"
+
+int c(void)
+{
+  return clamp(42);
+}
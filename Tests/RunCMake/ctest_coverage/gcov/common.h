@@ -0,0 +1,10 @@
+static int clamp(int x)
+{
+  if (x < 0) {
+    return 0;
+  }
+  if (x > 9) {
+    return 9;
+  }
+  return x;
+}
@@ -0,0 +1,9 @@
+#include "common.h"
+
+int d(int x)
+{
+  if (x) {
+    return clamp(x);
+  }
+  return 0;
+}
@@ -0,0 +1,9 @@
+int a(void);
+int b(void);
+int c(void);
+int d(int x);
+
+int main(void)
+{
+  return a() + b() + c() + d(0) == 21 ? 0 : 1;
+}
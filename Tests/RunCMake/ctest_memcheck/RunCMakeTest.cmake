@@ -175,3 +175,23 @@ unset(CMAKELISTS_EXTRA_CODE)
 unset(CTEST_EXTRA_CODE)
 unset(CTEST_MEMCHECK_ARGS)
 unset(CTEST_SUFFIX_CODE)
+
+#-----------------------------------------------------------------------------
+set(CTEST_SUFFIX_CODE "message(\"Defect count: \${defect_count}\")")
+set(CTEST_MEMCHECK_ARGS "PARALLEL_LEVEL 4 DEFECT_COUNT defect_count")
+set(CTEST_EXTRA_CODE
+"set(CTEST_MEMORYCHECK_SANITIZER_OPTIONS \"simulate_sanitizer=1:report_bugs=1:history_size=5:exitcode=55\")
+")
+set(CMAKELISTS_EXTRA_CODE
+"foreach(i 1 2)
+  add_test(NAME TestLeak\${i} COMMAND \"\${CMAKE_COMMAND}\"
+    -P \"${RunCMake_SOURCE_DIR}/testAddressLeakSanitizer.cmake\")
+  add_test(NAME TestOverflow\${i} COMMAND \"\${CMAKE_COMMAND}\"
+    -P \"${RunCMake_SOURCE_DIR}/testAddressSanitizer.cmake\")
+endforeach()
+")
+run_mc_test(DummyAddressSanitizerParallel "" -DMEMCHECK_TYPE=AddressSanitizer)
+unset(CMAKELISTS_EXTRA_CODE)
+unset(CTEST_EXTRA_CODE)
+unset(CTEST_MEMCHECK_ARGS)
+unset(CTEST_SUFFIX_CODE)
@@ -0,0 +1,47 @@
+set(ENV{CMAKE_WORKER_THREADS} 4)
+
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(dst ${CMAKE_CURRENT_BINARY_DIR}/dst)
+file(REMOVE_RECURSE ${src} ${dst})
+
+# Copy enough files that they are copied concurrently.
+foreach(i RANGE 99)
+  math(EXPR length "${i} + 1")
+  string(RANDOM LENGTH ${length} content)
+  file(WRITE ${src}/dir/sub${i}/file${i}.txt "${i}:${content}")
+endforeach()
+file(WRITE ${src}/a/same.txt "a")
+file(WRITE ${src}/b/same.txt "bb")
+
+function(check_copy name)
+  file(READ ${src}/dir/${name} expect)
+  file(READ ${dst}/dir/${name} actual)
+  if(NOT actual STREQUAL expect)
+    message(SEND_ERROR "${name} has content\n  ${actual}\nnot\n  ${expect}")
+  endif()
+  file(TIMESTAMP ${src}/dir/${name} expect_time "%s")
+  file(TIMESTAMP ${dst}/dir/${name} actual_time "%s")
+  if(NOT actual_time STREQUAL expect_time)
+    message(SEND_ERROR "${name} has time ${actual_time}, not ${expect_time}")
+  endif()
+endfunction()
+
+# Directories without owner write permission are set up only after the
+# files in them have been copied.
+file(COPY ${src}/dir DESTINATION ${dst}
+  DIRECTORY_PERMISSIONS OWNER_READ OWNER_EXECUTE)
+foreach(i RANGE 99)
+  check_copy(sub${i}/file${i}.txt)
+endforeach()
+
+# Files copied to the same destination are copied in order.
+file(COPY ${src}/a/same.txt ${src}/b/same.txt DESTINATION ${dst})
+file(READ ${dst}/same.txt same)
+if(NOT same STREQUAL "bb")
+  message(SEND_ERROR "same.txt has content '${same}', not 'bb'")
+endif()
+
+# Copying again replaces changed files and makes directories writable.
+file(WRITE ${src}/dir/sub1/file1.txt "changed")
+file(COPY ${src}/dir DESTINATION ${dst})
+check_copy(sub1/file1.txt)
@@ -0,0 +1,10 @@
+set(script "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/VerifyGlobs.cmake")
+if(NOT EXISTS "${script}")
+  set(RunCMake_TEST_FAILED "Glob verification script not written:\n  ${script}")
+  return()
+endif()
+file(READ "${script}" content)
+if(NOT content MATCHES "file\\(GLOB NEW_GLOB LIST_DIRECTORIES true \"[^\"]*/src/\\*\\.c\"\\)"
+   OR NOT content MATCHES "file\\(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false \"[^\"]*/src/\\*\"\\)")
+  set(RunCMake_TEST_FAILED "Unexpected glob verification script:\n${content}")
+endif()
@@ -0,0 +1 @@
+file(GLOB files CONFIGURE_DEPENDS "*.c")
@@ -0,0 +1,4 @@
+file(MAKE_DIRECTORY "${CMAKE_CURRENT_BINARY_DIR}/src")
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/src/a.c" "")
+file(GLOB files CONFIGURE_DEPENDS "${CMAKE_CURRENT_BINARY_DIR}/src/*.c")
+file(GLOB_RECURSE files CONFIGURE_DEPENDS "${CMAKE_CURRENT_BINARY_DIR}/src/*")
@@ -0,0 +1,4 @@
+set(snapshot "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/GlobSnapshot.txt")
+if(NOT EXISTS "${snapshot}")
+  set(RunCMake_TEST_FAILED "Snapshot file not written:\n  ${snapshot}")
+endif()
@@ -0,0 +1,30 @@
+set(CMAKE_GLOB_SNAPSHOT ON)
+set(base "${CMAKE_CURRENT_BINARY_DIR}/snapshot")
+file(REMOVE_RECURSE "${base}")
+file(MAKE_DIRECTORY "${base}/a/b")
+file(WRITE "${base}/a/one.txt" "")
+file(WRITE "${base}/a/b/two.txt" "")
+
+file(GLOB_RECURSE files RELATIVE "${base}" "${base}/*.txt")
+if(NOT files STREQUAL "a/b/two.txt;a/one.txt")
+  message(FATAL_ERROR "Unexpected files: ${files}")
+endif()
+
+# Directories changed within the same second are listed again.
+file(WRITE "${base}/a/b/three.txt" "")
+file(MAKE_DIRECTORY "${base}/a/c")
+file(GLOB_RECURSE files RELATIVE "${base}" "${base}/*.txt")
+if(NOT files STREQUAL "a/b/three.txt;a/b/two.txt;a/one.txt")
+  message(FATAL_ERROR "Unexpected files after adding: ${files}")
+endif()
+
+file(GLOB_RECURSE files LIST_DIRECTORIES true RELATIVE "${base}" "${base}/*")
+if(NOT files STREQUAL "a;a/b;a/b/three.txt;a/b/two.txt;a/c;a/one.txt")
+  message(FATAL_ERROR "Unexpected entries: ${files}")
+endif()
+
+file(REMOVE "${base}/a/one.txt")
+file(GLOB_RECURSE files RELATIVE "${base}" "${base}/*.txt")
+if(NOT files STREQUAL "a/b/three.txt;a/b/two.txt")
+  message(FATAL_ERROR "Unexpected files after removing: ${files}")
+endif()
@@ -0,0 +1,6 @@
+file(READ /dev/zero hex LIMIT 4 HEX)
+message(STATUS "hex='${hex}'")
+file(READ /dev/zero hex OFFSET 2 LIMIT 3 HEX)
+message(STATUS "hex='${hex}'")
+file(STRINGS /dev/zero strings LIMIT_INPUT 16)
+message(STATUS "strings='${strings}'")
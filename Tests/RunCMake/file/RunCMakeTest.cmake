@@ -37,8 +37,29 @@ run_cmake(GLOB-error-LIST_DIRECTORIES-not-boolean)
 # test is valid both for GLOB and GLOB_RECURSE
 run_cmake(GLOB-error-LIST_DIRECTORIES-no-arg)
 run_cmake(GLOB-noexp-LIST_DIRECTORIES)
+run_cmake(GLOB_RECURSE-snapshot)
+run_cmake_command(GLOB-CONFIGURE_DEPENDS-script-mode
+  ${CMAKE_COMMAND} -P ${RunCMake_SOURCE_DIR}/GLOB-CONFIGURE_DEPENDS-script-mode.cmake)
+
+function(run_GLOB_CONFIGURE_DEPENDS)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/GLOB-CONFIGURE_DEPENDS-build)
+  run_cmake(GLOB-CONFIGURE_DEPENDS)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(GLOB-CONFIGURE_DEPENDS-unchanged
+    ${CMAKE_COMMAND} -P CMakeFiles/VerifyGlobs.cmake)
+  if(RunCMake_GENERATOR MATCHES "Make|Ninja")
+    file(WRITE ${RunCMake_TEST_BINARY_DIR}/src/b.c "")
+    run_cmake_command(GLOB-CONFIGURE_DEPENDS-rebuild
+      ${CMAKE_COMMAND} --build .)
+  endif()
+endfunction()
+run_GLOB_CONFIGURE_DEPENDS()
 
 if(NOT WIN32 OR CYGWIN)
   run_cmake(GLOB_RECURSE-cyclic-recursion)
   run_cmake(INSTALL-SYMLINK)
 endif()
+if(EXISTS /dev/zero)
+  run_cmake(READ-device)
+endif()
+run_cmake(COPY-Parallel)
@@ -0,0 +1,22 @@
+set(dir "${CMAKE_CURRENT_BINARY_DIR}/Created")
+file(REMOVE_RECURSE "${dir}")
+function(write_header file)
+  file(WRITE "${file}" "")
+endfunction()
+foreach(name a b c d e)
+  find_file(Created_${name} NAMES Created_${name}.h PATHS "${dir}" NO_DEFAULT_PATH)
+  message(STATUS "Created_${name}='${Created_${name}}'")
+  unset(Created_${name} CACHE)
+  set(file "${dir}/Created_${name}.h")
+  if(name STREQUAL "c")
+    configure_file("${CMAKE_CURRENT_LIST_FILE}" "${file}" COPYONLY)
+  elseif(name STREQUAL "d")
+    execute_process(COMMAND ${CMAKE_COMMAND} -E touch "${file}")
+  elseif(name STREQUAL "e")
+    write_header("${file}")
+  else()
+    file(WRITE "${file}" "")
+  endif()
+  find_file(Created_${name} NAMES Created_${name}.h PATHS "${dir}" NO_DEFAULT_PATH)
+  message(STATUS "Created_${name}='${Created_${name}}'")
+endforeach()
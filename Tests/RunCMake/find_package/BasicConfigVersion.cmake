@@ -0,0 +1,25 @@
+include(CMakePackageConfigHelpers)
+
+function(test_version compat version sizeof)
+  set(dir "${CMAKE_CURRENT_BINARY_DIR}/${compat}")
+  set(CMAKE_SIZEOF_VOID_P "${sizeof}")
+  file(WRITE "${dir}/${compat}Config.cmake" "")
+  write_basic_package_version_file("${dir}/${compat}ConfigVersion.cmake"
+    VERSION ${version} COMPATIBILITY ${compat})
+  set(CMAKE_SIZEOF_VOID_P 8)
+  foreach(request ${ARGN})
+    string(REPLACE "_" " " request "${request}")
+    separate_arguments(request)
+    unset(${compat}_DIR CACHE)
+    find_package(${compat} ${request} CONFIG QUIET
+      PATHS "${dir}" NO_DEFAULT_PATH)
+    message("${compat} ${version} [${request}]: found='${${compat}_FOUND}'"
+      " version='${${compat}_CONSIDERED_VERSIONS}'")
+  endforeach()
+endfunction()
+
+test_version(AnyNewerVersion 1.2.3 8 1 1.2.3_EXACT 1.3)
+test_version(SameMajorVersion 1.2.3 8 1 1.3 2 1.2.3_EXACT)
+test_version(SameMinorVersion 1.2.3 8 1.2 1.1 1.3)
+test_version(ExactVersion 1.2.3.4 8 1.2.3 1.2.3.5 1.2 1.2.3.4_EXACT)
+test_version(SameMajorVersion 1.2.3 4 1)
@@ -0,0 +1,5 @@
+file(GLOB files "${CMAKE_FIND_PACKAGE_INDEX_DIR}/*")
+list(LENGTH files count)
+message(STATUS "Index files: ${count}")
+set(CMAKE_FIND_PACKAGE_INDEX_REUSE 1)
+include(${CMAKE_CURRENT_LIST_DIR}/Index.cmake)
@@ -0,0 +1,17 @@
+if(NOT CMAKE_FIND_PACKAGE_INDEX_REUSE)
+  file(REMOVE_RECURSE "${CMAKE_FIND_PACKAGE_INDEX_DIR}")
+endif()
+
+find_package(VersionedA 2 CONFIG NO_DEFAULT_PATH
+  PATHS "${CMAKE_CURRENT_SOURCE_DIR}")
+string(REPLACE "${CMAKE_CURRENT_SOURCE_DIR}" "<src>" dir "${VersionedA_DIR}")
+message(STATUS "VersionedA_DIR='${dir}'")
+
+set(prefix "${CMAKE_CURRENT_BINARY_DIR}/prefix")
+file(REMOVE_RECURSE "${prefix}")
+file(MAKE_DIRECTORY "${prefix}/lib/cmake")
+find_package(Created CONFIG QUIET NO_DEFAULT_PATH PATHS "${prefix}")
+message(STATUS "Created_FOUND='${Created_FOUND}'")
+file(WRITE "${prefix}/lib/cmake/Created-1.0/CreatedConfig.cmake" "")
+find_package(Created CONFIG QUIET NO_DEFAULT_PATH PATHS "${prefix}")
+message(STATUS "Created_FOUND='${Created_FOUND}'")
@@ -1,5 +1,6 @@
 include(RunCMake)
 
+run_cmake(BasicConfigVersion)
 run_cmake(ComponentRequiredAndOptional)
 run_cmake(MissingNormal)
 run_cmake(MissingNormalRequired)
@@ -13,6 +14,13 @@ run_cmake(MissingConfigOneName)
 run_cmake(MissingConfigRequired)
 run_cmake(MissingConfigVersion)
 run_cmake(MixedModeOptions)
+
+set(RunCMake_TEST_OPTIONS
+  -DCMAKE_FIND_PACKAGE_INDEX_DIR=${RunCMake_BINARY_DIR}/FindPackageIndex)
+run_cmake(Index)
+run_cmake(Index-Reuse)
+unset(RunCMake_TEST_OPTIONS)
+
 run_cmake(PackageRoot)
 run_cmake(PackageRootNestedConfig)
 run_cmake(PackageRootNestedModule)
@@ -0,0 +1,78 @@
+file(REMOVE_RECURSE ${RunCMake_TEST_BINARY_DIR}/prefix)
+set(install_state_dir ${RunCMake_TEST_BINARY_DIR}/CMakeFiles/InstallState)
+
+function(run_install expect)
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -P ${RunCMake_TEST_BINARY_DIR}/cmake_install.cmake
+    OUTPUT_VARIABLE out ERROR_VARIABLE err)
+  if(NOT out MATCHES "${expect}")
+    string(REGEX REPLACE "\n" "\n  " out "  ${out}")
+    string(APPEND RunCMake_TEST_FAILED
+      "Install output did not match\n  ${expect}\nActual output:\n${out}\n")
+  endif()
+  file(READ ${RunCMake_TEST_BINARY_DIR}/install_manifest.txt manifest)
+  if(NOT manifest MATCHES "/prefix/share/a.txt\n" OR
+     NOT manifest MATCHES "/prefix/share/dir/b.txt")
+    string(APPEND RunCMake_TEST_FAILED
+      "Install manifest is not complete:\n${manifest}\n")
+  endif()
+  set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}" PARENT_SCOPE)
+endfunction()
+
+function(check_marker expect)
+  file(GLOB states ${install_state_dir}/*.txt)
+  list(LENGTH states n)
+  if(NOT n EQUAL 1)
+    string(APPEND RunCMake_TEST_FAILED
+      "Expected one install state, found:\n  ${states}\n")
+  else()
+    file(STRINGS ${states} marker REGEX "^V MARKER ")
+    if(NOT "${marker}" STREQUAL "${expect}")
+      string(APPEND RunCMake_TEST_FAILED
+        "Install state has marker '${marker}', not '${expect}'.\n")
+    endif()
+    # Add a marker that survives only while the state is not recorded again.
+    file(APPEND ${states} "V MARKER 1\n")
+  endif()
+  set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}" PARENT_SCOPE)
+endfunction()
+
+run_install("
+-- Installing: [^\n]*/prefix/share/a.txt\r?
+-- Installing: [^\n]*/prefix/share/dir\r?
+-- Installing: [^\n]*/prefix/share/dir/b.txt\r?
+")
+check_marker("")
+
+# Nothing changed, so the recorded state is used.
+run_install("
+-- Up-to-date: [^\n]*/prefix/share/a.txt\r?
+-- Up-to-date: [^\n]*/prefix/share/dir\r?
+-- Up-to-date: [^\n]*/prefix/share/dir/b.txt\r?
+")
+check_marker("V MARKER 1")
+
+# A changed source runs the install rules again.
+file(WRITE ${RunCMake_TEST_BINARY_DIR}/src/a.txt "changed")
+run_install("
+-- Installing: [^\n]*/prefix/share/a.txt\r?
+-- Up-to-date: [^\n]*/prefix/share/dir\r?
+-- Up-to-date: [^\n]*/prefix/share/dir/b.txt\r?
+")
+check_marker("")
+
+# So does a removed installed file.
+file(REMOVE ${RunCMake_TEST_BINARY_DIR}/prefix/share/dir/b.txt)
+run_install("
+-- Up-to-date: [^\n]*/prefix/share/a.txt\r?
+-- Up-to-date: [^\n]*/prefix/share/dir\r?
+-- Installing: [^\n]*/prefix/share/dir/b.txt\r?
+")
+check_marker("")
+
+# Files added to an installed directory are found.
+file(WRITE ${RunCMake_TEST_BINARY_DIR}/src/dir/c.txt "c")
+run_install("
+-- Installing: [^\n]*/prefix/share/dir/c.txt\r?
+")
+check_marker("")
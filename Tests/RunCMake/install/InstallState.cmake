@@ -0,0 +1,5 @@
+set(CMAKE_INSTALL_PREFIX "${CMAKE_BINARY_DIR}/prefix")
+file(WRITE ${CMAKE_BINARY_DIR}/src/a.txt "a")
+file(WRITE ${CMAKE_BINARY_DIR}/src/dir/b.txt "b")
+install(FILES ${CMAKE_BINARY_DIR}/src/a.txt DESTINATION share)
+install(DIRECTORY ${CMAKE_BINARY_DIR}/src/dir DESTINATION share)
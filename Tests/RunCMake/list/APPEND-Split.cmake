@@ -0,0 +1,67 @@
+cmake_policy(SET CMP0007 NEW)
+
+# Compare the elements of a list built by list(APPEND) with those of a
+# copy of its value.
+function(check_list name)
+  set(copy "${${name}}")
+  list(LENGTH ${name} length)
+  list(LENGTH copy expect_length)
+  set(items "")
+  foreach(item IN LISTS ${name})
+    string(APPEND items "<${item}>")
+  endforeach()
+  set(expect "")
+  foreach(item IN LISTS copy)
+    string(APPEND expect "<${item}>")
+  endforeach()
+  if(NOT length EQUAL expect_length OR NOT items STREQUAL expect)
+    message(SEND_ERROR "${name} has ${length} elements ${items}, "
+      "expected ${expect_length} elements ${expect}")
+  endif()
+endfunction()
+
+set(plain "")
+list(APPEND plain a b)
+list(LENGTH plain n)
+list(APPEND plain "" c)
+check_list(plain)
+
+set(brackets a)
+list(LENGTH brackets n)
+list(APPEND brackets "[b")
+list(APPEND brackets "c]" d)
+list(APPEND brackets "e]")
+list(APPEND brackets f)
+check_list(brackets)
+
+set(escape a)
+list(LENGTH escape n)
+list(APPEND escape "b\\")
+list(APPEND escape c)
+check_list(escape)
+
+set(empty "")
+list(LENGTH empty n)
+list(APPEND empty "")
+check_list(empty)
+list(APPEND empty a)
+check_list(empty)
+
+set(parent a b)
+list(LENGTH parent n)
+function(append_parent)
+  list(APPEND parent c)
+  check_list(parent)
+  set(parent "${parent}" PARENT_SCOPE)
+endfunction()
+append_parent()
+list(APPEND parent d)
+check_list(parent)
+list(GET parent 3 item)
+if(NOT item STREQUAL "d")
+  message(SEND_ERROR "parent element 3 is '${item}'")
+endif()
+
+set(cached a CACHE INTERNAL "")
+list(APPEND cached b)
+check_list(cached)
@@ -0,0 +1 @@
+include(CompilerInfoCache.cmake)
@@ -0,0 +1,11 @@
+enable_language(C)
+set(log "${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log")
+set(content "")
+if(EXISTS "${log}")
+  file(READ "${log}" content)
+endif()
+if(content MATCHES "Determining if the C compiler works passed")
+  message(STATUS "C compiler tested")
+else()
+  message(STATUS "C compiler reused")
+endif()
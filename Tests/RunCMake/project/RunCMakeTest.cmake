@@ -20,3 +20,10 @@ run_cmake(CMP0048-OLD)
 run_cmake(CMP0048-OLD-VERSION)
 run_cmake(CMP0048-WARN)
 run_cmake(CMP0048-NEW)
+
+set(RunCMake_TEST_OPTIONS
+  -DCMAKE_COMPILER_INFO_CACHE_DIR=${RunCMake_BINARY_DIR}/CompilerInfoCache)
+file(REMOVE_RECURSE "${RunCMake_BINARY_DIR}/CompilerInfoCache")
+run_cmake(CompilerInfoCache)
+run_cmake(CompilerInfoCache-Reuse)
+unset(RunCMake_TEST_OPTIONS)
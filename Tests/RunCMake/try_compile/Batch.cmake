@@ -0,0 +1,42 @@
+enable_language(C)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bad.c "#error bad\n")
+
+try_compile_batch(BEGIN)
+if(NOT CMAKE_TRY_COMPILE_BATCH)
+  message(FATAL_ERROR "CMAKE_TRY_COMPILE_BATCH not set by BEGIN")
+endif()
+try_compile(good_result ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  CMAKE_FLAGS -DCOMPILE_DEFINITIONS:STRING=-DBATCH_GOOD
+  OUTPUT_VARIABLE good_out)
+try_compile(bad_result ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_BINARY_DIR}/bad.c
+  OUTPUT_VARIABLE bad_out)
+try_compile(copy_result ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy)
+foreach(var good_result good_out bad_result bad_out)
+  if(DEFINED ${var})
+    message(FATAL_ERROR "${var} set before try_compile_batch(END)")
+  endif()
+endforeach()
+if(NOT copy_result)
+  message(FATAL_ERROR "try_compile with COPY_FILE was not run right away")
+endif()
+try_compile_batch(END)
+
+if(DEFINED CMAKE_TRY_COMPILE_BATCH)
+  message(FATAL_ERROR "CMAKE_TRY_COMPILE_BATCH still set after END")
+endif()
+if(NOT good_result)
+  message(FATAL_ERROR "try_compile failed:\n${good_out}")
+endif()
+if(NOT good_out MATCHES "-DBATCH_GOOD")
+  message(FATAL_ERROR "CMAKE_FLAGS not honored:\n${good_out}")
+endif()
+if(bad_result)
+  message(FATAL_ERROR "try_compile passed:\n${bad_out}")
+endif()
+if(NOT bad_out MATCHES "bad")
+  message(FATAL_ERROR "try_compile output missing error:\n${bad_out}")
+endif()
@@ -0,0 +1,64 @@
+enable_language(C)
+set(CMAKE_TRY_COMPILE_DIRECT ON)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/inc.c
+  "#include <direct.h>\nint main(void) { return DIRECT_HEADER - 1; }\n")
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/undef.c
+  "extern int undefined_function(void);\n"
+  "int main(void) { return undefined_function(); }\n")
+
+if(CMAKE_GENERATOR MATCHES "Make|Ninja" AND NOT CMAKE_HOST_WIN32)
+  set(direct 1)
+else()
+  set(direct 0)
+endif()
+
+macro(check_direct var expect_direct)
+  if(${expect_direct} AND direct)
+    if(${var}_out MATCHES "Run Build Command")
+      message(SEND_ERROR "${var} built the test project:\n${${var}_out}")
+    endif()
+  elseif(NOT ${var}_out MATCHES "Run Build Command")
+    message(SEND_ERROR "${var} did not build the test project:\n${${var}_out}")
+  endif()
+endmacro()
+
+# Without CMP0056 the test project uses its own link flags.
+try_compile(old_policy ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE old_policy_out)
+check_direct(old_policy 0)
+cmake_policy(SET CMP0056 NEW)
+
+try_compile(good ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_BINARY_DIR}/inc.c
+  COMPILE_DEFINITIONS -DUNUSED=1
+  CMAKE_FLAGS -DINCLUDE_DIRECTORIES=${CMAKE_CURRENT_SOURCE_DIR}/Direct
+  OUTPUT_VARIABLE good_out)
+check_direct(good 1)
+if(NOT good)
+  message(SEND_ERROR "try_compile failed:\n${good_out}")
+endif()
+
+try_compile(pp_error ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COMPILE_DEFINITIONS -DPP_ERROR
+  OUTPUT_VARIABLE pp_error_out)
+check_direct(pp_error 1)
+if(pp_error OR NOT pp_error_out MATCHES "PP_ERROR is defined")
+  message(SEND_ERROR "try_compile did not fail on #error:\n${pp_error_out}")
+endif()
+
+try_compile(undef ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_BINARY_DIR}/undef.c
+  OUTPUT_VARIABLE undef_out)
+check_direct(undef 1)
+if(undef)
+  message(SEND_ERROR "try_compile did not fail to link:\n${undef_out}")
+endif()
+
+# Language standards need the test project.
+try_compile(standard ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  C_STANDARD 99
+  OUTPUT_VARIABLE standard_out)
+check_direct(standard 0)
@@ -0,0 +1 @@
+#define DIRECT_HEADER 1
@@ -0,0 +1,44 @@
+enable_language(C)
+set(CMAKE_TRY_COMPILE_CACHE_DIR ${CMAKE_CURRENT_BINARY_DIR}/cache)
+file(REMOVE_RECURSE ${CMAKE_TRY_COMPILE_CACHE_DIR})
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/bad.c "#error bad\n")
+
+foreach(pass first second)
+  try_compile(good_${pass} ${CMAKE_CURRENT_BINARY_DIR}
+    ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+    OUTPUT_VARIABLE good_${pass}_out)
+  try_compile(bad_${pass} ${CMAKE_CURRENT_BINARY_DIR}
+    ${CMAKE_CURRENT_BINARY_DIR}/bad.c
+    OUTPUT_VARIABLE bad_${pass}_out)
+  try_compile(copy_${pass} ${CMAKE_CURRENT_BINARY_DIR}
+    ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+    COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy_${pass}
+    OUTPUT_VARIABLE copy_${pass}_out)
+endforeach()
+try_compile(defs_result ${CMAKE_CURRENT_BINARY_DIR}
+  ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  COMPILE_DEFINITIONS -DRESULT_CACHE
+  OUTPUT_VARIABLE defs_out)
+
+foreach(var good_first bad_first copy_first copy_second defs)
+  if(${var}_out MATCHES "try_compile cache")
+    message(FATAL_ERROR "${var} loaded from the cache:\n${${var}_out}")
+  endif()
+endforeach()
+foreach(var good_second bad_second)
+  if(NOT ${var}_out MATCHES "try_compile cache")
+    message(FATAL_ERROR "${var} not loaded from the cache:\n${${var}_out}")
+  endif()
+endforeach()
+if(NOT good_first OR NOT good_second)
+  message(FATAL_ERROR "try_compile failed:\n${good_second_out}")
+endif()
+if(bad_first OR bad_second)
+  message(FATAL_ERROR "try_compile passed:\n${bad_second_out}")
+endif()
+if(NOT bad_second_out MATCHES "bad")
+  message(FATAL_ERROR "cached output missing error:\n${bad_second_out}")
+endif()
+if(NOT EXISTS ${CMAKE_CURRENT_BINARY_DIR}/copy_second)
+  message(FATAL_ERROR "try_compile with COPY_FILE did not copy")
+endif()
@@ -16,6 +16,13 @@ run_cmake(BadSources2)
 run_cmake(NonSourceCopyFile)
 run_cmake(NonSourceCompileDefinitions)
 
+run_cmake(Batch)
+run_cmake(BatchBadArgs)
+run_cmake(BatchNoBegin)
+run_cmake(BatchNoEnd)
+run_cmake(ResultCache)
+run_cmake(Direct)
+
 set(RunCMake_TEST_OPTIONS --debug-trycompile)
 run_cmake(PlatformVariables)
 run_cmake(WarnDeprecated)
@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+
+set -e
+set -x
+shopt -s dotglob
+
+readonly name="zstd"
+readonly ownership="zstd upstream <zstd@fb.com>"
+readonly subtree="Utilities/cmzstd"
+readonly repo="https://github.com/facebook/zstd.git"
+readonly tag="v1.5.7"
+readonly shortlog=false
+readonly paths="
+  COPYING
+  LICENSE
+  lib/common/
+  lib/compress/
+  lib/decompress/
+  lib/zstd.h
+  lib/zstd_errors.h
+"
+
+extract_source () {
+    git_archive
+    pushd "${extractdir}/${name}-reduced"
+    rm lib/decompress/huf_decompress_amd64.S
+    echo "* -whitespace" > .gitattributes
+    popd
+}
+
+. "${BASH_SOURCE%/*}/update-third-party.bash"